@@ -1,14 +1,127 @@
+import json
+import os
+import socket
 import time
 
-from arduino.app_utils import App
+from arduino.app_utils import App, Bridge
 
-print("Hello world!")
+try:
+    import paho.mqtt.client as mqtt
+    from paho.mqtt.enums import CallbackAPIVersion
+    MQTT_AVAILABLE = True
+except ImportError:
+    MQTT_AVAILABLE = False
+
+# The sketch can't write the MCU's flash, so calibration lives here: the
+# sketch sends each CAL/XCAL result as a cal_save notify (a 16-byte
+# CalRecord, CRC-checked by the sketch) and gets it back through
+# cal_restore(record, age_s) when the app starts. The session config
+# (FAST, AUTO, BOOT, ...: a 6-byte ConfigRecord) and the STATS wear
+# counters (a 120-byte StatsRecord, sent every 10 minutes at most) are
+# kept the same way: config_save / config_restore(record) and
+# stats_save / stats_restore(record).
+CAL_FILE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "calibration.json")
+CONFIG_FILE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "config.json")
+STATS_FILE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "stats.json")
+RESTORE_RETRY_S = 2
+
+# Sketch events (tester_event notify: INSERTED/REMOVED, AUTO results,
+# FLEX:DROP, DRIFT, ERROR:SELF_TEST_FAILED) are republished as they arrive
+# on the local broker, the one the scanner daemon uses, as
+# {"event", "host", "timestamp"} JSON.
+MQTT_BROKER = os.environ.get("MQTT_BROKER", "localhost")
+MQTT_PORT = int(os.environ.get("MQTT_PORT", "1883"))
+MQTT_EVENT_TOPIC = "tester/event"
+
+# Restores still to push: (sketch function, file, pass the age)
+pending_restores = [
+    ("cal_restore", CAL_FILE, True),
+    ("config_restore", CONFIG_FILE, False),
+    ("stats_restore", STATS_FILE, False),
+]
+mqtt_client = None
+hostname = socket.gethostname()
+
+
+def load_record(path):
+    """Saved record and its age in seconds, or (None, 0)."""
+    try:
+        with open(path) as f:
+            saved = json.load(f)
+        return bytes.fromhex(saved["record"]), max(0, int(time.time() - saved["saved_at"]))
+    except (OSError, ValueError, KeyError):
+        return None, 0
+
+
+def save_record(path, record):
+    """Keep the latest record; write-then-rename so a power cut can't tear it."""
+    tmp = path + ".tmp"
+    with open(tmp, "w") as f:
+        json.dump({"record": bytes(record).hex(), "saved_at": time.time()}, f)
+        f.flush()
+        os.fsync(f.fileno())
+    os.replace(tmp, path)
+
+
+def cal_save(record):
+    save_record(CAL_FILE, record)
+
+
+def config_save(record):
+    save_record(CONFIG_FILE, record)
+
+
+def stats_save(record):
+    save_record(STATS_FILE, record)
+
+
+def connect_mqtt():
+    """Background MQTT client; it reconnects on its own once started."""
+    global mqtt_client
+    if not MQTT_AVAILABLE:
+        print("paho-mqtt not installed; tester events are not republished")
+        return
+    client = mqtt.Client(callback_api_version=CallbackAPIVersion.VERSION2,
+                         client_id=f"cable-tester-{hostname}")
+    try:
+        client.connect_async(MQTT_BROKER, MQTT_PORT, keepalive=60)
+        client.loop_start()
+        mqtt_client = client
+    except Exception as e:
+        print(f"mqtt: {e}; tester events are not republished")
+
+
+def tester_event(event):
+    """One sketch event, forwarded as it happens (nothing polls for it)."""
+    if mqtt_client is None:
+        return
+    payload = json.dumps({"event": event, "host": hostname, "timestamp": time.time()})
+    mqtt_client.publish(MQTT_EVENT_TOPIC, payload, qos=1)
+
+
+connect_mqtt()
+Bridge.provide("cal_save", cal_save)
+Bridge.provide("config_save", config_save)
+Bridge.provide("stats_save", stats_save)
+Bridge.provide("tester_event", tester_event)
 
 
 def loop():
-    """This function is called repeatedly by the App framework."""
-    # You can replace this with any code you want your App to run repeatedly.
-    time.sleep(10)
+    """Push the stored calibration, config and counters once the sketch is up."""
+    for restore in list(pending_restores):
+        name, path, with_age = restore
+        record, age = load_record(path)
+        if record is not None:
+            try:
+                if with_age:
+                    Bridge.call(name, record, age)
+                else:
+                    Bridge.call(name, record)
+            except Exception as e:
+                print(f"{name}: {e}; retrying")
+                continue
+        pending_restores.remove(restore)
+    time.sleep(RESTORE_RETRY_S)
 
 
 # See: https://docs.arduino.cc/software/app-lab/tutorials/getting-started/#app-run
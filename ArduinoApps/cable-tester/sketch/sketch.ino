@@ -21,9 +21,96 @@
  *   CAL      - Calibrate TS resistance (use short cable)
  *   XSHELL   - Run XLR shell bond test, returns XSHELL:...
  *   XCAL     - Calibrate XLR resistance (use short cable)
+ *   CALINFO  - Active calibration, its age and storage, returns CALINFO:...
+ *   FULL     - TS continuity + resistance in one pass, returns FULL:...
+ *   XFULL    - XLR continuity + resistance in one pass, returns XFULL:...
+ *              (XFULL SHELL also runs the shell bond test)
+ *   BOTH     - TS + XLR continuity in one scan, returns BOTH:...|RESULT:...|XCONT:...
  *   STATUS   - Get tester status, returns STATUS:...
  *   ID       - Get tester ID, returns ID:...
- *   RESET    - Reset circuit, returns OK:RESET
+ *   RESET    - Reset circuit (cancels a running test), returns OK:RESET
+ *   CANCEL   - Abort the running test, returns OK:CANCEL
+ *   SETTLE   - Settle mode, returns SETTLE:ADAPTIVE|FIXED
+ *              (SETTLE FIXED / SETTLE ADAPTIVE to change)
+ *   FAST     - Fail-fast mode, returns FAST:ON|OFF
+ *              (FAST ON / FAST OFF to change; "<test> FAST" for one test)
+ *   BURST    - Burst resistance captures, returns BURST:ON|OFF
+ *              (BURST ON / BURST OFF to change)
+ *   RESSTAT  - Sample statistics in RES/XRES results, returns RESSTAT:ON|OFF
+ *              (RESSTAT ON / RESSTAT OFF to change)
+ *   OVERSAMPLE - Extra bits per resistance reading, returns OVERSAMPLE:OFF|<bits>
+ *              (OVERSAMPLE 1..4 / OVERSAMPLE OFF to change)
+ *   BOOT     - Power-on display check, returns BOOT:FULL|FAST
+ *              (BOOT FAST skips the icon cycle, BOOT FULL restores it)
+ *   STATS    - Wear counters, returns STATS:SAVED:...:K12:<n>...:<test>:<pass>:<fail>
+ *              (STATS SAVE stores them now, STATS RESET zeroes them)
+ *   FLEX     - Flex test, returns FLEX:OFF|TS|XLR[:MS:...] (see FLEX below)
+ *              (FLEX TS / FLEX XLR to start, FLEX OFF to stop)
+ *   MEM      - Sketch thread stack headroom, returns MEM:FREE:...
+ *   PROFILE  - Per-command test timing, returns PROFILE:...
+ *              (PROFILE <cmd> breaks one down by phase, PROFILE RESET clears)
+ *   AUTO     - Auto-test mode, returns AUTO:OFF|<test>
+ *              (AUTO <test> arms it, AUTO OFF stops, AUTO RESULT collects;
+ *              see AUTO below)
+ *   #<tag> <cmd>;<cmd>...
+ *            - Tagged batch, see BATCHES below
+ *
+ * EVENTS: every event goes to the MPU as a tester_event(text) notify as it
+ * happens, so python/main.py can republish it (MQTT tester/event) without
+ * polling: INSERTED / REMOVED, AUTO results, FLEX:DROP:...,
+ * DRIFT:<path>:<mohm> (a baseline moved past CAL_DRIFT_WARN_MOHM) and
+ * ERROR:SELF_TEST_FAILED[:<line>] at boot.
+ *
+ * CAL/XCAL results are kept on the MPU: the sketch can't write the MCU's
+ * flash, so each save goes out as a cal_save notify (a CRC-checked
+ * CalRecord, see CableTester.h) and python/main.py stores it. When the app
+ * starts, main.py pushes it back with cal_restore(record, age_s), so a
+ * power cycle doesn't need a new CAL. The session config (FAST, BURST,
+ * RESSTAT, OVERSAMPLE, SETTLE, AUTO, BOOT; a ConfigRecord) goes the same
+ * way: config_save notify, config_restore(record), and so do the wear
+ * counters (STATS; a StatsRecord, sent at most every 10 minutes):
+ * stats_save notify, stats_restore(record), which adds the stored counts
+ * to those since boot.
+ *
+ * BOOT: begin() checks the fixture's lines electrically (about a ms, see
+ * CIRCUIT CHECK in CableTester.cpp); a stuck or shorted line leaves the
+ * tester NOT_READY, with STATUS:NOT_READY:FAULT:<line>. The icon cycle
+ * then plays from loop(), so the Bridge is up at once; BOOT FAST skips it.
+ *
+ * RESULT/XCONT/XSHELL/RES/XRES responses end with :SETTLE:<us>,... — the
+ * measured settle time of each drive step, in test order.
+ *
+ * run_command_bin(cmd) takes the same commands but answers test commands
+ * with a packed binary result record (see BINARY RESULTS).
+ *
+ * Tests run as non-blocking step programs from loop(); run_command()
+ * hands each command to loop() and returns once its response is ready.
+ * The test engine (step programs, scheduler, batches, AUTO, result
+ * formatting) is the shared CableTester library in arduino/libraries, the
+ * same code the Mega runs; this sketch is the UNO Q shell around it: the
+ * Bridge handoff, the LED matrix and the UNO Q-only commands.
+ *
+ * BATCHES: "#17 CONT;RES" runs each command as if sent on its own, in
+ * order (tests queue as usual), and returns every response at once, one
+ * per line, each prefixed "#17:", with "#17:END" last. The Bridge can't
+ * push, so the caller waits in a thread; results are always text. Tags are
+ * 1-65534; a malformed batch answers ERROR:BAD_BATCH.
+ *
+ * AUTO: with AUTO <test> (any test but CAL/XCAL) the idle loop probes for a
+ * cable every AUTO_POLL_MS: a AUTO_PROBE_US pulse on the TS (tip + sleeve)
+ * or XLR (pins 1-3) drives, read back on the matching sense inputs. After
+ * AUTO_DEBOUNCE agreeing probes it runs the test and shows the result on
+ * the matrix; the cable has to be pulled before the next one. The result
+ * goes out as a tester_event (see EVENTS) and also waits for AUTO RESULT,
+ * which answers EVENT:<response> once (the latest unread result) or
+ * AUTO:NONE. TS tests keep K1+K2 in continuity mode between probes.
+ *
+ * FLEX: FLEX TS / FLEX XLR hold the TS (tip + sleeve) or XLR (pins 1-3)
+ * drives on while the cable is worked by hand, sampling the sense inputs
+ * every FLEX_SAMPLE_US in FLEX_CHUNK_US chunks from loop(). FLEX answers
+ * the running totals (drops per line, LONGEST, OPEN lines), FLEX OFF the
+ * final ones; AUTO RESULT returns the latest EVENT:FLEX:DROP:<line>:AT:<ms>:US:<us>.
+ * Tests and debug drives answer ERROR:BUSY until FLEX OFF or CANCEL.
  *
  * Relay Configuration (all via PN2222A drivers, coils on 5V rail):
  *   K1+K2 (D7)     - Tied together. TS test mode. LOW = short far end + res path, HIGH = continuity
@@ -57,43 +144,15 @@
 
 #include "Arduino_RouterBridge.h"
 #include <Arduino_LED_Matrix.h>
+#include <CableTester.h>
 
 // ===== PIN DEFINITIONS =====
-
-// --- TS Cable Testing ---
-#define TS_CONT_OUT_SLEEVE   2
-#define TS_CONT_OUT_TIP      3
-#define TS_CONT_IN_SLEEVE    4
-#define TS_CONT_IN_TIP       5
-
-// --- Resistance (shared TS/XLR via K3/K4 relay switching) ---
-#define RES_TEST_OUT         6
-#define RES_SENSE            A0
-
-// --- Relay Drives (all via PN2222A, GPIO -> 1k -> base) ---
-#define K1_K2_RELAY          7
-#define K3_RELAY             8
-#define K4_RELAY             9
-#define K5_RELAY            10
-#define K6_RELAY            11
-
-// --- XLR Cable Testing ---
-#define XLR_CONT_OUT_PIN1   12
-#define XLR_CONT_IN_PIN1    17   // A3
-#define XLR_CONT_OUT_PIN2   13
-#define XLR_CONT_IN_PIN2    18   // A4
-#define XLR_CONT_OUT_PIN3   15   // A1
-#define XLR_CONT_IN_PIN3    19   // A5
-#define XLR_CONT_OUT_SHELL  16   // A2
-#define XLR_CONT_IN_SHELL   20   // SDA
+// Fixture pins are in the library's board map (boards/UnoQ.h)
 
 // ===== LED MATRIX =====
 ArduinoLEDMatrix matrix;
 
-#define SHOW_OFF    0
-#define SHOW_PASS   1
-#define SHOW_FAIL   2
-#define SHOW_ERROR  3
+// SHOW_OFF/PASS/FAIL/ERROR come from CableTester.h
 #define SHOW_SCROLL 4
 
 // Static icon frames (8x13 = 104 bits, packed into 3x uint32_t + 8 leftover bits)
@@ -133,8 +192,7 @@ const uint8_t ICON_ERROR[] = {
 
 // ===== SCROLLING TEXT =====
 // 5x7 font, column-major (each byte = 1 column, 7 bits, LSB = top row)
-// Only chars needed: space, A, D, E, I, L, N, R, S, U, W, a, d, e, i, l, n, r, s, u, w
-// Full A-Z + a-z + 0-9 for flexibility
+// A-Z, a-z, 0-9 and '.', so readings can scroll too
 
 const uint8_t FONT_5x7[][5] = {
   // space (32)
@@ -193,58 +251,89 @@ const uint8_t FONT_5x7[][5] = {
   {0x44, 0x28, 0x10, 0x28, 0x44}, // x
   {0x0C, 0x50, 0x50, 0x50, 0x3C}, // y
   {0x44, 0x64, 0x54, 0x4C, 0x44}, // z
+  // 0-9 (48-57) - index 53-62
+  {0x3E, 0x51, 0x49, 0x45, 0x3E}, // 0
+  {0x00, 0x42, 0x7F, 0x40, 0x00}, // 1
+  {0x42, 0x61, 0x51, 0x49, 0x46}, // 2
+  {0x21, 0x41, 0x45, 0x4B, 0x31}, // 3
+  {0x18, 0x14, 0x12, 0x7F, 0x10}, // 4
+  {0x27, 0x45, 0x45, 0x45, 0x39}, // 5
+  {0x3C, 0x4A, 0x49, 0x49, 0x30}, // 6
+  {0x01, 0x71, 0x09, 0x05, 0x03}, // 7
+  {0x36, 0x49, 0x49, 0x49, 0x36}, // 8
+  {0x06, 0x49, 0x49, 0x29, 0x1E}, // 9
+  // . - index 63
+  {0x00, 0x60, 0x60, 0x00, 0x00},
 };
 
 // Get font index for a character (returns 0 for space/unknown)
 int fontIndex(char c) {
   if (c >= 'A' && c <= 'Z') return 1 + (c - 'A');
   if (c >= 'a' && c <= 'z') return 27 + (c - 'a');
+  if (c >= '0' && c <= '9') return 53 + (c - '0');
+  if (c == '.') return 63;
   return 0; // space
 }
 
 // Scroll state
-const char* scrollText = "Sundial Wire";
+#define SCROLL_TEXT "Sundial Wire"
+#define SCROLL_TEXT_MAX 24  // Characters setScrollText() keeps
 #define SCROLL_SPEED_MS 80
 #define CHAR_WIDTH 6        // 5 pixels + 1 space
+#define MATRIX_COLS 13
+// The banner as pixel columns (FONT_5x7 layout): MATRIX_COLS blank, the
+// text, MATRIX_COLS blank, so scroll offset n shows columns n..n+12.
+// Built once per text by setScrollText(); a tick only copies 13 columns.
+uint8_t scrollCols[SCROLL_TEXT_MAX * CHAR_WIDTH + 2 * MATRIX_COLS];
 int scrollOffset = 0;
 int scrollMaxOffset = 0;
+bool scrollShown = false;           // The matrix shows scrollShownCols (no icon since)
+uint8_t scrollShownCols[MATRIX_COLS];
 unsigned long lastScrollTime = 0;
 bool showingIcon = false;
 unsigned long iconStartTime = 0;
 #define ICON_DISPLAY_MS 3000  // Show icon for 3 seconds before resuming scroll
 
+// Power-on icon cycle (selfTest()), one icon per BOOT_ICON_MS from loop();
+// a test or a restored BOOT FAST ends it
+const uint8_t BOOT_ICONS[] = {SHOW_FAIL, SHOW_PASS, SHOW_ERROR, SHOW_OFF};
+#define BOOT_ICON_MS 300
+uint8_t bootIcon = sizeof(BOOT_ICONS);  // Next to show; sizeof = done
+unsigned long bootIconAt = 0;
+
 // Brightness gradient per column (symmetric fade on edges)
 // Cols 0,12 = 1, Cols 1,11 = 2, Cols 2,10 = 4, Cols 3-9 = 7
 const uint8_t COL_BRIGHTNESS[] = {1, 2, 4, 7, 7, 7, 7, 7, 7, 7, 4, 2, 1};
 
-// Render one frame of scrolling text into the display buffer
+// Lay out a new banner (loop() only; restarts the scroll). Text past
+// SCROLL_TEXT_MAX is dropped.
+void setScrollText(const char *text) {
+  memset(scrollCols, 0, sizeof(scrollCols));
+  int len = 0;
+  for (; text[len] != '\0' && len < SCROLL_TEXT_MAX; len++) {
+    memcpy(scrollCols + MATRIX_COLS + len * CHAR_WIDTH, FONT_5x7[fontIndex(text[len])], 5);
+  }
+  scrollMaxOffset = len * CHAR_WIDTH + MATRIX_COLS;  // full scroll through
+  scrollOffset = 0;
+}
+
+// Render one frame of scrolling text into the display buffer. Frames that
+// match the one on the matrix (the blank lead-in and tail) aren't redrawn.
 void renderScrollFrame(int offset) {
+  const uint8_t *cols = scrollCols + offset;
+  if (scrollShown && memcmp(scrollShownCols, cols, MATRIX_COLS) == 0) return;
+  memcpy(scrollShownCols, cols, MATRIX_COLS);
+  scrollShown = true;
+
   uint8_t frame[104];
   memset(frame, 0, sizeof(frame));
-
-  int textLen = strlen(scrollText);
-  // Total pixel width of the text
-  int textPixelWidth = textLen * CHAR_WIDTH;
-
-  for (int col = 0; col < 13; col++) {
-    int srcCol = col + offset - 13; // start with text scrolling in from right
-    if (srcCol < 0 || srcCol >= textPixelWidth) continue;
-
-    int charIdx = srcCol / CHAR_WIDTH;
-    int colInChar = srcCol % CHAR_WIDTH;
-    if (colInChar >= 5) continue; // inter-character gap
-
-    if (charIdx < 0 || charIdx >= textLen) continue;
-
-    int fi = fontIndex(scrollText[charIdx]);
-    uint8_t colBits = FONT_5x7[fi][colInChar];
-
+  for (int col = 0; col < MATRIX_COLS; col++) {
     // Map 7-bit column to rows, flipped vertically (row 0 padding at bottom)
     // Also mirror columns (12-col) so text reads correctly
     int dispCol = 12 - col;
     uint8_t brightness = COL_BRIGHTNESS[dispCol];
     for (int row = 0; row < 7; row++) {
-      if (colBits & (1 << row)) {
+      if (cols[col] & (1 << row)) {
         frame[(6 - row) * 13 + dispCol] = brightness;
       }
     }
@@ -255,144 +344,264 @@ void renderScrollFrame(int offset) {
 }
 
 // ===== CONFIGURATION =====
-const char* TESTER_ID = "UNOQ_TESTER_1";
-const int RELAY_SETTLE_MS = 10;
-const int SIGNAL_SETTLE_MS = 50;
-
-// Resistance test config (3.3V supply, 14-bit ADC)
-const int ADC_MAX = 16383;
-const int RES_PASS_THRESHOLD = 1966;        // ~120/1023 * 16383
-const float MAX_CABLE_RESISTANCE = 1.0;
-const float RES_SENSE_OHM = 20.0;
-const float SUPPLY_VOLTAGE = 3.3;
-const float VCE_SAT = 0.3;
-const int CAL_REJECT_THRESHOLD = 9830;      // ~600/1023 * 16383
-
-// Calibration state
-int calibrationADC = 0;
-bool isCalibrated = false;
-int xlrCalibrationADC_P2 = 0;
-int xlrCalibrationADC_P3 = 0;
-bool isXlrCalibrated = false;
-
-// ===== GLOBAL STATE =====
-bool systemReady = false;
-
-// ===== TEST RESULT STRUCTS =====
-struct TestResults {
-  bool tipToTip;
-  bool tipToSleeve;
-  bool sleeveToSleeve;
-  bool sleeveToTip;
-  bool overallPass;
-  bool reversed;
-  bool shorted;
-  bool openTip;
-  bool openSleeve;
+#define CMD_SIZE  64                 // Longest command (longer ones are truncated)
+
+// ===== AUTO MODE =====
+char autoResult[REPLY_SIZE];         // Latest unread "EVENT:<response>", "" = none
+
+// ===== RPC HANDOFF =====
+// run_command() runs in the Bridge thread; commands are executed by loop()
+// so a running test never races the display or another command.
+#define BATCH_REPLY_SIZE  1024       // A whole batch's responses (see BATCHES)
+
+char pendingCommand[CMD_SIZE];
+char pendingResponse[BATCH_REPLY_SIZE];
+volatile bool commandPending = false;
+volatile bool responseReady = false;
+bool awaitingResponse = false;       // loop() owes the Bridge thread a response
+
+// ===== BATCHES =====
+// Tagged replies collect in batchReply and are posted together after END
+char batchReply[BATCH_REPLY_SIZE];
+uint16_t batchReplyLen = 0;
+
+// ===== BINARY RESULTS =====
+// run_command_bin() answers test commands with a packed record (msgpack bin,
+// see CableTester.h) instead of the text response; everything else comes
+// back as text bytes.
+volatile bool pendingBinary = false;   // Current command came from run_command_bin
+uint8_t pendingRecord[BIN_MAX_RECORD];
+uint8_t pendingRecordLen = 0;
+
+// ===== STORED CALIBRATION =====
+// cal_restore() hands the record to loop() like a command
+uint8_t restoreRecord[sizeof(CalRecord)];
+uint8_t restoreRecordLen = 0;
+unsigned long restoreAge = 0;
+volatile bool restorePending = false;
+volatile bool restoreDone = false;
+bool restoreAccepted = false;
+// ...and config_restore() the session config
+uint8_t configRecord[sizeof(ConfigRecord)];
+uint8_t configRecordLen = 0;
+volatile bool configPending = false;
+volatile bool configDone = false;
+bool configAccepted = false;
+// ...and stats_restore() the wear counters
+uint8_t statsRecord[sizeof(StatsRecord)];
+uint8_t statsRecordLen = 0;
+volatile bool statsPending = false;
+volatile bool statsDone = false;
+bool statsAccepted = false;
+
+// ===== TESTER =====
+class UnoQTester : public CableTester {
+protected:
+  void sendReply(uint16_t tag) override;
+  void sendRecord(uint16_t tag, const uint8_t *record, uint8_t len) override;
+  void showResult(uint8_t result) override;
+  bool selfTest() override;
+  bool boardCommand(const char *cmd) override;
+  bool isReadOnlyCommand(const char *cmd) override;
+  void testStarted(uint8_t kind, uint16_t tag) override;
+  void sendBatchEnd(uint16_t tag) override;
+  void sendEvent() override;
+  // One copy, kept by the MPU; it's pushed back with cal_restore(), not read
+  uint8_t calSlots() override { return 1; }
+  bool writeCalSlot(uint8_t slot, const CalRecord &rec) override;
+  const char *calStorage() override { return "MPU"; }
+  bool writeConfig(const ConfigRecord &rec) override;
+  uint8_t statsSlots() override { return 1; }
+  bool writeStatsSlot(uint8_t slot, const StatsRecord &rec) override;
 };
 
-struct XlrContResults {
-  bool p[3][3];
-  bool overallPass;
-};
-
-struct XlrShellResults {
-  bool nearShellBond;
-  bool farShellBond;
-  bool shellToShell;
-  bool shellToP2;
-  bool shellToP3;
-  bool overallPass;
-};
+UnoQTester tester;
 
 // ===== FORWARD DECLARATIONS =====
-void showResult(int result = 0);
-void resetCircuit();
-String handleCommand(String cmd);
-String runContinuityTest();
-String runXlrContinuityTest();
-String runXlrShellTest();
-String runResistanceTest();
-String runXlrResistanceTest();
-String runCalibration();
-String runXlrCalibration();
+void postResponse(const char *resp);
+void pushEvent(const char *event);
+void displayResult(uint8_t result);
+void batchCollect(uint16_t tag);
+void formatSensors();
+void formatPinStates();
+void formatMem();
 
 // ===== BRIDGE COMMAND HANDLER =====
 // Single entry point for all commands from the MPU.
-// Accepts command string, returns response string.
+// Accepts command string, returns response string. The command is handed
+// to loop() and this call waits for its response (tests answer when their
+// step program completes). The returned String is the one allocation left:
+// it's the type the Bridge serializes.
 String run_command(String cmd) {
-  cmd.trim();
-  cmd.toUpperCase();
-  return handleCommand(cmd);
+  submitCommand(cmd.c_str(), false);
+  return String(pendingResponse);
+}
+
+// Same as run_command(), but test results come back as a binary record
+MsgPack::bin_t<uint8_t> run_command_bin(String cmd) {
+  submitCommand(cmd.c_str(), true);
+  MsgPack::bin_t<uint8_t> out;
+  if (pendingRecordLen > 0) {
+    out.assign(pendingRecord, pendingRecord + pendingRecordLen);
+  } else {
+    out.assign(pendingResponse, pendingResponse + strlen(pendingResponse));
+  }
+  return out;
+}
+
+// The calibration main.py saved; false if it's corrupt or this boot
+// already calibrated
+bool cal_restore(MsgPack::bin_t<uint8_t> record, uint32_t ageSeconds) {
+  restoreRecordLen = record.size() == sizeof(restoreRecord) ? sizeof(restoreRecord) : 0;
+  memcpy(restoreRecord, record.data(), restoreRecordLen);
+  restoreAge = ageSeconds;
+  restoreDone = false;
+  __sync_synchronize();
+  restorePending = true;
+
+  while (!restoreDone) {
+    delay(1);
+  }
+  __sync_synchronize();
+  return restoreAccepted;
+}
+
+// The session config main.py saved; false if it's corrupt or this boot
+// already saved one
+bool config_restore(MsgPack::bin_t<uint8_t> record) {
+  configRecordLen = record.size() == sizeof(configRecord) ? sizeof(configRecord) : 0;
+  memcpy(configRecord, record.data(), configRecordLen);
+  configDone = false;
+  __sync_synchronize();
+  configPending = true;
+
+  while (!configDone) {
+    delay(1);
+  }
+  __sync_synchronize();
+  return configAccepted;
+}
+
+// The wear counters main.py saved; false if they're corrupt or this boot
+// already saved some
+bool stats_restore(MsgPack::bin_t<uint8_t> record) {
+  statsRecordLen = record.size() == sizeof(statsRecord) ? sizeof(statsRecord) : 0;
+  memcpy(statsRecord, record.data(), statsRecordLen);
+  statsDone = false;
+  __sync_synchronize();
+  statsPending = true;
+
+  while (!statsDone) {
+    delay(1);
+  }
+  __sync_synchronize();
+  return statsAccepted;
+}
+
+// Hand a command to loop() and wait for its response
+void submitCommand(const char *cmd, bool binary) {
+  strncpy(pendingCommand, cmd, CMD_SIZE - 1);
+  pendingCommand[CMD_SIZE - 1] = '\0';
+  normalizeCommand(pendingCommand);
+
+  pendingBinary = binary;
+  pendingRecordLen = 0;
+  responseReady = false;
+  __sync_synchronize();
+  commandPending = true;
+
+  while (!responseReady) {
+    delay(1);
+  }
+  __sync_synchronize();
+}
+
+// Complete the waiting run_command() call (once per command)
+void postResponse(const char *resp) {
+  if (!awaitingResponse) return;
+  awaitingResponse = false;
+  tester.binaryResults = false;
+  strncpy(pendingResponse, resp, sizeof(pendingResponse) - 1);
+  pendingResponse[sizeof(pendingResponse) - 1] = '\0';
+  __sync_synchronize();
+  responseReady = true;
 }
 
 // ===== SETUP =====
 void setup() {
-  // Set ADC resolution to 14-bit
-  analogReadResolution(14);
-
-  // --- Relay outputs ---
-  pinMode(K1_K2_RELAY, OUTPUT);
-  pinMode(K3_RELAY, OUTPUT);
-  pinMode(K4_RELAY, OUTPUT);
-  pinMode(K5_RELAY, OUTPUT);
-  pinMode(K6_RELAY, OUTPUT);
-
-  // --- TS continuity ---
-  pinMode(TS_CONT_OUT_SLEEVE, OUTPUT);
-  pinMode(TS_CONT_OUT_TIP, OUTPUT);
-  pinMode(TS_CONT_IN_SLEEVE, INPUT);
-  pinMode(TS_CONT_IN_TIP, INPUT);
-
-  // --- Resistance ---
-  pinMode(RES_TEST_OUT, OUTPUT);
-
-  // --- XLR continuity ---
-  pinMode(XLR_CONT_OUT_PIN1, OUTPUT);
-  pinMode(XLR_CONT_OUT_PIN2, OUTPUT);
-  pinMode(XLR_CONT_OUT_PIN3, OUTPUT);
-  pinMode(XLR_CONT_OUT_SHELL, OUTPUT);
-  pinMode(XLR_CONT_IN_PIN1, INPUT);
-  pinMode(XLR_CONT_IN_PIN2, INPUT);
-  pinMode(XLR_CONT_IN_PIN3, INPUT);
-  pinMode(XLR_CONT_IN_SHELL, INPUT);
-
   // --- LED Matrix ---
   matrix.begin();
-  scrollMaxOffset = strlen(scrollText) * CHAR_WIDTH + 13; // full scroll through
-
-  // Initialize all outputs LOW
-  digitalWrite(K1_K2_RELAY, LOW);
-  digitalWrite(K3_RELAY, LOW);
-  digitalWrite(K4_RELAY, LOW);
-  digitalWrite(K5_RELAY, LOW);
-  digitalWrite(K6_RELAY, LOW);
-  digitalWrite(TS_CONT_OUT_SLEEVE, LOW);
-  digitalWrite(TS_CONT_OUT_TIP, LOW);
-  digitalWrite(RES_TEST_OUT, LOW);
-  digitalWrite(XLR_CONT_OUT_PIN1, LOW);
-  digitalWrite(XLR_CONT_OUT_PIN2, LOW);
-  digitalWrite(XLR_CONT_OUT_PIN3, LOW);
-  digitalWrite(XLR_CONT_OUT_SHELL, LOW);
+  setScrollText(SCROLL_TEXT);
 
-  showResult(SHOW_OFF);
-
-  // Self-test (LED cycle)
-  if (selfTest()) {
-    systemReady = true;
-  } else {
-    systemReady = false;
-    showResult(SHOW_ERROR);
+  // Fixture pins, idle circuit, circuit check (the icon cycle plays from loop())
+  if (!tester.begin()) {
+    displayResult(SHOW_ERROR);
   }
 
   // Register Bridge RPC handler
   Bridge.begin();
   Bridge.provide("run_command", run_command);
+  Bridge.provide("run_command_bin", run_command_bin);
+  Bridge.provide("cal_restore", cal_restore);
+  Bridge.provide("config_restore", config_restore);
+  Bridge.provide("stats_restore", stats_restore);
+
+  if (!tester.isReady()) {
+    char event[48];
+    snprintf(event, sizeof(event), "ERROR:SELF_TEST_FAILED%s%s",
+             tester.bootFault() ? ":" : "", tester.bootFault() ? tester.bootFault() : "");
+    pushEvent(event);
+  }
 }
 
 // ===== MAIN LOOP =====
 void loop() {
-  if (!systemReady) return;
+  // Stored calibration from main.py
+  if (restorePending) {
+    restorePending = false;
+    __sync_synchronize();
+    restoreAccepted = tester.restoreCalibration(restoreRecord, restoreRecordLen, restoreAge);
+    __sync_synchronize();
+    restoreDone = true;
+  }
+  if (configPending) {
+    configPending = false;
+    __sync_synchronize();
+    configAccepted = tester.restoreConfig(configRecord, configRecordLen);
+    __sync_synchronize();
+    configDone = true;
+  }
+  if (statsPending) {
+    statsPending = false;
+    __sync_synchronize();
+    statsAccepted = tester.restoreStats(statsRecord, statsRecordLen);
+    __sync_synchronize();
+    statsDone = true;
+  }
+
+  // Commands from the Bridge thread (answered even when not ready)
+  if (commandPending) {
+    commandPending = false;
+    __sync_synchronize();
+    awaitingResponse = true;
+    // Batch results are always text
+    tester.binaryResults = pendingBinary && pendingCommand[0] != '#';
+    tester.handleCommand(pendingCommand);
+  }
+
+  // AUTO probing, then advance the running test, if any
+  tester.poll();
+
+  if (!tester.isReady()) return;
+
+  if (bootIcon < sizeof(BOOT_ICONS) && !tester.isFastBoot()) {
+    if (millis() - bootIconAt >= BOOT_ICON_MS) {
+      displayResult(BOOT_ICONS[bootIcon++]);
+      showingIcon = false;
+      bootIconAt = millis();
+    }
+    return;
+  }
 
   // If showing a test result icon, wait before resuming scroll
   if (showingIcon) {
@@ -404,7 +613,9 @@ void loop() {
     return;
   }
 
-  // Scroll text
+  // Scroll text, never while a test or FLEX runs, so no display work
+  // lands between a test's steps or FLEX sample chunks
+  if (tester.isTestRunning() || tester.isFlexRunning()) return;
   if (millis() - lastScrollTime >= SCROLL_SPEED_MS) {
     renderScrollFrame(scrollOffset);
     scrollOffset++;
@@ -415,558 +626,128 @@ void loop() {
   }
 }
 
-// ===== COMMAND DISPATCHER =====
-String handleCommand(String cmd) {
-  if (cmd == "CONT") {
-    if (!systemReady) return "ERROR:NOT_READY";
-    return runContinuityTest();
-
-  } else if (cmd == "XCONT" || cmd == "XC") {
-    if (!systemReady) return "ERROR:NOT_READY";
-    return runXlrContinuityTest();
-
-  } else if (cmd == "XSHELL" || cmd == "XS") {
-    if (!systemReady) return "ERROR:NOT_READY";
-    return runXlrShellTest();
-
-  } else if (cmd == "RES") {
-    if (!systemReady) return "ERROR:NOT_READY";
-    return runResistanceTest();
-
-  } else if (cmd == "XRES" || cmd == "XR") {
-    if (!systemReady) return "ERROR:NOT_READY";
-    return runXlrResistanceTest();
-
-  } else if (cmd == "CAL") {
-    if (!systemReady) return "ERROR:NOT_READY";
-    return runCalibration();
-
-  } else if (cmd == "XCAL") {
-    if (!systemReady) return "ERROR:NOT_READY";
-    return runXlrCalibration();
-
-  } else if (cmd == "STATUS") {
-    return String("STATUS:") + (systemReady ? "READY" : "NOT_READY");
-
-  } else if (cmd == "ID") {
-    return String("ID:") + TESTER_ID;
-
-  } else if (cmd == "RESET") {
-    resetCircuit();
-    return "OK:RESET";
-
-  } else if (cmd == "READ") {
-    return readSensors();
-
-  } else if (cmd == "PINS") {
-    return readPinStates();
-
-  // --- Relay toggles ---
-  } else if (cmd == "K12") {
-    bool state = !digitalRead(K1_K2_RELAY);
-    digitalWrite(K1_K2_RELAY, state);
-    return String("DEBUG:K1+K2(D7):") + (state ? "HIGH" : "LOW");
-
-  } else if (cmd == "K3") {
-    bool state = !digitalRead(K3_RELAY);
-    digitalWrite(K3_RELAY, state);
-    return String("DEBUG:K3(D8):") + (state ? "HIGH" : "LOW");
-
-  } else if (cmd == "K4") {
-    bool state = !digitalRead(K4_RELAY);
-    digitalWrite(K4_RELAY, state);
-    return String("DEBUG:K4(D9):") + (state ? "HIGH" : "LOW");
-
-  } else if (cmd == "K5") {
-    bool state = !digitalRead(K5_RELAY);
-    digitalWrite(K5_RELAY, state);
-    return String("DEBUG:K5(D10):") + (state ? "HIGH" : "LOW");
-
-  } else if (cmd == "K6") {
-    bool state = !digitalRead(K6_RELAY);
-    digitalWrite(K6_RELAY, state);
-    return String("DEBUG:K6(D11):") + (state ? "HIGH" : "LOW");
-
-  // --- Signal toggles ---
-  } else if (cmd == "TSTIP") {
-    bool state = !digitalRead(TS_CONT_OUT_TIP);
-    digitalWrite(TS_CONT_OUT_TIP, state);
-    return String("DEBUG:TS_CONT_OUT_TIP(D3):") + (state ? "HIGH" : "LOW");
-
-  } else if (cmd == "TSSLV") {
-    bool state = !digitalRead(TS_CONT_OUT_SLEEVE);
-    digitalWrite(TS_CONT_OUT_SLEEVE, state);
-    return String("DEBUG:TS_CONT_OUT_SLEEVE(D2):") + (state ? "HIGH" : "LOW");
-
-  } else if (cmd == "TSRES") {
-    bool state = !digitalRead(RES_TEST_OUT);
-    digitalWrite(RES_TEST_OUT, state);
-    return String("DEBUG:RES_TEST_OUT(D6):") + (state ? "HIGH" : "LOW");
-
-  } else if (cmd == "XLR1") {
-    bool state = !digitalRead(XLR_CONT_OUT_PIN1);
-    digitalWrite(XLR_CONT_OUT_PIN1, state);
-    return String("DEBUG:XLR_CONT_OUT_PIN1(D12):") + (state ? "HIGH" : "LOW");
-
-  } else if (cmd == "XLR2") {
-    bool state = !digitalRead(XLR_CONT_OUT_PIN2);
-    digitalWrite(XLR_CONT_OUT_PIN2, state);
-    return String("DEBUG:XLR_CONT_OUT_PIN2(D13):") + (state ? "HIGH" : "LOW");
-
-  } else if (cmd == "XLR3") {
-    bool state = !digitalRead(XLR_CONT_OUT_PIN3);
-    digitalWrite(XLR_CONT_OUT_PIN3, state);
-    return String("DEBUG:XLR_CONT_OUT_PIN3(D15/A1):") + (state ? "HIGH" : "LOW");
-
-  } else if (cmd == "XLRS") {
-    bool state = !digitalRead(XLR_CONT_OUT_SHELL);
-    digitalWrite(XLR_CONT_OUT_SHELL, state);
-    return String("DEBUG:XLR_CONT_OUT_SHELL(D16/A2):") + (state ? "HIGH" : "LOW");
+// Fire-and-forget, like cal_save: loop() never waits on the MPU. With no
+// app listening the router drops it.
+void pushEvent(const char *event) {
+  Bridge.notify("tester_event", event);
+}
 
+// ===== TESTER HOOKS =====
+// Untagged replies answer the waiting call; batch replies collect until
+// END; AUTO results are pushed and also wait for AUTO RESULT
+void UnoQTester::sendReply(uint16_t tag) {
+  if (tag == TAG_AUTO) {
+    snprintf(autoResult, sizeof(autoResult), "EVENT:%s", replyBuf);
+    pushEvent(replyBuf);
+  } else if (tag) {
+    batchCollect(tag);
   } else {
-    return "ERROR:UNKNOWN_CMD:" + cmd;
+    postResponse(replyBuf);
   }
 }
 
-// ===== TS CONTINUITY TEST =====
-String runContinuityTest() {
-  TestResults r;
-
-  showResult(SHOW_OFF);
-
-  digitalWrite(K1_K2_RELAY, HIGH);
-  delay(RELAY_SETTLE_MS);
-
-  // Test TIP
-  digitalWrite(TS_CONT_OUT_TIP, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-  r.tipToTip = digitalRead(TS_CONT_IN_TIP) == HIGH;
-  r.tipToSleeve = digitalRead(TS_CONT_IN_SLEEVE) == HIGH;
-  digitalWrite(TS_CONT_OUT_TIP, LOW);
-  delay(RELAY_SETTLE_MS);
-
-  // Test SLEEVE
-  digitalWrite(TS_CONT_OUT_SLEEVE, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-  r.sleeveToSleeve = digitalRead(TS_CONT_IN_SLEEVE) == HIGH;
-  r.sleeveToTip = digitalRead(TS_CONT_IN_TIP) == HIGH;
-  digitalWrite(TS_CONT_OUT_SLEEVE, LOW);
-
-  // Evaluate
-  r.overallPass = r.tipToTip && !r.tipToSleeve && r.sleeveToSleeve && !r.sleeveToTip;
-  r.reversed = !r.tipToTip && r.tipToSleeve && !r.sleeveToSleeve && r.sleeveToTip;
-  r.shorted = r.tipToSleeve || r.sleeveToTip;
-  r.openTip = !r.tipToTip && !r.tipToSleeve;
-  r.openSleeve = !r.sleeveToSleeve && !r.sleeveToTip;
-
-  resetCircuit();
-
-  if (r.overallPass) showResult(SHOW_PASS);
-  else if (r.reversed || r.shorted) showResult(SHOW_ERROR);
-  else showResult(SHOW_FAIL);
-
-  // Build response
-  String resp = "RESULT:";
-  resp += r.overallPass ? "PASS" : "FAIL";
-  resp += ":TT:" + String(r.tipToTip ? 1 : 0);
-  resp += ":TS:" + String(r.tipToSleeve ? 1 : 0);
-  resp += ":SS:" + String(r.sleeveToSleeve ? 1 : 0);
-  resp += ":ST:" + String(r.sleeveToTip ? 1 : 0);
-
-  if (!r.overallPass) {
-    resp += ":REASON:";
-    if (r.reversed) resp += "REVERSED";
-    else if (r.shorted) resp += "SHORT";
-    else if (r.openTip && r.openSleeve) resp += "NO_CABLE";
-    else if (r.openTip) resp += "TIP_OPEN";
-    else if (r.openSleeve) resp += "SLEEVE_OPEN";
-    else resp += "UNKNOWN";
-  }
-
-  return resp;
+// INSERTED/REMOVED and DRIFT are pushed only; AUTO RESULT keeps the
+// unread test result
+void UnoQTester::sendEvent() {
+  pushEvent(replyBuf);
 }
 
-// ===== XLR CONTINUITY TEST =====
-String runXlrContinuityTest() {
-  XlrContResults r;
-
-  showResult(SHOW_OFF);
-  resetCircuit();
-  delay(RELAY_SETTLE_MS);
-
-  const int outPins[] = {XLR_CONT_OUT_PIN1, XLR_CONT_OUT_PIN2, XLR_CONT_OUT_PIN3};
-  const int inPins[]  = {XLR_CONT_IN_PIN1,  XLR_CONT_IN_PIN2,  XLR_CONT_IN_PIN3};
-
-  pinMode(XLR_CONT_OUT_SHELL, INPUT);
-
-  for (int d = 0; d < 3; d++) {
-    for (int i = 0; i < 3; i++) pinMode(outPins[i], INPUT);
-    pinMode(outPins[d], OUTPUT);
-    digitalWrite(outPins[d], HIGH);
-    delay(SIGNAL_SETTLE_MS);
-    for (int s = 0; s < 3; s++) {
-      r.p[d][s] = digitalRead(inPins[s]) == HIGH;
-    }
-    digitalWrite(outPins[d], LOW);
-    delay(RELAY_SETTLE_MS);
-  }
-
-  for (int i = 0; i < 3; i++) pinMode(outPins[i], OUTPUT);
-  pinMode(XLR_CONT_OUT_SHELL, OUTPUT);
-  resetCircuit();
-
-  // Evaluate
-  r.overallPass = true;
-  for (int d = 0; d < 3; d++) {
-    for (int s = 0; s < 3; s++) {
-      if (d == s && !r.p[d][s]) r.overallPass = false;
-      if (d != s && r.p[d][s])  r.overallPass = false;
-    }
-  }
-
-  if (r.overallPass) {
-    showResult(SHOW_PASS);
-  } else {
-    bool anyConnection = false;
-    for (int d = 0; d < 3; d++)
-      for (int s = 0; s < 3; s++)
-        if (r.p[d][s]) anyConnection = true;
-    showResult(anyConnection ? SHOW_ERROR : SHOW_FAIL);
-  }
-
-  // Build response
-  String resp = "XCONT:";
-  resp += r.overallPass ? "PASS" : "FAIL";
-  for (int d = 0; d < 3; d++)
-    for (int s = 0; s < 3; s++)
-      resp += ":P" + String(d + 1) + String(s + 1) + ":" + String(r.p[d][s] ? 1 : 0);
-
-  if (!r.overallPass) {
-    resp += ":REASON:";
-    bool allOpen = true;
-    for (int d = 0; d < 3; d++)
-      for (int s = 0; s < 3; s++)
-        if (r.p[d][s]) allOpen = false;
-    if (allOpen) {
-      resp += "NO_CABLE";
-    } else {
-      String issues = "";
-      for (int i = 0; i < 3; i++) {
-        if (!r.p[i][i]) {
-          if (issues.length() > 0) issues += ",";
-          issues += "P" + String(i + 1) + "_OPEN";
-        }
-      }
-      for (int d = 0; d < 3; d++) {
-        for (int s = 0; s < 3; s++) {
-          if (d != s && r.p[d][s]) {
-            if (issues.length() > 0) issues += ",";
-            issues += "P" + String(d + 1) + "_P" + String(s + 1) + "_SHORT";
-          }
-        }
-      }
-      resp += issues.length() > 0 ? issues : "UNKNOWN";
-    }
-  }
-
-  return resp;
+// run_command_bin(): the record is the response
+void UnoQTester::sendRecord(uint16_t tag, const uint8_t *record, uint8_t len) {
+  (void)tag;
+  memcpy(pendingRecord, record, len);
+  pendingRecordLen = len;
+  postResponse("");
 }
 
-// ===== XLR SHELL BOND TEST =====
-String runXlrShellTest() {
-  XlrShellResults r;
+// Post the whole batch
+void UnoQTester::sendBatchEnd(uint16_t tag) {
+  CableTester::sendBatchEnd(tag);
+  postResponse(batchReply);
+  batchReplyLen = 0;
+  batchReply[0] = '\0';
+}
 
+// Blank the matrix until the result icon; the scroll resumes after it
+void UnoQTester::testStarted(uint8_t kind, uint16_t tag) {
+  (void)kind;
+  (void)tag;
   showResult(SHOW_OFF);
-  resetCircuit();
-  delay(RELAY_SETTLE_MS);
-
-  const int outPins[] = {XLR_CONT_OUT_PIN1, XLR_CONT_OUT_PIN2, XLR_CONT_OUT_PIN3, XLR_CONT_OUT_SHELL};
-  const int inPins[]  = {XLR_CONT_IN_PIN1,  XLR_CONT_IN_PIN2,  XLR_CONT_IN_PIN3,  XLR_CONT_IN_SHELL};
-
-  // Drive pin1, read shell (far end bond)
-  for (int i = 0; i < 4; i++) pinMode(outPins[i], INPUT);
-  pinMode(XLR_CONT_OUT_PIN1, OUTPUT);
-  digitalWrite(XLR_CONT_OUT_PIN1, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-  r.farShellBond = digitalRead(XLR_CONT_IN_SHELL) == HIGH;
-  digitalWrite(XLR_CONT_OUT_PIN1, LOW);
-  delay(RELAY_SETTLE_MS);
-
-  // Drive shell, read pin1/pin2/pin3/shell
-  for (int i = 0; i < 4; i++) pinMode(outPins[i], INPUT);
-  pinMode(XLR_CONT_OUT_SHELL, OUTPUT);
-  digitalWrite(XLR_CONT_OUT_SHELL, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-  r.nearShellBond = digitalRead(XLR_CONT_IN_PIN1) == HIGH;
-  r.shellToP2 = digitalRead(XLR_CONT_IN_PIN2) == HIGH;
-  r.shellToP3 = digitalRead(XLR_CONT_IN_PIN3) == HIGH;
-  r.shellToShell = digitalRead(XLR_CONT_IN_SHELL) == HIGH;
-  digitalWrite(XLR_CONT_OUT_SHELL, LOW);
-
-  for (int i = 0; i < 4; i++) {
-    pinMode(outPins[i], OUTPUT);
-    digitalWrite(outPins[i], LOW);
-  }
-  resetCircuit();
-
-  r.overallPass = r.nearShellBond && r.farShellBond && !r.shellToP2 && !r.shellToP3;
-  showResult(r.overallPass ? SHOW_PASS : (r.nearShellBond || r.farShellBond ? SHOW_ERROR : SHOW_FAIL));
-
-  String resp = "XSHELL:";
-  resp += r.overallPass ? "PASS" : "FAIL";
-  resp += ":NEAR:" + String(r.nearShellBond ? 1 : 0);
-  resp += ":FAR:" + String(r.farShellBond ? 1 : 0);
-  resp += ":SS:" + String(r.shellToShell ? 1 : 0);
-
-  if (!r.overallPass) {
-    resp += ":REASON:";
-    String issues = "";
-    if (!r.nearShellBond) issues += "NEAR_SHELL_OPEN";
-    if (!r.farShellBond) {
-      if (issues.length() > 0) issues += ",";
-      issues += "FAR_SHELL_OPEN";
-    }
-    if (r.shellToP2) {
-      if (issues.length() > 0) issues += ",";
-      issues += "SHELL_P2_SHORT";
-    }
-    if (r.shellToP3) {
-      if (issues.length() > 0) issues += ",";
-      issues += "SHELL_P3_SHORT";
-    }
-    resp += issues.length() > 0 ? issues : "UNKNOWN";
-  }
-
-  return resp;
+  showingIcon = false;
+  bootIcon = sizeof(BOOT_ICONS);
 }
 
-// ===== RESISTANCE HELPERS =====
-int readResistanceADC() {
-  long adcSum = 0;
-  const int NUM_SAMPLES = 20;
-  for (int i = 0; i < NUM_SAMPLES; i++) {
-    adcSum += analogRead(RES_SENSE);
-    delay(5);
-  }
-  return adcSum / NUM_SAMPLES;
+// Fire-and-forget: a notify doesn't wait on the Bridge thread, which may
+// be blocked in run_command() for this very CAL. There's no acknowledgement,
+// so SAVED:1 means sent.
+bool UnoQTester::writeCalSlot(uint8_t slot, const CalRecord &rec) {
+  (void)slot;
+  const uint8_t *bytes = (const uint8_t *)&rec;
+  MsgPack::bin_t<uint8_t> record(bytes, bytes + sizeof(rec));
+  Bridge.notify("cal_save", record);
+  return true;
 }
 
-float calcCableResistance(int adcValue, int calADC) {
-  float senseVoltage = (adcValue / (float)ADC_MAX) * SUPPLY_VOLTAGE;
-  float calVoltage = (calADC / (float)ADC_MAX) * SUPPLY_VOLTAGE;
-  float calCurrent = (SUPPLY_VOLTAGE - calVoltage) / RES_SENSE_OHM;
-  if (calCurrent <= 0.001) return 0.0;
-  float cableResistance = (senseVoltage - calVoltage) / calCurrent;
-  if (cableResistance < 0) cableResistance = 0;
-  return cableResistance;
+// As writeCalSlot()
+bool UnoQTester::writeConfig(const ConfigRecord &rec) {
+  const uint8_t *bytes = (const uint8_t *)&rec;
+  MsgPack::bin_t<uint8_t> record(bytes, bytes + sizeof(rec));
+  Bridge.notify("config_save", record);
+  return true;
 }
 
-bool resPassCheck(int adcValue, bool calibrated, int calADC) {
-  if (calibrated) return calcCableResistance(adcValue, calADC) <= MAX_CABLE_RESISTANCE;
-  return adcValue <= RES_PASS_THRESHOLD;
+bool UnoQTester::writeStatsSlot(uint8_t slot, const StatsRecord &rec) {
+  (void)slot;
+  const uint8_t *bytes = (const uint8_t *)&rec;
+  MsgPack::bin_t<uint8_t> record(bytes, bytes + sizeof(rec));
+  Bridge.notify("stats_save", record);
+  return true;
 }
 
-String formatResResult(const char* prefix, int adcValue) {
-  bool pass = resPassCheck(adcValue, isCalibrated, calibrationADC);
-  float cableResistance = isCalibrated ? calcCableResistance(adcValue, calibrationADC) : 0.0;
-
-  String resp = String(prefix);
-  resp += pass ? "PASS" : "FAIL";
-  resp += ":ADC:" + String(adcValue);
-  if (isCalibrated) {
-    resp += ":CAL:" + String(calibrationADC);
-    resp += ":MOHM:" + String((int)(cableResistance * 1000));
-    resp += ":OHM:" + String(cableResistance, 3);
-  } else {
-    resp += ":OHM:UNCAL";
-  }
-  return resp;
+bool UnoQTester::isReadOnlyCommand(const char *cmd) {
+  return CableTester::isReadOnlyCommand(cmd) || cmdIs(cmd, "AUTO RESULT");
 }
 
-// ===== TS RESISTANCE TEST =====
-String runResistanceTest() {
-  showResult(SHOW_OFF);
-
-  digitalWrite(K1_K2_RELAY, LOW);
-  digitalWrite(K3_RELAY, LOW);
-  delay(RELAY_SETTLE_MS);
+// ===== COMMAND HANDLER =====
+// UNO Q-only commands; everything else is the library's (CableTester.cpp)
+bool UnoQTester::boardCommand(const char *cmd) {
+  if (cmdIs(cmd, "AUTO RESULT")) {
+    replyBegin(autoResult[0] ? autoResult : "AUTO:NONE");
+    autoResult[0] = '\0';
 
-  digitalWrite(RES_TEST_OUT, HIGH);
-  delay(SIGNAL_SETTLE_MS);
+  } else if (cmdIs(cmd, "MEM")) {
+    formatMem();
 
-  int adcValue = readResistanceADC();
+  } else if (cmdIs(cmd, "READ")) {
+    formatSensors();
 
-  digitalWrite(RES_TEST_OUT, LOW);
-  resetCircuit();
+  } else if (cmdIs(cmd, "PINS")) {
+    formatPinStates();
 
-  bool pass = resPassCheck(adcValue, isCalibrated, calibrationADC);
-  showResult(pass ? SHOW_PASS : SHOW_FAIL);
-
-  return formatResResult("RES:", adcValue);
-}
-
-// ===== XLR RESISTANCE TEST =====
-String runXlrResistanceTest() {
-  showResult(SHOW_OFF);
-
-  digitalWrite(K5_RELAY, HIGH);
-  digitalWrite(K6_RELAY, HIGH);
-  digitalWrite(K3_RELAY, HIGH);
-  delay(RELAY_SETTLE_MS);
-
-  // Pin 2
-  digitalWrite(K4_RELAY, LOW);
-  delay(RELAY_SETTLE_MS);
-  digitalWrite(RES_TEST_OUT, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-  int adcPin2 = readResistanceADC();
-  digitalWrite(RES_TEST_OUT, LOW);
-  delay(RELAY_SETTLE_MS);
-
-  // Pin 3
-  digitalWrite(K4_RELAY, HIGH);
-  delay(RELAY_SETTLE_MS);
-  digitalWrite(RES_TEST_OUT, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-  int adcPin3 = readResistanceADC();
-  digitalWrite(RES_TEST_OUT, LOW);
-  resetCircuit();
-
-  bool pin2Pass = resPassCheck(adcPin2, isXlrCalibrated, xlrCalibrationADC_P2);
-  bool pin3Pass = resPassCheck(adcPin3, isXlrCalibrated, xlrCalibrationADC_P3);
-  bool overallPass = pin2Pass && pin3Pass;
-
-  showResult(overallPass ? SHOW_PASS : SHOW_FAIL);
-
-  float res2 = 0.0, res3 = 0.0;
-  if (isXlrCalibrated) {
-    res2 = calcCableResistance(adcPin2, xlrCalibrationADC_P2);
-    res3 = calcCableResistance(adcPin3, xlrCalibrationADC_P3);
-  }
-
-  String resp = "XRES:";
-  resp += overallPass ? "PASS" : "FAIL";
-  resp += ":P2ADC:" + String(adcPin2);
-  resp += ":P3ADC:" + String(adcPin3);
-  if (isXlrCalibrated) {
-    resp += ":P2CAL:" + String(xlrCalibrationADC_P2);
-    resp += ":P3CAL:" + String(xlrCalibrationADC_P3);
-    resp += ":P2MOHM:" + String((int)(res2 * 1000));
-    resp += ":P2OHM:" + String(res2, 3);
-    resp += ":P3MOHM:" + String((int)(res3 * 1000));
-    resp += ":P3OHM:" + String(res3, 3);
   } else {
-    resp += ":OHM:UNCAL";
+    return false;
   }
-  return resp;
+  replySend();
+  return true;
 }
 
-// ===== TS CALIBRATION =====
-String runCalibration() {
-  showResult(SHOW_OFF);
-
-  digitalWrite(K1_K2_RELAY, LOW);
-  digitalWrite(K3_RELAY, LOW);
-  delay(RELAY_SETTLE_MS);
-
-  digitalWrite(RES_TEST_OUT, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-
-  long adcSum = 0;
-  const int NUM_SAMPLES = 50;
-  for (int i = 0; i < NUM_SAMPLES; i++) {
-    adcSum += analogRead(RES_SENSE);
-    delay(10);
-  }
-  int measuredADC = adcSum / NUM_SAMPLES;
-
-  digitalWrite(RES_TEST_OUT, LOW);
-  resetCircuit();
-
-  if (measuredADC > CAL_REJECT_THRESHOLD) {
-    showResult(SHOW_FAIL);
-    return "CAL:FAIL:ADC:" + String(measuredADC) + ":NO_CABLE";
+// Append the reply to the batch as "#<tag>:<reply>", one per line
+void batchCollect(uint16_t tag) {
+  char prefix[8];
+  snprintf(prefix, sizeof(prefix), "#%u:", tag);
+  const char *parts[] = {batchReplyLen > 0 ? "\n" : "", prefix, replyBuf};
+  for (const char *part : parts) {
+    size_t n = strlen(part);
+    if (batchReplyLen + n >= BATCH_REPLY_SIZE) n = BATCH_REPLY_SIZE - 1 - batchReplyLen;
+    memcpy(batchReply + batchReplyLen, part, n);
+    batchReplyLen += n;
   }
-
-  calibrationADC = measuredADC;
-  isCalibrated = true;
-
-  showResult(SHOW_PASS);
-  return "CAL:OK:ADC:" + String(calibrationADC);
+  batchReply[batchReplyLen] = '\0';
 }
 
-// ===== XLR CALIBRATION =====
-String runXlrCalibration() {
-  showResult(SHOW_OFF);
-
-  const int NUM_SAMPLES = 50;
-
-  digitalWrite(K5_RELAY, HIGH);
-  digitalWrite(K6_RELAY, HIGH);
-  digitalWrite(K3_RELAY, HIGH);
-
-  // Pin 2
-  digitalWrite(K4_RELAY, LOW);
-  delay(RELAY_SETTLE_MS);
-  digitalWrite(RES_TEST_OUT, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-
-  long adcSum = 0;
-  for (int i = 0; i < NUM_SAMPLES; i++) {
-    adcSum += analogRead(RES_SENSE);
-    delay(10);
-  }
-  int measuredP2 = adcSum / NUM_SAMPLES;
-
-  digitalWrite(RES_TEST_OUT, LOW);
-  delay(RELAY_SETTLE_MS);
-
-  // Pin 3
-  digitalWrite(K4_RELAY, HIGH);
-  delay(RELAY_SETTLE_MS);
-  digitalWrite(RES_TEST_OUT, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-
-  adcSum = 0;
-  for (int i = 0; i < NUM_SAMPLES; i++) {
-    adcSum += analogRead(RES_SENSE);
-    delay(10);
-  }
-  int measuredP3 = adcSum / NUM_SAMPLES;
-
-  digitalWrite(RES_TEST_OUT, LOW);
-  resetCircuit();
-
-  if (measuredP2 > CAL_REJECT_THRESHOLD || measuredP3 > CAL_REJECT_THRESHOLD) {
-    showResult(SHOW_FAIL);
-    return "XCAL:FAIL:P2ADC:" + String(measuredP2) + ":P3ADC:" + String(measuredP3) + ":NO_CABLE";
-  }
-
-  xlrCalibrationADC_P2 = measuredP2;
-  xlrCalibrationADC_P3 = measuredP3;
-  isXlrCalibrated = true;
-
-  showResult(SHOW_PASS);
-  return "XCAL:OK:P2ADC:" + String(xlrCalibrationADC_P2) + ":P3ADC:" + String(xlrCalibrationADC_P3);
-}
-
-// ===== UTILITY =====
-void resetCircuit() {
-  digitalWrite(K1_K2_RELAY, LOW);
-  digitalWrite(K3_RELAY, LOW);
-  digitalWrite(K4_RELAY, LOW);
-  digitalWrite(K5_RELAY, LOW);
-  digitalWrite(K6_RELAY, LOW);
-  digitalWrite(TS_CONT_OUT_SLEEVE, LOW);
-  digitalWrite(TS_CONT_OUT_TIP, LOW);
-  digitalWrite(RES_TEST_OUT, LOW);
-  digitalWrite(XLR_CONT_OUT_PIN1, LOW);
-  digitalWrite(XLR_CONT_OUT_PIN2, LOW);
-  digitalWrite(XLR_CONT_OUT_PIN3, LOW);
-  digitalWrite(XLR_CONT_OUT_SHELL, LOW);
-}
-
-void showResult(int result) {
+// ===== DISPLAY =====
+void displayResult(uint8_t result) {
+  scrollShown = false;
   matrix.setGrayscaleBits(1);
   switch (result) {
     case SHOW_PASS:
@@ -992,37 +773,71 @@ void showResult(int result) {
   }
 }
 
-bool selfTest() {
-  // Show each icon briefly during startup
-  int patterns[] = {SHOW_FAIL, SHOW_PASS, SHOW_ERROR};
-  for (int i = 0; i < 3; i++) {
-    showResult(patterns[i]);
-    showingIcon = false;  // Don't hold icon during self-test
-    delay(300);
-    showResult(SHOW_OFF);
-    delay(100);
-  }
+void UnoQTester::showResult(uint8_t result) {
+  displayResult(result);
+}
+
+// Starts the icon cycle; loop() shows it, nothing waits on it
+bool UnoQTester::selfTest() {
+  bootIcon = 0;
+  bootIconAt = millis() - BOOT_ICON_MS;
   return true;
 }
 
-String readSensors() {
-  String r = "TS_TIP:" + String(digitalRead(TS_CONT_IN_TIP));
-  r += ",TS_SLV:" + String(digitalRead(TS_CONT_IN_SLEEVE));
-  r += ",RES_ADC:" + String(analogRead(RES_SENSE));
-  r += ",XLR_P1:" + String(digitalRead(XLR_CONT_IN_PIN1));
-  r += ",XLR_P2:" + String(digitalRead(XLR_CONT_IN_PIN2));
-  r += ",XLR_P3:" + String(digitalRead(XLR_CONT_IN_PIN3));
-  r += ",XLR_SH:" + String(digitalRead(XLR_CONT_IN_SHELL));
-  return r;
+void formatSensors() {
+  uint8_t sense = readSense();
+  replyBegin("TS_TIP:");
+  replyBit(sense & SENSE_TS_TIP);
+  replyAdd(",TS_SLV:");
+  replyBit(sense & SENSE_TS_SLEEVE);
+  replyAdd(",RES_ADC:");
+  replyInt(analogRead(RES_SENSE));
+  replyAdd(",XLR_P1:");
+  replyBit(sense & SENSE_XLR_PIN1);
+  replyAdd(",XLR_P2:");
+  replyBit(sense & SENSE_XLR_PIN2);
+  replyAdd(",XLR_P3:");
+  replyBit(sense & SENSE_XLR_PIN3);
+  replyAdd(",XLR_SH:");
+  replyBit(sense & SENSE_XLR_SHELL);
+}
+
+void formatPinStates() {
+  replyBegin("K12:");
+  replyAdd(digitalRead(K1_K2_RELAY) ? "H" : "L");
+  replyAdd(",K3:");
+  replyAdd(digitalRead(K3_RELAY) ? "H" : "L");
+  replyAdd(",K4:");
+  replyAdd(digitalRead(K4_RELAY) ? "H" : "L");
+  replyAdd(",K5:");
+  replyAdd(digitalRead(K5_RELAY) ? "H" : "L");
+  replyAdd(",K6:");
+  replyAdd(digitalRead(K6_RELAY) ? "H" : "L");
+  replyAdd(",RES_DRV:");
+  replyAdd(digitalRead(RES_TEST_OUT) ? "H" : "L");
+  replyAdd(",RES_ADC:");
+  replyInt(analogRead(RES_SENSE));
 }
 
-String readPinStates() {
-  String r = "K12:" + String(digitalRead(K1_K2_RELAY) ? "H" : "L");
-  r += ",K3:" + String(digitalRead(K3_RELAY) ? "H" : "L");
-  r += ",K4:" + String(digitalRead(K4_RELAY) ? "H" : "L");
-  r += ",K5:" + String(digitalRead(K5_RELAY) ? "H" : "L");
-  r += ",K6:" + String(digitalRead(K6_RELAY) ? "H" : "L");
-  r += ",RES_DRV:" + String(digitalRead(RES_TEST_OUT) ? "H" : "L");
-  r += ",RES_ADC:" + String(analogRead(RES_SENSE));
-  return r;
+// ===== MEMORY =====
+// RAM isn't tight here (~5 KB of 523 KB), so MEM watches what can run out:
+// the sketch thread's stack. FREE is the headroom now, MIN the least it has
+// had (Zephyr paints thread stacks with CONFIG_INIT_STACKS). Either reads -1
+// when the core is built without that stack info.
+// MEM:FREE:<bytes>:MIN:<bytes>:REPLY:<longest response>
+void formatMem() {
+  long freeNow = -1;
+  long freeMin = -1;
+#ifdef CONFIG_THREAD_STACK_INFO
+  char top;
+  freeNow = &top - (char *)k_current_get()->stack_info.start;
+#ifdef CONFIG_INIT_STACKS
+  size_t unused;
+  if (k_thread_stack_space_get(k_current_get(), &unused) == 0) freeMin = unused;
+#endif
+#endif
+  replyBegin("MEM");
+  replyField("FREE", freeNow);
+  replyField("MIN", freeMin);
+  replyField("REPLY", replyPeak);
 }
@@ -4,6 +4,11 @@
  * Continuity, polarity, and resistance testing for TS/XLR cables.
  * Communicates with Raspberry Pi via USB serial.
  *
+ * The test engine (step programs, scheduler, batches, AUTO, result
+ * formatting) is the shared CableTester library in arduino/libraries; this
+ * sketch is the Mega shell around it: serial transport, RGB result LED and
+ * the Mega-only commands (FORMAT, MEM, BAUD, LED, READ, PINS, HELP).
+ *
  * Commands:
  *   CONT     - Run TS continuity/polarity test, returns RESULT:...
  *   RES      - Run TS resistance test, returns RES:...
@@ -11,8 +16,101 @@
  *   CAL      - Calibrate TS resistance (use short cable)
  *   XSHELL   - Run XLR shell bond test, returns XSHELL:...
  *   XCAL     - Calibrate XLR resistance (use short cable)
- *   STATUS   - Get tester status, returns STATUS:...
+ *   CALINFO  - Active calibration, its age and storage, returns CALINFO:...
+ *   FULL     - TS continuity + resistance in one pass, returns FULL:...
+ *   XFULL    - XLR continuity + resistance in one pass, returns XFULL:...
+ *              (XFULL SHELL also runs the shell bond test)
+ *   BOTH     - TS + XLR continuity in one scan, returns BOTH:...|RESULT:...|XCONT:...
+ *   STATUS   - Get tester status, returns STATUS:... (:BUSY while testing)
  *   ID       - Get tester ID, returns ID:...
+ *   CANCEL   - Abort the running test and clear the queue, returns OK:CANCEL
+ *   SETTLE   - Settle mode, returns SETTLE:ADAPTIVE|FIXED
+ *              (SETTLE FIXED / SETTLE ADAPTIVE to change)
+ *   FAST     - Fail-fast mode, returns FAST:ON|OFF
+ *              (FAST ON / FAST OFF to change; "<test> FAST" for one test)
+ *   BURST    - Burst resistance captures, returns BURST:ON|OFF
+ *              (BURST ON / BURST OFF to change)
+ *   RESSTAT  - Sample statistics in RES/XRES results, returns RESSTAT:ON|OFF
+ *              (RESSTAT ON / RESSTAT OFF to change)
+ *   OVERSAMPLE - Extra bits per resistance reading, returns OVERSAMPLE:OFF|<bits>
+ *              (OVERSAMPLE 1..4 / OVERSAMPLE OFF to change)
+ *   BOOT     - Power-on LED check, returns BOOT:FULL|FAST
+ *              (BOOT FAST skips it; the circuit check always runs)
+ *   STATS    - Wear counters, returns STATS:SAVED:...:K12:<n>...:<test>:<pass>:<fail>
+ *              (STATS SAVE stores them now, STATS RESET zeroes them)
+ *   FLEX     - Flex test, returns FLEX:OFF|TS|XLR[:MS:...] (see FLEX below)
+ *              (FLEX TS / FLEX XLR to start, FLEX OFF to stop)
+ *   FORMAT   - Test result format, returns FORMAT:TEXT|BIN
+ *              (FORMAT BIN sends results as framed binary records)
+ *   MEM      - Free SRAM now and at its lowest, returns MEM:FREE:...
+ *   PROFILE  - Per-command test timing, returns PROFILE:...
+ *              (PROFILE <cmd> breaks one down by phase, PROFILE RESET clears)
+ *   BAUD     - Serial rate, returns BAUD:<current>:<supported,...>
+ *              (BAUD <rate> switches; see SERIAL below)
+ *   AUTO     - Auto-test mode, returns AUTO:OFF|<test>
+ *              (AUTO <test> arms it, AUTO OFF stops; see AUTO below)
+ *   #<tag> <cmd>;<cmd>...
+ *            - Tagged batch, see BATCHES below
+ *   H<n>:<cmd>
+ *            - Command for test head n (H2:XCONT), see HEADS below
+ *
+ * CAL/XCAL results are kept in EEPROM (CRC-checked, spread over CAL_SLOTS
+ * slots) and reloaded at boot, so a power cycle doesn't need a new CAL.
+ * The session settings (FAST, BURST, RESSTAT, OVERSAMPLE, SETTLE, AUTO,
+ * BOOT) are kept the same way, one ConfigRecord after the slots, and so
+ * are each head's wear counters (STATS), written back every 10 minutes at
+ * most so they don't wear the EEPROM out themselves.
+ *
+ * At boot the idle circuit is checked (no sense line up, every drive reads
+ * back, RES_SENSE at rest) before READY:; a stuck line answers
+ * ERROR:SELF_TEST_FAILED:<line> instead.
+ *
+ * RESULT/XCONT/XSHELL/RES/XRES responses end with :SETTLE:<us>,... — the
+ * measured settle time of each drive step, in test order.
+ *
+ * Tests run from loop() without blocking, so serial input is read while a
+ * test is in progress. Test commands received mid-test are queued (up to
+ * TEST_QUEUE_SIZE) and answered in order; a cancelled test answers
+ * ERROR:CANCELLED:<cmd>.
+ *
+ * The tester boots at 9600 baud. BAUD <rate> answers OK:BAUD:<rate> at the
+ * old rate and switches; the new rate sticks once ID or STATUS arrives at
+ * it, otherwise the tester drops back to 9600 after BAUD_CONFIRM_MS.
+ *
+ * BATCHES: "#17 CONT;RES" runs each command as if sent on its own line, in
+ * order. Every response line it produces starts with "#17:" and arrives as
+ * soon as that command completes (tests queue as usual; a binary result is
+ * announced by "#17:BIN" followed by its frame). "#17:END" follows the last
+ * one. Tags are 1-65534; a malformed batch answers ERROR:BAD_BATCH.
+ *
+ * AUTO: with AUTO <test> (any test but CAL/XCAL) the idle loop probes for a
+ * cable every AUTO_POLL_MS: a AUTO_PROBE_US pulse on the TS (tip + sleeve)
+ * or XLR (pins 1-3) drives, read back on the matching sense inputs. After
+ * AUTO_DEBOUNCE agreeing probes it sends EVENT:INSERTED and runs the test;
+ * its result arrives unprompted as EVENT:<response> (EVENT:BIN + frame in
+ * FORMAT BIN). Pulling the cable sends EVENT:REMOVED and re-arms. TS tests
+ * keep K1+K2 in continuity mode between probes.
+ *
+ * EVENT:DRIFT:<path>:<mohm> arrives unprompted, once, when a resistance
+ * baseline moves past CAL_DRIFT_WARN_MOHM (see STATUS); CAL/XCAL again.
+ *
+ * FLEX: FLEX TS / FLEX XLR hold the TS (tip + sleeve) or XLR (pins 1-3)
+ * drives on while the cable is worked by hand. Timer2 samples the sense
+ * inputs every FLEX_SAMPLE_US (50 us); each dropout arrives unprompted as
+ * EVENT:FLEX:DROP:<line>:AT:<ms>:US:<us> once the line comes back. FLEX
+ * answers the running totals (drops per line, LONGEST, LOST, OPEN lines),
+ * FLEX OFF the final ones. Tests and debug drives answer ERROR:BUSY until
+ * FLEX OFF or CANCEL.
+ *
+ * HEADS: built with -DCABLE_TESTER_HEADS=<n> (2-4), heads 2..n hang off a
+ * shift register chain on D22-D26 (TEST HEADS in BoardTraits.h) and each
+ * runs its own tests alongside head 1's. "H2:XCONT" goes to head 2, and
+ * everything head 2 sends starts with "H2:" (H2:XCONT:PASS:..., H2:#5:...,
+ * H2:EVENT:...). Chained heads run continuity tests only (CONT, XCONT,
+ * XSHELL and AUTO with them): resistance tests and FLEX answer
+ * ERROR:NOT_ON_HEAD:<cmd>, board commands are head 1's, and their results
+ * are always text. The LEDs show head 1. ID adds :HEADS:<n>; an unknown
+ * head, or a head prefix inside a batch, answers ERROR:BAD_HEAD:<cmd>.
  *
  * Relay Configuration:
  *   K1+K2 (D14)    - Tied together. TS test mode switching. LOW = short far end + res path, HIGH = continuity mode
@@ -34,6 +132,11 @@
  *   D19 - FAIL_LED (red)
  *   D20 - PASS_LED (green)
  *   D21 - ERROR_LED (blue)
+ *   D22 - HEAD_DATA, head chain 74HC595 serial in (multi-head builds)
+ *   D23 - HEAD_CLOCK, head chain shift clock
+ *   D24 - HEAD_LATCH, head chain 74HC595 latch
+ *   D25 - HEAD_SENSE, head chain 74HC165 serial out
+ *   D26 - HEAD_LOAD, head chain 74HC165 load
  *   D60 - XLR_CONT_IN_SHELL (read, shell sense far side)
  *   D61 - XLR_CONT_OUT_SHELL (drive, shell drive near side)
  *   D62 - K6_DRIVE, XLR Pin 3 cont/res switch
@@ -47,36 +150,11 @@
  *   A0  - RES_SENSE (analog input - high-side sense resistor junction, shared TS/XLR)
  */
 
-// ===== PIN DEFINITIONS =====
-
-// --- TS Cable Testing ---
-// Continuity signals
-#define TS_CONT_OUT_SLEEVE   2    // Continuity signal output to SLEEVE
-#define TS_CONT_OUT_TIP      3    // Continuity signal output to TIP
-#define TS_CONT_IN_SLEEVE    4    // Continuity sense input from SLEEVE
-#define TS_CONT_IN_TIP       5    // Continuity sense input from TIP
-
-// --- Resistance (shared TS/XLR via K3/K4 relay switching) ---
-#define RES_TEST_OUT         6    // PN2222A base drive for resistance test
-#define RES_SENSE            A0   // Analog input: resistance measurement
-
-// --- Relay Drives ---
-#define K1_K2_RELAY         14   // TS test mode: LOW = short far end + res path, HIGH = continuity
-#define K3_RELAY            15   // Resistance circuit: LOW = TS, HIGH = XLR
-#define K4_RELAY            16   // XLR resistance pin select: LOW = Pin 2, HIGH = Pin 3
-#define K5_RELAY            63   // XLR Pin 2: LOW = continuity, HIGH = resistance (into K4)
-#define K6_RELAY            62   // XLR Pin 3: LOW = continuity, HIGH = resistance (into K4)
+#include <CableTester.h>
+#include <EEPROM.h>
 
-// --- XLR Cable Testing ---
-// Continuity signals (paired drive/read with pulldown resistors)
-#define XLR_CONT_OUT_PIN1   69   // Continuity signal output to XLR Pin 1
-#define XLR_CONT_IN_PIN1    68   // Continuity sense input from XLR Pin 1
-#define XLR_CONT_OUT_PIN2   65   // Continuity signal output to XLR Pin 2 (K5)
-#define XLR_CONT_IN_PIN2    67   // Continuity sense input from XLR Pin 2 (K5)
-#define XLR_CONT_OUT_PIN3   64   // Continuity signal output to XLR Pin 3 (K6)
-#define XLR_CONT_IN_PIN3    66   // Continuity sense input from XLR Pin 3 (K6)
-#define XLR_CONT_OUT_SHELL  61   // Continuity signal output to XLR shell (near side)
-#define XLR_CONT_IN_SHELL   60   // Continuity sense input from XLR shell (far side)
+// ===== PIN DEFINITIONS =====
+// Fixture pins are in the library's board map (boards/Mega2560.h)
 
 // --- LEDs ---
 #define STATUS_LED          13   // Built-in LED
@@ -85,138 +163,111 @@
 #define FAIL_LED            19   // Red
 
 // ===== CONFIGURATION =====
-const char* TESTER_ID = "TS_TESTER_1";
-const int BAUD_RATE = 9600;
-const int RELAY_SETTLE_MS = 10;
-const int SIGNAL_SETTLE_MS = 50;
-
-// Resistance test config
-// High-side sense topology: 5V → R_sense(20Ω) → cable → relay → collector, emitter → GND
-// A0 reads junction of R_sense and cable. Lower ADC = more current = lower cable resistance.
-const int RES_PASS_THRESHOLD = 120;  // Absolute ADC threshold (uncalibrated fallback, ~1Ω)
-const float MAX_CABLE_RESISTANCE = 1.0;   // Max cable resistance in ohms to pass
-const float RES_SENSE_OHM = 20.0;   // High-side sense resistor (20Ω)
-const float SUPPLY_VOLTAGE = 5.0;    // Arduino USB supply voltage
-const float VCE_SAT = 0.3;           // PN2222A saturation voltage estimate
-// Base: D6 → 330Ω → base. Emitter grounded, so Ib ≈ 12mA — solid drive, no degeneration.
-
-// Calibration (stored in RAM, lost on reset - could use EEPROM)
-int calibrationADC = 0;              // TS ADC reading with zero-ohm reference
-bool isCalibrated = false;
-int xlrCalibrationADC_P2 = 0;        // XLR Pin 2 ADC reading with zero-ohm reference
-int xlrCalibrationADC_P3 = 0;        // XLR Pin 3 ADC reading with zero-ohm reference
-bool isXlrCalibrated = false;
+const long BAUD_RATE = 9600;           // Boot rate (serial monitors, older hosts)
+// BAUD <rate> choices: exact or within 2.1% at 16 MHz (U2X)
+const long FAST_BAUD_RATES[] = {115200, 250000, 500000, 1000000};
+const unsigned long BAUD_CONFIRM_MS = 2000;  // Revert unless ID/STATUS arrives at the new rate
 
 // Forward declaration for default argument
 void setResultLED(int pin = -1);
 
 // ===== GLOBAL STATE =====
-bool systemReady = false;
-String inputBuffer = "";
-
-// ===== TS TEST RESULTS =====
-struct TestResults {
-  // Raw readings
-  bool tipToTip;       // Signal sent to TIP, read on TIP_SENSE
-  bool tipToSleeve;    // Signal sent to TIP, read on SLEEVE_SENSE
-  bool sleeveToSleeve; // Signal sent to SLEEVE, read on SLEEVE_SENSE
-  bool sleeveToTip;    // Signal sent to SLEEVE, read on TIP_SENSE
-  // Interpreted results
-  bool overallPass;
-  bool reversed;
-  bool shorted;
-  bool openTip;
-  bool openSleeve;
+#define CMD_SIZE  64                 // Longest command line (longer lines are truncated)
+char inputBuffer[CMD_SIZE];
+
+// ===== SERIAL =====
+// loop() moves everything the core has received into rxRing, then handles
+// at most one complete line per pass, so a burst of commands neither
+// overflows the core's 64-byte buffer (~0.6 ms at 1 Mbaud) nor holds up the
+// running test.
+#define RX_RING_SIZE  128            // Power of two, <= 256
+char rxRing[RX_RING_SIZE];
+uint8_t rxHead = 0;                  // Free-running; index with & (RX_RING_SIZE - 1)
+uint8_t rxTail = 0;
+uint8_t rxLines = 0;                 // Line terminators in the ring
+bool rxDiscard = false;              // Dropping the rest of an overlong line
+
+long serialBaud = BAUD_RATE;
+bool baudPending = false;            // Switched, not yet confirmed by ID/STATUS
+unsigned long baudSwitchedAt = 0;
+
+// ===== BINARY RESULTS =====
+// FORMAT BIN records (see CableTester.h) are framed on serial as STX,
+// length, record, CRC-8 (poly 0x07); a text line never starts with STX.
+#define BIN_STX          0x02
+
+// ===== STORED CALIBRATION =====
+// CAL_SLOTS CalRecords (see CableTester.h) from CAL_EEPROM_BASE: 256 bytes,
+// ~100k writes per cell, so ~1.6M saves. The ConfigRecord follows; it's
+// only written when a setting changes.
+#define CAL_EEPROM_BASE  0
+#define CAL_SLOTS        16
+#define CONFIG_EEPROM_BASE (CAL_EEPROM_BASE + CAL_SLOTS * sizeof(CalRecord))
+// STATS_SLOTS StatsRecords after it (2880 bytes), split between the heads:
+// at one save per head per STATS_SAVE_MS, a 3-head fixture's cells see
+// ~6.5k writes a year
+#define STATS_EEPROM_BASE  (CONFIG_EEPROM_BASE + sizeof(ConfigRecord))
+#define STATS_SLOTS        24
+static_assert(STATS_EEPROM_BASE + STATS_SLOTS * sizeof(StatsRecord) <= E2END + 1,
+              "stored records overrun the EEPROM");
+
+// ===== TESTER =====
+class MegaTester : public CableTester {
+protected:
+  void sendReply(uint16_t tag) override;
+  void sendRecord(uint16_t tag, const uint8_t *record, uint8_t len) override;
+  void showResult(uint8_t result) override;
+  bool selfTest() override;
+  bool boardCommand(const char *cmd) override;
+  void testStarted(uint8_t kind, uint16_t tag) override;
+  void hostSeen() override { baudPending = false; }
+  uint8_t calSlots() override { return CAL_SLOTS; }
+  bool readCalSlot(uint8_t slot, CalRecord &rec) override;
+  bool writeCalSlot(uint8_t slot, const CalRecord &rec) override;
+  const char *calStorage() override { return "EEPROM"; }
+  bool readConfig(ConfigRecord &rec) override;
+  bool writeConfig(const ConfigRecord &rec) override;
+  uint8_t statsSlots() override { return STATS_SLOTS; }
+  bool readStatsSlot(uint8_t slot, StatsRecord &rec) override;
+  bool writeStatsSlot(uint8_t slot, const StatsRecord &rec) override;
 };
 
-// ===== XLR TEST RESULTS =====
-struct XlrContResults {
-  // 3x3 continuity matrix: [drive][sense]
-  // Index 0=pin1, 1=pin2, 2=pin3
-  bool p[3][3];
-  bool overallPass;
-};
-
-struct XlrShellResults {
-  bool nearShellBond;   // drive shell, sense pin1
-  bool farShellBond;    // drive pin1, sense shell
-  bool shellToShell;    // drive shell, sense shell
-  bool shellToP2;       // shell shorted to pin2
-  bool shellToP3;       // shell shorted to pin3
-  bool overallPass;
-};
+MegaTester tester;
+#if CABLE_TESTER_HEADS > 1
+MegaTester chainHeads[CABLE_TESTER_HEADS - 1];   // Heads 2..n, polled by tester
+#endif
 
 // ===== SETUP =====
 void setup() {
+  paintStack();
+
   Serial.begin(BAUD_RATE);
   while (!Serial) { ; }  // Wait for USB serial
 
-  // --- Relay outputs ---
-  pinMode(K1_K2_RELAY, OUTPUT);
-  pinMode(K3_RELAY, OUTPUT);
-  pinMode(K4_RELAY, OUTPUT);
-  pinMode(K5_RELAY, OUTPUT);
-  pinMode(K6_RELAY, OUTPUT);
-
-  // --- TS continuity outputs ---
-  pinMode(TS_CONT_OUT_SLEEVE, OUTPUT);
-  pinMode(TS_CONT_OUT_TIP, OUTPUT);
-
-  // --- TS continuity inputs ---
-  pinMode(TS_CONT_IN_SLEEVE, INPUT);
-  pinMode(TS_CONT_IN_TIP, INPUT);
-
-  // --- Resistance (shared TS/XLR) ---
-  pinMode(RES_TEST_OUT, OUTPUT);
-  // A0 (RES_SENSE) is analog input by default
-
-  // --- XLR continuity outputs ---
-  pinMode(XLR_CONT_OUT_PIN1, OUTPUT);
-  pinMode(XLR_CONT_OUT_PIN2, OUTPUT);
-  pinMode(XLR_CONT_OUT_PIN3, OUTPUT);
-  pinMode(XLR_CONT_OUT_SHELL, OUTPUT);
-
-  // --- XLR continuity inputs ---
-  pinMode(XLR_CONT_IN_PIN1, INPUT);
-  pinMode(XLR_CONT_IN_PIN2, INPUT);
-  pinMode(XLR_CONT_IN_PIN3, INPUT);
-  pinMode(XLR_CONT_IN_SHELL, INPUT);
-
   // --- LEDs ---
   pinMode(FAIL_LED, OUTPUT);
   pinMode(PASS_LED, OUTPUT);
   pinMode(ERROR_LED, OUTPUT);
   pinMode(STATUS_LED, OUTPUT);
-
-  // Initialize all relays OFF
-  digitalWrite(K1_K2_RELAY, LOW);
-  digitalWrite(K3_RELAY, LOW);
-  digitalWrite(K4_RELAY, LOW);
-  digitalWrite(K5_RELAY, LOW);
-  digitalWrite(K6_RELAY, LOW);
-
-  // Initialize all test outputs OFF
-  digitalWrite(TS_CONT_OUT_SLEEVE, LOW);
-  digitalWrite(TS_CONT_OUT_TIP, LOW);
-  digitalWrite(RES_TEST_OUT, LOW);
-  digitalWrite(XLR_CONT_OUT_PIN1, LOW);
-  digitalWrite(XLR_CONT_OUT_PIN2, LOW);
-  digitalWrite(XLR_CONT_OUT_PIN3, LOW);
-  digitalWrite(XLR_CONT_OUT_SHELL, LOW);
-
-  // All LEDs off
-  setResultLED();
   digitalWrite(STATUS_LED, LOW);
 
-  // Run self-test
-  if (selfTest()) {
-    systemReady = true;
+  // Fixture pins, idle circuit, self-test (and the chained heads)
+#if CABLE_TESTER_HEADS > 1
+  for (MegaTester &head : chainHeads) tester.attachHead(head);
+#endif
+  if (tester.begin()) {
     digitalWrite(STATUS_LED, HIGH);
-    Serial.println("READY:" + String(TESTER_ID));
+    replyBegin("READY:");
+    replyAdd(TESTER_ID);
+    tester.replySend();
   } else {
-    systemReady = false;
     setResultLED(ERROR_LED);
-    Serial.println("ERROR:SELF_TEST_FAILED");
+    replyBegin("ERROR:SELF_TEST_FAILED");
+    if (tester.bootFault()) {
+      replyAdd(":");
+      replyAdd(tester.bootFault());
+    }
+    tester.replySend();
   }
 }
 
@@ -224,91 +275,156 @@ void setup() {
 void loop() {
   // Blink status LED when idle
   static unsigned long lastBlink = 0;
-  if (systemReady && millis() - lastBlink > 1000) {
+  if (tester.isReady() && !tester.isTestRunning() && millis() - lastBlink > 1000) {
     digitalWrite(STATUS_LED, !digitalRead(STATUS_LED));
     lastBlink = millis();
   }
 
-  // Handle serial commands
-  while (Serial.available()) {
-    char c = Serial.read();
-    if (c == '\n' || c == '\r') {
-      if (inputBuffer.length() > 0) {
-        handleCommand(inputBuffer);
-        inputBuffer = "";
-      }
-    } else {
-      inputBuffer += c;
-    }
+  // Handle serial commands (also while a test is running)
+  serialDrain();
+  if (readLine(inputBuffer, CMD_SIZE) && inputBuffer[0] != '\0') {
+    tester.handleCommand(inputBuffer);
+  }
+
+  // Nobody answered at the new rate: go back to the boot rate
+  if (baudPending && millis() - baudSwitchedAt > BAUD_CONFIRM_MS) {
+    setBaud(BAUD_RATE);
   }
+
+  // AUTO probing, then advance the running test, if any
+  tester.poll();
 }
 
-// ===== COMMAND HANDLER =====
-void handleCommand(String cmd) {
-  cmd.trim();
-  cmd.toUpperCase();
+// ===== TESTER HOOKS =====
+// AUTO events go out as EVENT:<response>, batch replies as #<tag>:<response>;
+// a chained head's start with H<n>:
+void MegaTester::sendReply(uint16_t tag) {
+  if (head() > 1) {
+    Serial.print('H');
+    Serial.print(head());
+    Serial.print(':');
+  }
+  if (tag == TAG_AUTO) {
+    Serial.print("EVENT:");
+  } else if (tag) {
+    Serial.print('#');
+    Serial.print(tag);
+    Serial.print(':');
+  }
+  Serial.println(replyBuf);
+}
 
-  if (cmd == "CONT") {
-    if (!systemReady) {
-      Serial.println("ERROR:NOT_READY");
-      return;
-    }
-    runContinuityTest();
+// FORMAT BIN: one framed record (a batch's is announced by #<tag>:BIN first)
+// (head 1 only; chained heads answer in text)
+void MegaTester::sendRecord(uint16_t tag, const uint8_t *record, uint8_t len) {
+  (void)tag;
+  Serial.write(BIN_STX);
+  Serial.write(len);
+  Serial.write(record, len);
+  Serial.write(crc8(record, len));
+}
 
-  } else if (cmd == "XCONT") {
-    if (!systemReady) {
-      Serial.println("ERROR:NOT_READY");
-      return;
-    }
-    runXlrContinuityTest();
+// The LEDs are head 1's
+void MegaTester::showResult(uint8_t result) {
+  if (head() > 1) return;
+  switch (result) {
+    case SHOW_PASS:  setResultLED(PASS_LED); break;
+    case SHOW_FAIL:  setResultLED(FAIL_LED); break;
+    case SHOW_ERROR: setResultLED(ERROR_LED); break;
+    default:         setResultLED(); break;
+  }
+}
 
-  } else if (cmd == "XSHELL") {
-    if (!systemReady) {
-      Serial.println("ERROR:NOT_READY");
-      return;
-    }
-    runXlrShellTest();
+// Turn off result LEDs, turn on status; calibration announces itself
+void MegaTester::testStarted(uint8_t kind, uint16_t tag) {
+  if (head() > 1) return;
+  setResultLED();
+  digitalWrite(STATUS_LED, HIGH);
 
-  } else if (cmd == "RES") {
-    if (!systemReady) {
-      Serial.println("ERROR:NOT_READY");
-      return;
-    }
-    runResistanceTest();
+  if (kind == TEST_CAL || kind == TEST_XCAL) {
+    replyBegin(kind == TEST_CAL ? "CAL:MEASURING..." : "XCAL:MEASURING...");
+    sendReply(tag);
+  }
+}
 
-  } else if (cmd == "XRES") {
-    if (!systemReady) {
-      Serial.println("ERROR:NOT_READY");
-      return;
-    }
-    runXlrResistanceTest();
+bool MegaTester::readCalSlot(uint8_t slot, CalRecord &rec) {
+  EEPROM.get(CAL_EEPROM_BASE + slot * sizeof(CalRecord), rec);
+  return true;
+}
 
-  } else if (cmd == "CAL") {
-    if (!systemReady) {
-      Serial.println("ERROR:NOT_READY");
-      return;
-    }
-    runCalibration();
+// EEPROM.put() only rewrites the bytes that changed; read back to confirm
+bool MegaTester::writeCalSlot(uint8_t slot, const CalRecord &rec) {
+  int addr = CAL_EEPROM_BASE + slot * sizeof(CalRecord);
+  EEPROM.put(addr, rec);
+  CalRecord check;
+  EEPROM.get(addr, check);
+  return memcmp(&check, &rec, sizeof(rec)) == 0;
+}
 
-  } else if (cmd == "XCAL") {
-    if (!systemReady) {
-      Serial.println("ERROR:NOT_READY");
-      return;
-    }
-    runXlrCalibration();
+bool MegaTester::readConfig(ConfigRecord &rec) {
+  EEPROM.get(CONFIG_EEPROM_BASE, rec);
+  return true;
+}
 
-  } else if (cmd == "STATUS") {
-    sendStatus();
+bool MegaTester::writeConfig(const ConfigRecord &rec) {
+  EEPROM.put(CONFIG_EEPROM_BASE, rec);
+  ConfigRecord check;
+  EEPROM.get(CONFIG_EEPROM_BASE, check);
+  return memcmp(&check, &rec, sizeof(rec)) == 0;
+}
 
-  } else if (cmd == "ID") {
-    Serial.println("ID:" + String(TESTER_ID));
+bool MegaTester::readStatsSlot(uint8_t slot, StatsRecord &rec) {
+  EEPROM.get(STATS_EEPROM_BASE + slot * sizeof(StatsRecord), rec);
+  return true;
+}
 
-  } else if (cmd == "RESET") {
-    resetCircuit();
-    Serial.println("OK:RESET");
+bool MegaTester::writeStatsSlot(uint8_t slot, const StatsRecord &rec) {
+  int addr = STATS_EEPROM_BASE + slot * sizeof(StatsRecord);
+  EEPROM.put(addr, rec);
+  StatsRecord check;
+  EEPROM.get(addr, check);
+  return memcmp(&check, &rec, sizeof(rec)) == 0;
+}
+
+// ===== COMMAND HANDLER =====
+// Mega-only commands; everything else is the library's (CableTester.cpp)
+bool MegaTester::boardCommand(const char *cmd) {
+  if (cmdIs(cmd, "FORMAT") || cmdIs(cmd, "FORMAT TEXT") || cmdIs(cmd, "FORMAT BIN")) {
+    if (!cmdIs(cmd, "FORMAT")) binaryResults = cmdIs(cmd, "FORMAT BIN");
+    replyBegin("FORMAT:");
+    replyAdd(binaryResults ? "BIN" : "TEXT");
+    replySend();
+
+  } else if (cmdIs(cmd, "MEM")) {
+    sendMem();
+
+  } else if (cmdIs(cmd, "BAUD")) {
+    replyBegin("BAUD:");
+    replyInt(serialBaud);
+    replyChar(':');
+    for (uint8_t i = 0; i < sizeof(FAST_BAUD_RATES) / sizeof(FAST_BAUD_RATES[0]); i++) {
+      if (i > 0) replyChar(',');
+      replyInt(FAST_BAUD_RATES[i]);
+    }
+    replySend();
+
+  } else if (strncmp(cmd, "BAUD ", 5) == 0) {
+    long rate = atol(cmd + 5);
+    if (!isBaudRate(rate)) {
+      replyBegin("ERROR:BAUD:");
+      replyAdd(cmd + 5);
+      replySend();
+    } else {
+      replyBegin("OK:BAUD:");
+      replyInt(rate);
+      replySend();
+      setBaud(rate);
+      baudPending = rate != BAUD_RATE;
+      baudSwitchedAt = millis();
+    }
 
   // ===== DEBUG COMMANDS FOR HARDWARE TESTING =====
-  } else if (cmd == "LED") {
+  } else if (cmdIs(cmd, "LED")) {
     // Cycle through all LEDs (result LEDs are active-low)
     Serial.println("DEBUG:LED_TEST_START");
     setResultLED();
@@ -331,114 +447,53 @@ void handleCommand(String cmd) {
     digitalWrite(STATUS_LED, LOW);
     Serial.println("DEBUG:LED_TEST_DONE");
 
-  // --- TS Relay Toggles ---
-  } else if (cmd == "K12") {
-    bool state = !digitalRead(K1_K2_RELAY);
-    digitalWrite(K1_K2_RELAY, state);
-    Serial.println("DEBUG:K1+K2(D14):" + String(state ? "HIGH" : "LOW"));
-
-  } else if (cmd == "K3") {
-    bool state = !digitalRead(K3_RELAY);
-    digitalWrite(K3_RELAY, state);
-    Serial.println("DEBUG:K3(D15):" + String(state ? "HIGH" : "LOW"));
-
-  } else if (cmd == "K4") {
-    bool state = !digitalRead(K4_RELAY);
-    digitalWrite(K4_RELAY, state);
-    Serial.println("DEBUG:K4(D16):" + String(state ? "HIGH" : "LOW"));
-
-  // --- XLR Relay Toggles ---
-  } else if (cmd == "K5") {
-    bool state = !digitalRead(K5_RELAY);
-    digitalWrite(K5_RELAY, state);
-    Serial.println("DEBUG:K5(D62):" + String(state ? "HIGH" : "LOW"));
-
-  } else if (cmd == "K6") {
-    bool state = !digitalRead(K6_RELAY);
-    digitalWrite(K6_RELAY, state);
-    Serial.println("DEBUG:K6(D63):" + String(state ? "HIGH" : "LOW"));
-
-  // --- TS Test Signals ---
-  } else if (cmd == "TSTIP") {
-    bool state = !digitalRead(TS_CONT_OUT_TIP);
-    digitalWrite(TS_CONT_OUT_TIP, state);
-    Serial.println("DEBUG:TS_CONT_OUT_TIP(D3):" + String(state ? "HIGH" : "LOW"));
-
-  } else if (cmd == "TSSLV") {
-    bool state = !digitalRead(TS_CONT_OUT_SLEEVE);
-    digitalWrite(TS_CONT_OUT_SLEEVE, state);
-    Serial.println("DEBUG:TS_CONT_OUT_SLEEVE(D2):" + String(state ? "HIGH" : "LOW"));
-
-  } else if (cmd == "TSRES") {
-    bool state = !digitalRead(RES_TEST_OUT);
-    digitalWrite(RES_TEST_OUT, state);
-    Serial.println("DEBUG:RES_TEST_OUT(D6):" + String(state ? "HIGH" : "LOW"));
-
-  // --- XLR Test Signals ---
-  } else if (cmd == "XLR1") {
-    bool state = !digitalRead(XLR_CONT_OUT_PIN1);
-    digitalWrite(XLR_CONT_OUT_PIN1, state);
-    Serial.println("DEBUG:XLR_CONT_OUT_PIN1(D69):" + String(state ? "HIGH" : "LOW"));
-
-  } else if (cmd == "XLR2") {
-    bool state = !digitalRead(XLR_CONT_OUT_PIN2);
-    digitalWrite(XLR_CONT_OUT_PIN2, state);
-    Serial.println("DEBUG:XLR_CONT_OUT_PIN2(D65):" + String(state ? "HIGH" : "LOW"));
-
-  } else if (cmd == "XLR3") {
-    bool state = !digitalRead(XLR_CONT_OUT_PIN3);
-    digitalWrite(XLR_CONT_OUT_PIN3, state);
-    Serial.println("DEBUG:XLR_CONT_OUT_PIN3(D64):" + String(state ? "HIGH" : "LOW"));
-
-  } else if (cmd == "XLRS") {
-    bool state = !digitalRead(XLR_CONT_OUT_SHELL);
-    digitalWrite(XLR_CONT_OUT_SHELL, state);
-    Serial.println("DEBUG:XLR_CONT_OUT_SHELL(D61):" + String(state ? "HIGH" : "LOW"));
 
   // --- Read Sensors ---
-  } else if (cmd == "READ") {
+  } else if (cmdIs(cmd, "READ")) {
+    uint8_t sense = readSense();
     Serial.println("=== TS SENSE ===");
-    Serial.println("  TIP(D5):    " + String(digitalRead(TS_CONT_IN_TIP)));
-    Serial.println("  SLEEVE(D4): " + String(digitalRead(TS_CONT_IN_SLEEVE)));
+    printLine("  TIP(D5):    ", (sense & SENSE_TS_TIP) ? 1 : 0);
+    printLine("  SLEEVE(D4): ", (sense & SENSE_TS_SLEEVE) ? 1 : 0);
     Serial.println("=== RES SENSE (shared) ===");
-    Serial.println("  RES(A0):    " + String(analogRead(RES_SENSE)));
+    printLine("  RES(A0):    ", readResSense());
     Serial.println("=== XLR SENSE ===");
-    Serial.println("  PIN1(D68):  " + String(digitalRead(XLR_CONT_IN_PIN1)));
-    Serial.println("  PIN2(D67):  " + String(digitalRead(XLR_CONT_IN_PIN2)));
-    Serial.println("  PIN3(D66):  " + String(digitalRead(XLR_CONT_IN_PIN3)));
-    Serial.println("  SHELL(D60): " + String(digitalRead(XLR_CONT_IN_SHELL)));
-  } else if (cmd == "PINS") {
+    printLine("  PIN1(D68):  ", (sense & SENSE_XLR_PIN1) ? 1 : 0);
+    printLine("  PIN2(D67):  ", (sense & SENSE_XLR_PIN2) ? 1 : 0);
+    printLine("  PIN3(D66):  ", (sense & SENSE_XLR_PIN3) ? 1 : 0);
+    printLine("  SHELL(D60): ", (sense & SENSE_XLR_SHELL) ? 1 : 0);
+  } else if (cmdIs(cmd, "PINS")) {
+    uint8_t sense = readSense();
     Serial.println("=== RELAYS ===");
-    Serial.println("  D14 K1+K2:     " + String(digitalRead(K1_K2_RELAY) ? "HIGH" : "LOW") + " (TS far end)");
-    Serial.println("  D15 K3:        " + String(digitalRead(K3_RELAY) ? "HIGH" : "LOW") + " (res: L=TS H=XLR)");
-    Serial.println("  D16 K4:        " + String(digitalRead(K4_RELAY) ? "HIGH" : "LOW") + " (XLR: L=P2 H=P3)");
-    Serial.println("  D63 K5:        " + String(digitalRead(K5_RELAY) ? "HIGH" : "LOW") + " (XLR P2: L=cont H=res)");
-    Serial.println("  D62 K6:        " + String(digitalRead(K6_RELAY) ? "HIGH" : "LOW") + " (XLR P3: L=cont H=res)");
+    printLine("  D14 K1+K2:     ", levelName(digitalRead(K1_K2_RELAY)), " (TS far end)");
+    printLine("  D15 K3:        ", levelName(digitalRead(K3_RELAY)), " (res: L=TS H=XLR)");
+    printLine("  D16 K4:        ", levelName(digitalRead(K4_RELAY)), " (XLR: L=P2 H=P3)");
+    printLine("  D63 K5:        ", levelName(digitalRead(K5_RELAY)), " (XLR P2: L=cont H=res)");
+    printLine("  D62 K6:        ", levelName(digitalRead(K6_RELAY)), " (XLR P3: L=cont H=res)");
     Serial.println("=== TS OUTPUTS ===");
-    Serial.println("  D2  SLEEVE:  " + String(digitalRead(TS_CONT_OUT_SLEEVE) ? "HIGH" : "LOW"));
-    Serial.println("  D3  TIP:     " + String(digitalRead(TS_CONT_OUT_TIP) ? "HIGH" : "LOW"));
+    printLine("  D2  SLEEVE:  ", levelName(digitalRead(TS_CONT_OUT_SLEEVE)));
+    printLine("  D3  TIP:     ", levelName(digitalRead(TS_CONT_OUT_TIP)));
     Serial.println("=== TS INPUTS ===");
-    Serial.println("  D4  SLEEVE:  " + String(digitalRead(TS_CONT_IN_SLEEVE) ? "HIGH" : "LOW"));
-    Serial.println("  D5  TIP:     " + String(digitalRead(TS_CONT_IN_TIP) ? "HIGH" : "LOW"));
+    printLine("  D4  SLEEVE:  ", levelName(sense & SENSE_TS_SLEEVE));
+    printLine("  D5  TIP:     ", levelName(sense & SENSE_TS_TIP));
     Serial.println("=== RESISTANCE (shared) ===");
-    Serial.println("  D6  DRIVE:   " + String(digitalRead(RES_TEST_OUT) ? "HIGH" : "LOW"));
-    Serial.println("  A0  SENSE:   " + String(analogRead(RES_SENSE)));
+    printLine("  D6  DRIVE:   ", levelName(digitalRead(RES_TEST_OUT)));
+    printLine("  A0  SENSE:   ", readResSense());
     Serial.println("=== XLR CONTINUITY ===");
-    Serial.println("  D69 PIN1 OUT:  " + String(digitalRead(XLR_CONT_OUT_PIN1) ? "HIGH" : "LOW"));
-    Serial.println("  D68 PIN1 IN:   " + String(digitalRead(XLR_CONT_IN_PIN1) ? "HIGH" : "LOW"));
-    Serial.println("  D65 PIN2 OUT:  " + String(digitalRead(XLR_CONT_OUT_PIN2) ? "HIGH" : "LOW"));
-    Serial.println("  D67 PIN2 IN:   " + String(digitalRead(XLR_CONT_IN_PIN2) ? "HIGH" : "LOW"));
-    Serial.println("  D64 PIN3 OUT:  " + String(digitalRead(XLR_CONT_OUT_PIN3) ? "HIGH" : "LOW"));
-    Serial.println("  D66 PIN3 IN:   " + String(digitalRead(XLR_CONT_IN_PIN3) ? "HIGH" : "LOW"));
-    Serial.println("  D61 SHELL OUT: " + String(digitalRead(XLR_CONT_OUT_SHELL) ? "HIGH" : "LOW"));
-    Serial.println("  D60 SHELL IN:  " + String(digitalRead(XLR_CONT_IN_SHELL) ? "HIGH" : "LOW"));
+    printLine("  D69 PIN1 OUT:  ", levelName(digitalRead(XLR_CONT_OUT_PIN1)));
+    printLine("  D68 PIN1 IN:   ", levelName(sense & SENSE_XLR_PIN1));
+    printLine("  D65 PIN2 OUT:  ", levelName(digitalRead(XLR_CONT_OUT_PIN2)));
+    printLine("  D67 PIN2 IN:   ", levelName(sense & SENSE_XLR_PIN2));
+    printLine("  D64 PIN3 OUT:  ", levelName(digitalRead(XLR_CONT_OUT_PIN3)));
+    printLine("  D66 PIN3 IN:   ", levelName(sense & SENSE_XLR_PIN3));
+    printLine("  D61 SHELL OUT: ", levelName(digitalRead(XLR_CONT_OUT_SHELL)));
+    printLine("  D60 SHELL IN:  ", levelName(sense & SENSE_XLR_SHELL));
     Serial.println("=== LEDS ===");
-    Serial.println("  D13 STATUS:  " + String(digitalRead(STATUS_LED) ? "ON" : "OFF"));
-    Serial.println("  D19 FAIL:    " + String(digitalRead(FAIL_LED) ? "OFF" : "ON"));
-    Serial.println("  D20 PASS:    " + String(digitalRead(PASS_LED) ? "OFF" : "ON"));
-    Serial.println("  D21 ERROR:   " + String(digitalRead(ERROR_LED) ? "OFF" : "ON"));
+    printLine("  D13 STATUS:  ", digitalRead(STATUS_LED) ? "ON" : "OFF");
+    printLine("  D19 FAIL:    ", digitalRead(FAIL_LED) ? "OFF" : "ON");
+    printLine("  D20 PASS:    ", digitalRead(PASS_LED) ? "OFF" : "ON");
+    printLine("  D21 ERROR:   ", digitalRead(ERROR_LED) ? "OFF" : "ON");
 
-  } else if (cmd == "HELP") {
+  } else if (cmdIs(cmd, "HELP")) {
     Serial.println("=== COMMANDS ===");
     Serial.println("CONT    - Run TS continuity test");
     Serial.println("XCONT   - Run XLR continuity test (pins 1-3)");
@@ -447,9 +502,27 @@ void handleCommand(String cmd) {
     Serial.println("XRES    - Run XLR resistance test (pin 2+3)");
     Serial.println("CAL     - Calibrate TS resistance (short cable)");
     Serial.println("XCAL    - Calibrate XLR resistance (short cable)");
+    Serial.println("CALINFO - Show calibration, age, EEPROM slot");
+    Serial.println("FULL    - TS continuity + resistance, one response");
+    Serial.println("XFULL   - XLR continuity + resistance (XFULL SHELL adds shell)");
+    Serial.println("BOTH    - TS + XLR continuity in one scan (both cables in)");
     Serial.println("STATUS  - Get tester status");
     Serial.println("ID      - Get tester ID");
-    Serial.println("RESET   - Reset circuit");
+    Serial.println("RESET   - Reset circuit (cancels tests)");
+    Serial.println("CANCEL  - Abort running test, clear queue");
+    Serial.println("SETTLE  - Show/set settle mode (SETTLE ADAPTIVE|FIXED)");
+    Serial.println("FAST    - Show/set fail-fast (FAST ON|OFF, or <test> FAST)");
+    Serial.println("BURST   - Show/set short resistance captures (BURST ON|OFF)");
+    Serial.println("RESSTAT - Show/set RES/XRES sample statistics (RESSTAT ON|OFF)");
+    Serial.println("OVERSAMPLE - Show/set extra reading bits (OVERSAMPLE 1..4|OFF)");
+    Serial.println("BOOT    - Show/set power-on LED check (BOOT FAST|FULL)");
+    Serial.println("STATS   - Relay/jack wear and pass/fail counts (STATS SAVE|RESET)");
+    Serial.println("FLEX    - Flex test for dropouts (FLEX TS|XLR|OFF)");
+    Serial.println("FORMAT  - Show/set result format (FORMAT TEXT|BIN)");
+    Serial.println("MEM     - Free SRAM now / lowest since boot");
+    Serial.println("PROFILE - Test timing min/p50/p99/max (PROFILE <cmd>|RESET)");
+    Serial.println("BAUD    - Show/set serial rate (BAUD 1000000; confirm with ID)");
+    Serial.println("AUTO    - Show/set auto-test on insert (AUTO XFULL|OFF)");
     Serial.println("--- DEBUG: RELAYS ---");
     Serial.println("K12     - Toggle K1+K2 (D14)");
     Serial.println("K3      - Toggle K3 (D15)");
@@ -474,588 +547,139 @@ void handleCommand(String cmd) {
     Serial.println("PINS    - Show all pin states");
     Serial.println("LED     - Cycle all LEDs");
 
-  // ===== XLR DEBUG TESTS =====
-  } else if (cmd == "XC") {
-    runXlrContinuityTest();
-
-  } else if (cmd == "XS") {
-    runXlrShellTest();
-
-  } else if (cmd == "XR") {
-    runXlrResistanceTest();
-
   } else {
-    Serial.println("ERROR:UNKNOWN_CMD:" + cmd);
+    return false;
   }
+  return true;
 }
 
-// ===== TEST FUNCTIONS =====
-void runContinuityTest() {
-  TestResults results;
-
-  // Turn off result LEDs, turn on status
-  setResultLED();
-  digitalWrite(STATUS_LED, HIGH);
-
-  // Enter continuity test mode
-  digitalWrite(K1_K2_RELAY, HIGH);   // K1+K2: continuity mode
-  delay(RELAY_SETTLE_MS);
-
-  // === TEST 1: SEND SIGNAL TO TIP ===
-  digitalWrite(TS_CONT_OUT_TIP, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-
-  results.tipToTip = digitalRead(TS_CONT_IN_TIP) == HIGH;
-  results.tipToSleeve = digitalRead(TS_CONT_IN_SLEEVE) == HIGH;
-
-  digitalWrite(TS_CONT_OUT_TIP, LOW);
-  delay(RELAY_SETTLE_MS);
-
-  // === TEST 2: SEND SIGNAL TO SLEEVE ===
-  digitalWrite(TS_CONT_OUT_SLEEVE, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-
-  results.sleeveToSleeve = digitalRead(TS_CONT_IN_SLEEVE) == HIGH;
-  results.sleeveToTip = digitalRead(TS_CONT_IN_TIP) == HIGH;
-
-  digitalWrite(TS_CONT_OUT_SLEEVE, LOW);
-
-  // === EVALUATE RESULTS ===
-  // PASS: signal goes tip->tip and sleeve->sleeve, no cross-connection
-  results.overallPass = results.tipToTip && !results.tipToSleeve &&
-                        results.sleeveToSleeve && !results.sleeveToTip;
-
-  // REVERSED: signal goes tip->sleeve and sleeve->tip
-  results.reversed = !results.tipToTip && results.tipToSleeve &&
-                     !results.sleeveToSleeve && results.sleeveToTip;
-
-  // SHORT: tip and sleeve are shorted together
-  results.shorted = results.tipToSleeve || results.sleeveToTip;
-
-  // OPEN: no signal detected
-  results.openTip = !results.tipToTip && !results.tipToSleeve;
-  results.openSleeve = !results.sleeveToSleeve && !results.sleeveToTip;
-
-  // Reset circuit
-  resetCircuit();
-
-  // Update LEDs
-  if (results.overallPass) {
-    setResultLED(PASS_LED);
-  } else if (results.reversed || results.shorted) {
-    // Wiring error (reversed polarity or short)
-    setResultLED(ERROR_LED);
-  } else {
-    // Open connection
-    setResultLED(FAIL_LED);
-  }
-
-  // Send results
-  sendResults(results);
+const char *levelName(bool high) {
+  return high ? "HIGH" : "LOW";
 }
 
-void sendResults(TestResults &r) {
-  String response = "RESULT:";
-  response += r.overallPass ? "PASS" : "FAIL";
-
-  // Raw readings: TT=tipToTip, TS=tipToSleeve, SS=sleeveToSleeve, ST=sleeveToTip
-  response += ":TT:" + String(r.tipToTip ? 1 : 0);
-  response += ":TS:" + String(r.tipToSleeve ? 1 : 0);
-  response += ":SS:" + String(r.sleeveToSleeve ? 1 : 0);
-  response += ":ST:" + String(r.sleeveToTip ? 1 : 0);
-
-  // Add failure reason if failed
-  if (!r.overallPass) {
-    response += ":REASON:";
-    if (r.reversed) {
-      response += "REVERSED";
-    } else if (r.shorted) {
-      response += "SHORT";
-    } else if (r.openTip && r.openSleeve) {
-      response += "NO_CABLE";
-    } else if (r.openTip) {
-      response += "TIP_OPEN";
-    } else if (r.openSleeve) {
-      response += "SLEEVE_OPEN";
-    } else {
-      response += "UNKNOWN";
-    }
-  }
-
-  Serial.println(response);
+// READ/PINS lines, printed piecewise
+void printLine(const char *label, const char *value) {
+  Serial.print(label);
+  Serial.println(value);
 }
 
-// ===== XLR CONTINUITY TEST =====
-// 3x3 matrix: pin1, pin2, pin3 only (no shell)
-// Shell bond is tested separately via XSHELL command since some
-// connectors have non-conductive coated shells.
-void runXlrContinuityTest() {
-  XlrContResults r;
-
-  setResultLED();
-  digitalWrite(STATUS_LED, HIGH);
-
-  // Ensure K5/K6 LOW = continuity mode
-  resetCircuit();
-  delay(RELAY_SETTLE_MS);
-
-  // Pin mapping arrays: index 0=pin1, 1=pin2, 2=pin3
-  const int outPins[] = {XLR_CONT_OUT_PIN1, XLR_CONT_OUT_PIN2, XLR_CONT_OUT_PIN3};
-  const int inPins[]  = {XLR_CONT_IN_PIN1,  XLR_CONT_IN_PIN2,  XLR_CONT_IN_PIN3};
-
-  // Shell drive must be high-Z during pin tests — if a cable has shell
-  // bonded to pin1, D61 held LOW would fight the pin1 drive signal
-  pinMode(XLR_CONT_OUT_SHELL, INPUT);
-
-  // Drive each of 3 channels and read all three
-  for (int d = 0; d < 3; d++) {
-    // Set all drive pins to high-Z first to avoid fighting through cable bonds
-    for (int i = 0; i < 3; i++) {
-      pinMode(outPins[i], INPUT);
-    }
-    // Drive only the selected channel
-    pinMode(outPins[d], OUTPUT);
-    digitalWrite(outPins[d], HIGH);
-    delay(SIGNAL_SETTLE_MS);
-    for (int s = 0; s < 3; s++) {
-      r.p[d][s] = digitalRead(inPins[s]) == HIGH;
-    }
-    digitalWrite(outPins[d], LOW);
-    delay(RELAY_SETTLE_MS);
-  }
-
-  // Restore all drive pins to OUTPUT for resetCircuit()
-  for (int i = 0; i < 3; i++) {
-    pinMode(outPins[i], OUTPUT);
-  }
-  pinMode(XLR_CONT_OUT_SHELL, OUTPUT);
-
-  resetCircuit();
-
-  // === EVALUATE RESULTS ===
-  r.overallPass = true;
-  for (int d = 0; d < 3; d++) {
-    for (int s = 0; s < 3; s++) {
-      if (d == s && !r.p[d][s]) r.overallPass = false;  // should be connected
-      if (d != s && r.p[d][s])  r.overallPass = false;  // should NOT be connected
-    }
-  }
+void printLine(const char *label, const char *value, const char *note) {
+  Serial.print(label);
+  Serial.print(value);
+  Serial.println(note);
+}
 
-  // LED
-  if (r.overallPass) {
-    setResultLED(PASS_LED);
-  } else {
-    bool anyConnection = false;
-    for (int d = 0; d < 3; d++)
-      for (int s = 0; s < 3; s++)
-        if (r.p[d][s]) anyConnection = true;
-    setResultLED(anyConnection ? ERROR_LED : FAIL_LED);
-  }
+void printLine(const char *label, int value) {
+  Serial.print(label);
+  Serial.println(value);
+}
 
-  // Send result
-  String response = "XCONT:";
-  response += r.overallPass ? "PASS" : "FAIL";
-  for (int d = 0; d < 3; d++) {
-    for (int s = 0; s < 3; s++) {
-      response += ":P" + String(d + 1) + String(s + 1) + ":" + String(r.p[d][s] ? 1 : 0);
+uint8_t crc8(const uint8_t *data, uint8_t len) {
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
     }
   }
+  return crc;
+}
 
-  // Failure reason
-  if (!r.overallPass) {
-    response += ":REASON:";
-    bool allOpen = true;
-    for (int d = 0; d < 3; d++)
-      for (int s = 0; s < 3; s++)
-        if (r.p[d][s]) allOpen = false;
-    if (allOpen) {
-      response += "NO_CABLE";
-    } else {
-      String issues = "";
-      for (int i = 0; i < 3; i++) {
-        if (!r.p[i][i]) {
-          if (issues.length() > 0) issues += ",";
-          issues += "P" + String(i + 1) + "_OPEN";
-        }
-      }
-      for (int d = 0; d < 3; d++) {
-        for (int s = 0; s < 3; s++) {
-          if (d != s && r.p[d][s]) {
-            if (issues.length() > 0) issues += ",";
-            issues += "P" + String(d + 1) + "_P" + String(s + 1) + "_SHORT";
-          }
-        }
-      }
-      response += issues.length() > 0 ? issues : "UNKNOWN";
+// ===== SERIAL FUNCTIONS =====
+void serialDrain() {
+  while (Serial.available() && (uint8_t)(rxHead - rxTail) < RX_RING_SIZE) {
+    char c = Serial.read();
+    bool eol = c == '\n' || c == '\r';
+    if (rxDiscard) {
+      if (eol) rxDiscard = false;
+      continue;
     }
+    rxRing[rxHead++ & (RX_RING_SIZE - 1)] = c;
+    if (eol) rxLines++;
   }
-
-  Serial.println(response);
 }
 
-// ===== XLR SHELL BOND TEST =====
-// Tests shell-to-pin1 bond at both cable ends.
-// Only usable with uncoated/conductive connector shells.
-// Test jacks must have shell UNBONDED from pin 1.
-//
-// Drives pin1 and shell separately, reads cross-connections:
-//   drive pin1 → sense shell = far end shell bond
-//   drive shell → sense pin1 = near end shell bond
-void runXlrShellTest() {
-  XlrShellResults r;
-
-  setResultLED();
-  digitalWrite(STATUS_LED, HIGH);
-
-  resetCircuit();
-  delay(RELAY_SETTLE_MS);
-
-  // All 4 drive/sense pins involved
-  const int outPins[] = {XLR_CONT_OUT_PIN1, XLR_CONT_OUT_PIN2, XLR_CONT_OUT_PIN3, XLR_CONT_OUT_SHELL};
-  const int inPins[]  = {XLR_CONT_IN_PIN1,  XLR_CONT_IN_PIN2,  XLR_CONT_IN_PIN3,  XLR_CONT_IN_SHELL};
-
-  // --- Drive pin1, read shell (far end bond) ---
-  for (int i = 0; i < 4; i++) pinMode(outPins[i], INPUT);
-  pinMode(XLR_CONT_OUT_PIN1, OUTPUT);
-  digitalWrite(XLR_CONT_OUT_PIN1, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-  r.farShellBond = digitalRead(XLR_CONT_IN_SHELL) == HIGH;
-  digitalWrite(XLR_CONT_OUT_PIN1, LOW);
-  delay(RELAY_SETTLE_MS);
-
-  // --- Drive shell, read pin1/pin2/pin3/shell (near end bond + shorts) ---
-  for (int i = 0; i < 4; i++) pinMode(outPins[i], INPUT);
-  pinMode(XLR_CONT_OUT_SHELL, OUTPUT);
-  digitalWrite(XLR_CONT_OUT_SHELL, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-  r.nearShellBond = digitalRead(XLR_CONT_IN_PIN1) == HIGH;
-  r.shellToP2 = digitalRead(XLR_CONT_IN_PIN2) == HIGH;
-  r.shellToP3 = digitalRead(XLR_CONT_IN_PIN3) == HIGH;
-  r.shellToShell = digitalRead(XLR_CONT_IN_SHELL) == HIGH;
-  digitalWrite(XLR_CONT_OUT_SHELL, LOW);
-
-  // Restore drive pins to OUTPUT
-  for (int i = 0; i < 4; i++) {
-    pinMode(outPins[i], OUTPUT);
-    digitalWrite(outPins[i], LOW);
+// Pop the next line (terminator dropped, truncated to size - 1) into buf.
+// A full ring without a terminator is taken as one line and the rest of it
+// is dropped as it arrives. Returns false if no complete line is buffered.
+bool readLine(char *buf, uint8_t size) {
+  if (rxLines == 0) {
+    if ((uint8_t)(rxHead - rxTail) < RX_RING_SIZE) return false;
+    rxDiscard = true;
   }
-  resetCircuit();
-
-  // === EVALUATE ===
-  r.overallPass = r.nearShellBond && r.farShellBond && !r.shellToP2 && !r.shellToP3;
-
-  setResultLED(r.overallPass ? PASS_LED : (r.nearShellBond || r.farShellBond ? ERROR_LED : FAIL_LED));
-
-  // Send result
-  String response = "XSHELL:";
-  response += r.overallPass ? "PASS" : "FAIL";
-  response += ":NEAR:" + String(r.nearShellBond ? 1 : 0);
-  response += ":FAR:" + String(r.farShellBond ? 1 : 0);
-  response += ":SS:" + String(r.shellToShell ? 1 : 0);
-
-  if (!r.overallPass) {
-    response += ":REASON:";
-    String issues = "";
-    if (!r.nearShellBond) issues += "NEAR_SHELL_OPEN";
-    if (!r.farShellBond) {
-      if (issues.length() > 0) issues += ",";
-      issues += "FAR_SHELL_OPEN";
-    }
-    if (r.shellToP2) {
-      if (issues.length() > 0) issues += ",";
-      issues += "SHELL_P2_SHORT";
-    }
-    if (r.shellToP3) {
-      if (issues.length() > 0) issues += ",";
-      issues += "SHELL_P3_SHORT";
+  uint8_t len = 0;
+  while (rxTail != rxHead) {
+    char c = rxRing[rxTail++ & (RX_RING_SIZE - 1)];
+    if (c == '\n' || c == '\r') {
+      rxLines--;
+      break;
     }
-    response += issues.length() > 0 ? issues : "UNKNOWN";
+    if (len < size - 1) buf[len++] = c;
   }
-
-  Serial.println(response);
-}
-
-void sendStatus() {
-  String status = "STATUS:";
-  status += systemReady ? "READY" : "NOT_READY";
-  Serial.println(status);
-}
-
-void resetCircuit() {
-  // All relays off
-  digitalWrite(K1_K2_RELAY, LOW);
-  digitalWrite(K3_RELAY, LOW);
-  digitalWrite(K4_RELAY, LOW);
-  digitalWrite(K5_RELAY, LOW);
-  digitalWrite(K6_RELAY, LOW);
-
-  // All test outputs off
-  digitalWrite(TS_CONT_OUT_SLEEVE, LOW);
-  digitalWrite(TS_CONT_OUT_TIP, LOW);
-  digitalWrite(RES_TEST_OUT, LOW);
-  digitalWrite(XLR_CONT_OUT_PIN1, LOW);
-  digitalWrite(XLR_CONT_OUT_PIN2, LOW);
-  digitalWrite(XLR_CONT_OUT_PIN3, LOW);
-  digitalWrite(XLR_CONT_OUT_SHELL, LOW);
-
+  buf[len] = '\0';
+  return true;
 }
 
-// ===== CALIBRATION =====
-// Calibrate with a known-good short cable (or direct short).
-// Establishes baseline ADC that includes Vce_sat + parasitic resistance.
-// Cable resistance is then measured relative to this baseline.
-void runCalibration() {
-  setResultLED();
-  digitalWrite(STATUS_LED, HIGH);
-
-  Serial.println("CAL:MEASURING...");
-
-  // Configure for TS resistance test mode (calibrate with TS cable)
-  digitalWrite(K1_K2_RELAY, LOW);    // Short far end + res path
-  digitalWrite(K3_RELAY, LOW);       // Route resistance circuit to TS
-  delay(RELAY_SETTLE_MS);
-
-  // Enable current through PN2222A
-  digitalWrite(RES_TEST_OUT, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-
-  // Take multiple samples for stable calibration
-  long adcSum = 0;
-  const int NUM_SAMPLES = 50;
-  for (int i = 0; i < NUM_SAMPLES; i++) {
-    adcSum += analogRead(RES_SENSE);
-    delay(10);
+bool isBaudRate(long rate) {
+  if (rate == BAUD_RATE) return true;
+  for (uint8_t i = 0; i < sizeof(FAST_BAUD_RATES) / sizeof(FAST_BAUD_RATES[0]); i++) {
+    if (rate == FAST_BAUD_RATES[i]) return true;
   }
-  int measuredADC = adcSum / NUM_SAMPLES;
-
-  // Disable test current
-  digitalWrite(RES_TEST_OUT, LOW);
-  resetCircuit();
-
-  // Reject if reading is too high (no cable or bad connection)
-  if (measuredADC > 600) {
-    setResultLED(FAIL_LED);
-    Serial.println("CAL:FAIL:ADC:" + String(measuredADC) + ":NO_CABLE");
-    return;
-  }
-
-  calibrationADC = measuredADC;
-  isCalibrated = true;
-
-  setResultLED(PASS_LED);
-  Serial.println("CAL:OK:ADC:" + String(calibrationADC));
+  return false;
 }
 
-// ===== XLR CALIBRATION =====
-// Calibrates both pin 2 and pin 3 paths separately since relay contact
-// resistance can differ between K4 LOW (pin 2) and K4 HIGH (pin 3).
-void runXlrCalibration() {
-  setResultLED();
-  digitalWrite(STATUS_LED, HIGH);
-
-  Serial.println("XCAL:MEASURING...");
-
-  const int NUM_SAMPLES = 50;
-
-  // Common setup: both pins to resistance mode, route to XLR
-  digitalWrite(K5_RELAY, HIGH);      // Pin 2 to resistance mode
-  digitalWrite(K6_RELAY, HIGH);      // Pin 3 to resistance mode
-  digitalWrite(K3_RELAY, HIGH);      // Route resistance circuit to XLR
-
-  // --- Calibrate Pin 2 ---
-  digitalWrite(K4_RELAY, LOW);       // Select Pin 2
-  delay(RELAY_SETTLE_MS);
-  digitalWrite(RES_TEST_OUT, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-
-  long adcSum = 0;
-  for (int i = 0; i < NUM_SAMPLES; i++) {
-    adcSum += analogRead(RES_SENSE);
-    delay(10);
-  }
-  int measuredP2 = adcSum / NUM_SAMPLES;
-
-  digitalWrite(RES_TEST_OUT, LOW);
-  delay(RELAY_SETTLE_MS);
-
-  // --- Calibrate Pin 3 ---
-  digitalWrite(K4_RELAY, HIGH);      // Select Pin 3
-  delay(RELAY_SETTLE_MS);
-  digitalWrite(RES_TEST_OUT, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-
-  adcSum = 0;
-  for (int i = 0; i < NUM_SAMPLES; i++) {
-    adcSum += analogRead(RES_SENSE);
-    delay(10);
-  }
-  int measuredP3 = adcSum / NUM_SAMPLES;
-
-  digitalWrite(RES_TEST_OUT, LOW);
-  resetCircuit();
-
-  // Reject if either reading is too high (no cable or bad connection)
-  if (measuredP2 > 600 || measuredP3 > 600) {
-    setResultLED(FAIL_LED);
-    Serial.println("XCAL:FAIL:P2ADC:" + String(measuredP2) + ":P3ADC:" + String(measuredP3) + ":NO_CABLE");
-    return;
-  }
-
-  xlrCalibrationADC_P2 = measuredP2;
-  xlrCalibrationADC_P3 = measuredP3;
-  isXlrCalibrated = true;
-
-  setResultLED(PASS_LED);
-  Serial.println("XCAL:OK:P2ADC:" + String(xlrCalibrationADC_P2) + ":P3ADC:" + String(xlrCalibrationADC_P3));
+// Finish sending at the old rate, then reopen; anything half-received at
+// the old rate is garbage now
+void setBaud(long rate) {
+  Serial.flush();
+  Serial.end();
+  Serial.begin(rate);
+  serialBaud = rate;
+  baudPending = false;
+  rxHead = rxTail = rxLines = 0;
+  rxDiscard = false;
 }
 
-// ===== RESISTANCE MEASUREMENT HELPER =====
-// Takes a resistance reading on the shared circuit (A0).
-// Returns averaged ADC value from NUM_SAMPLES readings.
-int readResistanceADC() {
-  long adcSum = 0;
-  const int NUM_SAMPLES = 20;
-  for (int i = 0; i < NUM_SAMPLES; i++) {
-    adcSum += analogRead(RES_SENSE);
-    delay(5);
-  }
-  return adcSum / NUM_SAMPLES;
-}
+// ===== MEMORY =====
+// MEM reports the gap between heap and stack (free SRAM) and the smallest
+// it has been since boot. setup() paints the gap with STACK_PAINT; the
+// stack overwrites the paint as it grows, so the untouched bytes above the
+// heap are the low-water mark.
+#define STACK_PAINT  0xC5
 
-// Calculate cable resistance from ADC reading relative to calibration
-float calcCableResistance(int adcValue, int calADC) {
-  float senseVoltage = (adcValue / 1023.0) * SUPPLY_VOLTAGE;
-  float calVoltage = (calADC / 1023.0) * SUPPLY_VOLTAGE;
-  float calCurrent = (SUPPLY_VOLTAGE - calVoltage) / RES_SENSE_OHM;
-  if (calCurrent <= 0.001) return 0.0;
+extern char __heap_start;
+extern char *__brkval;
 
-  float cableResistance = (senseVoltage - calVoltage) / calCurrent;
-  if (cableResistance < 0) cableResistance = 0;
-  return cableResistance;
+char *heapEnd() {
+  return __brkval ? __brkval : &__heap_start;
 }
 
-// Check pass/fail: use calibrated resistance if available, else absolute ADC
-bool resPassCheck(int adcValue, bool calibrated, int calADC) {
-  if (calibrated) {
-    return calcCableResistance(adcValue, calADC) <= MAX_CABLE_RESISTANCE;
-  }
-  return adcValue <= RES_PASS_THRESHOLD;
+void paintStack() {
+  char top;
+  for (char *p = heapEnd(); p < &top - 32; p++) *p = STACK_PAINT;
 }
 
-// Format and send resistance result for a single reading
-void sendResResult(const char* prefix, int adcValue) {
-  bool pass = resPassCheck(adcValue, isCalibrated, calibrationADC);
-  float cableResistance = isCalibrated ? calcCableResistance(adcValue, calibrationADC) : 0.0;
-
-  String response = String(prefix);
-  response += pass ? "PASS" : "FAIL";
-  response += ":ADC:" + String(adcValue);
-  if (isCalibrated) {
-    response += ":CAL:" + String(calibrationADC);
-    int milliohms = (int)(cableResistance * 1000);
-    response += ":MOHM:" + String(milliohms);
-    response += ":OHM:" + String(cableResistance, 3);
-  } else {
-    response += ":OHM:UNCAL";
-  }
-  Serial.println(response);
+int freeRam() {
+  char top;
+  return &top - heapEnd();
 }
 
-// ===== TS RESISTANCE TEST =====
-void runResistanceTest() {
-  setResultLED();
-  digitalWrite(STATUS_LED, HIGH);
-
-  // Configure for TS resistance test
-  // K1+K2 LOW = short far end + res path
-  // K3 LOW = route resistance circuit to TS
-  digitalWrite(K1_K2_RELAY, LOW);
-  digitalWrite(K3_RELAY, LOW);
-  delay(RELAY_SETTLE_MS);
-
-  // Enable current through PN2222A
-  digitalWrite(RES_TEST_OUT, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-
-  int adcValue = readResistanceADC();
-
-  // Disable test current
-  digitalWrite(RES_TEST_OUT, LOW);
-  resetCircuit();
-
-  // Update LED
-  bool pass = resPassCheck(adcValue, isCalibrated, calibrationADC);
-  setResultLED(pass ? PASS_LED : FAIL_LED);
-
-  sendResResult("RES:", adcValue);
+int minFreeRam() {
+  const char *p = heapEnd();
+  int n = 0;
+  while (p + n < (const char *)RAMEND && p[n] == (char)STACK_PAINT) n++;
+  return n;
 }
 
-// ===== XLR RESISTANCE TEST =====
-// Tests pin 2 and pin 3 sequentially through the shared resistance circuit.
-// K3 HIGH = route to XLR, K4 selects pin (LOW = pin 2, HIGH = pin 3)
-void runXlrResistanceTest() {
-  setResultLED();
-  digitalWrite(STATUS_LED, HIGH);
-
-  // Configure for XLR resistance test
-  // K5 HIGH, K6 HIGH = switch pin 2 and pin 3 to resistance mode (into K4)
-  // K3 HIGH = route resistance circuit to XLR
-  digitalWrite(K5_RELAY, HIGH);
-  digitalWrite(K6_RELAY, HIGH);
-  digitalWrite(K3_RELAY, HIGH);
-  delay(RELAY_SETTLE_MS);
-
-  // --- Test Pin 2 ---
-  digitalWrite(K4_RELAY, LOW);       // K4 LOW = Pin 2
-  delay(RELAY_SETTLE_MS);
-  digitalWrite(RES_TEST_OUT, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-
-  int adcPin2 = readResistanceADC();
-
-  digitalWrite(RES_TEST_OUT, LOW);
-  delay(RELAY_SETTLE_MS);
-
-  // --- Test Pin 3 ---
-  digitalWrite(K4_RELAY, HIGH);      // K4 HIGH = Pin 3
-  delay(RELAY_SETTLE_MS);
-  digitalWrite(RES_TEST_OUT, HIGH);
-  delay(SIGNAL_SETTLE_MS);
-
-  int adcPin3 = readResistanceADC();
-
-  digitalWrite(RES_TEST_OUT, LOW);
-  resetCircuit();
-
-  // Evaluate: both pins must pass (each against its own calibration)
-  bool pin2Pass = resPassCheck(adcPin2, isXlrCalibrated, xlrCalibrationADC_P2);
-  bool pin3Pass = resPassCheck(adcPin3, isXlrCalibrated, xlrCalibrationADC_P3);
-  bool overallPass = pin2Pass && pin3Pass;
-
-  setResultLED(overallPass ? PASS_LED : FAIL_LED);
-
-  // Send combined result using per-pin XLR calibration
-  float res2 = 0.0, res3 = 0.0;
-  if (isXlrCalibrated) {
-    res2 = calcCableResistance(adcPin2, xlrCalibrationADC_P2);
-    res3 = calcCableResistance(adcPin3, xlrCalibrationADC_P3);
-  }
-
-  String response = "XRES:";
-  response += overallPass ? "PASS" : "FAIL";
-  response += ":P2ADC:" + String(adcPin2);
-  response += ":P3ADC:" + String(adcPin3);
-  if (isXlrCalibrated) {
-    response += ":P2CAL:" + String(xlrCalibrationADC_P2);
-    response += ":P3CAL:" + String(xlrCalibrationADC_P3);
-    response += ":P2MOHM:" + String((int)(res2 * 1000));
-    response += ":P2OHM:" + String(res2, 3);
-    response += ":P3MOHM:" + String((int)(res3 * 1000));
-    response += ":P3OHM:" + String(res3, 3);
-  } else {
-    response += ":OHM:UNCAL";
-  }
-  Serial.println(response);
+// MEM:FREE:<bytes>:MIN:<bytes>:REPLY:<longest response>
+void sendMem() {
+  int freeNow = freeRam();
+  int freeMin = minFreeRam();
+  replyBegin("MEM");
+  replyField("FREE", freeNow);
+  replyField("MIN", freeMin);
+  replyField("REPLY", replyPeak);
+  tester.replySend();
 }
 
 // ===== UTILITY FUNCTIONS =====
@@ -1071,7 +695,7 @@ void setResultLED(int pin) {
   }
 }
 
-bool selfTest() {
+bool MegaTester::selfTest() {
   // Blink each result LED in sequence
   int leds[] = {FAIL_LED, PASS_LED, ERROR_LED};
   for (int i = 0; i < 3; i++) {
@@ -1080,6 +704,6 @@ bool selfTest() {
     setResultLED();
   }
 
-  // Could add more hardware checks here
+  // The fixture lines themselves are checked by the library first
   return true;
 }
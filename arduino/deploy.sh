@@ -16,6 +16,7 @@ UNOQ_APP_DIR="$PROJECT_DIR/ArduinoApps/cable-tester"
 UNOQ_DEFAULT_FILE="/var/lib/arduino-app-cli/default.app"
 
 MEGA_SKETCH_DIR="$SCRIPT_DIR/cable_tester"
+MEGA_LIBRARIES="$SCRIPT_DIR/libraries"       # Shared CableTester library
 MEGA_FQBN="arduino:avr:mega"
 MEGA_PORT="/dev/ttyACM0"
 
@@ -66,7 +67,7 @@ elif [[ "$PLATFORM" == "mega" ]]; then
     fi
 
     echo "Compiling..."
-    arduino-cli compile --fqbn "$MEGA_FQBN" "$MEGA_SKETCH_DIR"
+    arduino-cli compile --fqbn "$MEGA_FQBN" --libraries "$MEGA_LIBRARIES" "$MEGA_SKETCH_DIR"
 
     echo "Uploading to $MEGA_PORT..."
     arduino-cli upload -p "$MEGA_PORT" --fqbn "$MEGA_FQBN" "$MEGA_SKETCH_DIR"
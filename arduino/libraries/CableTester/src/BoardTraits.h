@@ -0,0 +1,184 @@
+/*
+ * BoardTraits.h - Compile-time description of the tester board
+ *
+ * Picks the pin map and hardware constants (ADC width, supply voltage,
+ * thresholds) for the board being built, and declares the board I/O layer
+ * (boards/<board>.cpp) that the shared engine drives the fixture through.
+ * Everything above this layer is the same code on both testers.
+ */
+
+#ifndef CABLE_TESTER_BOARD_TRAITS_H
+#define CABLE_TESTER_BOARD_TRAITS_H
+
+#include <Arduino.h>
+
+// ADC scaling for a `Bits`-wide converter referenced to the supply rail.
+// Board headers take ADC_MAX/SUPPLY_VOLTAGE from it and size thresholds as
+// fractions of full scale with counts(), so nothing is scaled at run time.
+template <uint8_t Bits, uint16_t SupplyMillivolts>
+struct AdcTraits {
+  static constexpr uint8_t BITS = Bits;
+  static constexpr int MAX = (1 << Bits) - 1;
+  static constexpr float SUPPLY = SupplyMillivolts / 1000.0f;
+  static constexpr uint16_t SUPPLY_MV = SupplyMillivolts;
+  static constexpr int counts(double fraction) { return (int)(fraction * MAX + 0.5); }
+};
+
+#if defined(ARDUINO_AVR_MEGA2560)
+#include "boards/Mega2560.h"
+#elif defined(ARDUINO_ARCH_ZEPHYR)
+#include "boards/UnoQ.h"
+#else
+#error "CableTester: unsupported board (Mega 2560 or UNO Q)"
+#endif
+
+// --- Fast I/O masks ---
+// readSense() returns every continuity sense input in one byte
+#define SENSE_TS_TIP        0x01
+#define SENSE_TS_SLEEVE     0x02
+#define SENSE_XLR_PIN1      0x04
+#define SENSE_XLR_PIN2      0x08
+#define SENSE_XLR_PIN3      0x10
+#define SENSE_XLR_SHELL     0x20
+// xlrDrive() line selection
+#define XD_PIN1             0x01
+#define XD_PIN2             0x02
+#define XD_PIN3             0x04
+#define XD_SHELL            0x08
+#define XD_ALL              0x0F
+
+// --- Pin tables ---
+// Line order matches the bit order of the masks above, so table[i] is the
+// pin behind bit (1 << i).
+constexpr uint8_t SENSE_PINS[] = {
+  TS_CONT_IN_TIP, TS_CONT_IN_SLEEVE,
+  XLR_CONT_IN_PIN1, XLR_CONT_IN_PIN2, XLR_CONT_IN_PIN3, XLR_CONT_IN_SHELL,
+};
+constexpr uint8_t XLR_DRIVE_PINS[] = {
+  XLR_CONT_OUT_PIN1, XLR_CONT_OUT_PIN2, XLR_CONT_OUT_PIN3, XLR_CONT_OUT_SHELL,
+};
+// Every output begin() configures and resetCircuit() drives LOW, relays first
+constexpr uint8_t OUTPUT_PINS[] = {
+  K1_K2_RELAY, K3_RELAY, K4_RELAY, K5_RELAY, K6_RELAY,
+  TS_CONT_OUT_SLEEVE, TS_CONT_OUT_TIP, RES_TEST_OUT,
+  XLR_CONT_OUT_PIN1, XLR_CONT_OUT_PIN2, XLR_CONT_OUT_PIN3, XLR_CONT_OUT_SHELL,
+};
+constexpr uint8_t RELAY_COUNT = 5;    // OUTPUT_PINS[0 .. RELAY_COUNT - 1]
+
+static_assert(OUTPUT_PINS[0] == K1_K2_RELAY && OUTPUT_PINS[RELAY_COUNT - 1] == K6_RELAY,
+              "OUTPUT_PINS must start with the relays");
+static_assert(sizeof(SENSE_PINS) == 6 && SENSE_XLR_SHELL == 1 << 5, "SENSE_PINS out of step with SENSE_*");
+static_assert(sizeof(XLR_DRIVE_PINS) == 4 && XD_SHELL == 1 << 3, "XLR_DRIVE_PINS out of step with XD_*");
+static_assert(RES_PASS_THRESHOLD < CAL_REJECT_THRESHOLD && CAL_REJECT_THRESHOLD < ADC_MAX,
+              "resistance thresholds must sit inside the ADC range");
+
+// Debug toggle commands (K12, TSTIP, ...): flip `pin`, answer
+// DEBUG:<label>:HIGH|LOW. Labels name the board's pin numbers.
+struct PinToggle {
+  const char *cmd;
+  uint8_t pin;
+  const char *label;
+};
+
+extern const PinToggle BOARD_TOGGLES[];
+extern const uint8_t NUM_BOARD_TOGGLES;
+
+// ===== BOARD I/O LAYER =====
+void boardBegin();                            // Board setup after the pin modes (ADC)
+uint8_t readSense();                          // Every sense input, one SENSE_* snapshot
+void xlrDrive(uint8_t lines, uint8_t level);  // XD_* lines to level, other XLR drives high-Z
+
+// RES_SENSE bursts for OP_ADC: start one, poll until done, take its sums.
+// Gathered per conversion in one pass, so the statistics cost no buffer.
+struct AdcBurst {
+  uint16_t count;
+  uint32_t sum;
+  uint64_t sumSq;
+  uint16_t min;
+  uint16_t max;
+  uint16_t outliers;         // Samples more than ADC_OUTLIER_TOL off, see AdcOutliers
+};
+
+// Burst outliers counted one conversion at a time: samples more than
+// ADC_OUTLIER_TOL from the mean of the burst's largest group of agreeing
+// samples. Two groups are kept; a sample fitting neither restarts the
+// smaller one. A glitch, even on the first conversion, ends up in the
+// group that loses instead of becoming the reference. Compared as
+// value * n against the group's sum: no division per conversion.
+struct AdcOutliers {
+  struct Group {
+    uint16_t n;
+    uint32_t sum;
+  };
+  Group a, b;
+  uint16_t taken;
+
+  void reset() {
+    a = b = Group();
+    taken = 0;
+  }
+
+  void add(uint16_t value) {
+    taken++;
+    if (fits(a, value)) join(a, value);
+    else if (fits(b, value)) join(b, value);
+    else {
+      Group &lost = b.n <= a.n ? b : a;
+      lost.n = 1;
+      lost.sum = value;
+    }
+  }
+
+  uint16_t count() const { return taken - (a.n > b.n ? a.n : b.n); }
+
+  static bool fits(const Group &g, uint16_t value) {
+    int32_t off = (int32_t)value * g.n - (int32_t)g.sum;
+    int32_t tol = (int32_t)ADC_OUTLIER_TOL * g.n;
+    return g.n > 0 && off <= tol && off >= -tol;
+  }
+
+  static void join(Group &g, uint16_t value) {
+    g.n++;
+    g.sum += value;
+  }
+};
+void adcStart(uint16_t count);
+bool adcBusy();
+void adcResult(AdcBurst &burst);              // The finished burst
+void adcStop();
+int readResSense();                           // A0 now, without disturbing a burst
+uint16_t readSupplyMv();                      // Supply rail in mV, 0 if it can't be measured now
+
+// FLEX sampling: readSense() every FLEX_SAMPLE_US, and each change queued
+// with the sample tick it was seen at. Ticks count from flexStart().
+struct FlexEdge {
+  uint32_t tick;
+  uint8_t sense;             // SENSE_* snapshot from this tick on
+};
+void flexStart();
+void flexStop();
+bool flexNext(FlexEdge &edge);                // Oldest queued change, false if none
+uint32_t flexTicks();                         // Ticks so far
+uint16_t flexLost();                          // Changes dropped with the queue full
+
+// ===== TEST HEADS =====
+// Head 1 is the fixture on the pins above. With CABLE_TESTER_HEADS > 1
+// (Mega) heads 2..HEAD_COUNT are continuity-only fixtures on a shift
+// register chain (boards/HeadChain.cpp): per head two 74HC595s hold the
+// OUTPUT_PINS levels in table order (bits 0-11) and an enable per XLR drive
+// (bits 12-15, 74HC125; disabled = released), and a 74HC165 reads the
+// SENSE_PINS in table order. So a chained head is driven with head 1's pin
+// numbers; the relay and resistance bits go nowhere.
+constexpr uint8_t HEAD_COUNT = CABLE_TESTER_HEADS;
+static_assert(HEAD_COUNT >= 1 && HEAD_COUNT <= 4, "CABLE_TESTER_HEADS is 1-4");
+
+#if CABLE_TESTER_HEADS > 1
+void headBegin();                                          // Chain pins; chained drives LOW, relays off
+void headWrite(uint8_t head, uint8_t pin, uint8_t level);
+void headMode(uint8_t head, uint8_t pin, uint8_t mode);   // XLR drives: OUTPUT, or INPUT to release
+uint8_t headLevel(uint8_t head, uint8_t pin);              // Output latch
+uint8_t headSense(uint8_t head);                           // SENSE_* snapshot
+void headXlrDrive(uint8_t head, uint8_t lines, uint8_t level);
+#endif
+
+#endif // CABLE_TESTER_BOARD_TRAITS_H
@@ -0,0 +1,2246 @@
+/*
+ * CableTester.cpp - Shared test engine, see CableTester.h
+ */
+
+#include "CableTester.h"
+
+#include <stddef.h>
+
+bool cmdIs(const char *cmd, const char *name) {
+  return strcmp(cmd, name) == 0;
+}
+
+// Trim and uppercase in place
+void normalizeCommand(char *cmd) {
+  char *start = cmd;
+  while (isspace(*start)) start++;
+  size_t len = strlen(start);
+  while (len > 0 && isspace(start[len - 1])) len--;
+  for (size_t i = 0; i < len; i++) cmd[i] = toupper(start[i]);
+  cmd[len] = '\0';
+}
+
+// ===== SETUP =====
+#if CABLE_TESTER_PROFILE
+PhaseProfile CableTester::profiles[TEST_KIND_COUNT][PH_COUNT];
+#endif
+
+bool CableTester::begin() {
+  // A chained head: head 1's headBegin() configured its outputs. There's
+  // no resistance circuit to calibrate and the display is the board's.
+  if (headNo > 1) {
+    resetCircuit();
+    systemReady = circuitCheck();
+    return systemReady;
+  }
+
+  // Relays, TS/XLR continuity drives, RES_TEST_OUT
+  for (uint8_t pin : OUTPUT_PINS) pinMode(pin, OUTPUT);
+  // Continuity senses; RES_SENSE is analog input by default
+  for (uint8_t pin : SENSE_PINS) pinMode(pin, INPUT);
+
+  boardBegin();
+#if CABLE_TESTER_HEADS > 1
+  headBegin();
+#endif
+#if CABLE_TESTER_PROFILE
+  memset(profiles, 0, sizeof(profiles));
+#endif
+
+  // All relays and test outputs OFF
+  resetCircuit();
+  showResult(SHOW_OFF);
+
+  supplyMv = readSupplyMv();
+  supplyLastPoll = millis();
+  loadCalibration();
+  currentConfig(savedConfig);
+  loadConfig();
+  loadStats();
+
+  systemReady = circuitCheck() && (bootFast || selfTest());
+  for (uint8_t h = 1; h < headCount && h < HEAD_COUNT; h++) heads[h]->begin();
+  return systemReady;
+}
+
+bool CableTester::attachHead(CableTester &other) {
+  if (headNo != 1 || headCount >= HEAD_COUNT || &other == this) return false;
+  other.headNo = ++headCount;
+  heads[headCount - 1] = &other;
+  return true;
+}
+
+// ===== HEAD I/O =====
+// Head 1 is the board's pins; the head chain only exists in multi-head
+// builds, so single-head builds compile to the plain calls
+void CableTester::pinWrite(uint8_t pin, uint8_t level) {
+  for (uint8_t i = 0; i < RELAY_COUNT; i++) {
+    if (OUTPUT_PINS[i] != pin) continue;
+    uint8_t bit = 1 << i;
+    if (level && !(relayLevels & bit)) countStat(stats.relays[i]);
+    relayLevels = level ? relayLevels | bit : relayLevels & ~bit;
+    break;
+  }
+#if CABLE_TESTER_HEADS > 1
+  if (headNo > 1) return headWrite(headNo, pin, level);
+#endif
+  digitalWrite(pin, level);
+}
+
+void CableTester::pinSetMode(uint8_t pin, uint8_t mode) {
+#if CABLE_TESTER_HEADS > 1
+  if (headNo > 1) return headMode(headNo, pin, mode);
+#endif
+  pinMode(pin, mode);
+}
+
+uint8_t CableTester::pinLevel(uint8_t pin) {
+#if CABLE_TESTER_HEADS > 1
+  if (headNo > 1) return headLevel(headNo, pin);
+#endif
+  return digitalRead(pin);
+}
+
+uint8_t CableTester::senseNow() {
+#if CABLE_TESTER_HEADS > 1
+  if (headNo > 1) return headSense(headNo);
+#endif
+  return readSense();
+}
+
+void CableTester::drive(uint8_t lines, uint8_t level) {
+#if CABLE_TESTER_HEADS > 1
+  if (headNo > 1) return headXlrDrive(headNo, lines, level);
+#endif
+  xlrDrive(lines, level);
+}
+
+// ===== CIRCUIT CHECK =====
+// Power-on check of this head's lines, about a millisecond, with or
+// without a cable in. Every output is LOW and the relays are at rest, so
+// a sense input reading HIGH is stuck or shorted to the supply, and
+// RES_SENSE at or below CAL_REJECT_THRESHOLD means current flows with
+// RES_TEST_OUT off. Each drive then goes HIGH on its own (an XLR drive
+// with the others floating, as in a test) and must read back HIGH: LOW is
+// a line shorted to ground. Only head 1's pins can be read back.
+constexpr unsigned int CHECK_SETTLE_US = 1000;
+
+static const char *const SENSE_LINES[] = {
+  "TS_CONT_IN_TIP", "TS_CONT_IN_SLEEVE",
+  "XLR_CONT_IN_PIN1", "XLR_CONT_IN_PIN2", "XLR_CONT_IN_PIN3", "XLR_CONT_IN_SHELL",
+};
+static const char *const XLR_DRIVE_LINES[] = {
+  "XLR_CONT_OUT_PIN1", "XLR_CONT_OUT_PIN2", "XLR_CONT_OUT_PIN3", "XLR_CONT_OUT_SHELL",
+};
+static const PinToggle TS_DRIVES[] = {
+  {NULL, TS_CONT_OUT_TIP, "TS_CONT_OUT_TIP"},
+  {NULL, TS_CONT_OUT_SLEEVE, "TS_CONT_OUT_SLEEVE"},
+  {NULL, RES_TEST_OUT, "RES_TEST_OUT"},
+};
+static_assert(sizeof(SENSE_LINES) / sizeof(SENSE_LINES[0]) == sizeof(SENSE_PINS) &&
+              sizeof(XLR_DRIVE_LINES) / sizeof(XLR_DRIVE_LINES[0]) == sizeof(XLR_DRIVE_PINS),
+              "circuit check names out of step with the pin tables");
+
+bool CableTester::circuitCheck() {
+  circuitFault = NULL;
+  delayMicroseconds(CHECK_SETTLE_US);
+  uint8_t stuck = senseNow();
+  for (uint8_t i = 0; i < sizeof(SENSE_PINS); i++) {
+    if (stuck & (1 << i)) circuitFault = SENSE_LINES[i];
+  }
+  if (!circuitFault && headNo == 1) {
+    if (readResSense() <= CAL_REJECT_THRESHOLD) circuitFault = "RES_SENSE";
+    for (const PinToggle &d : TS_DRIVES) {
+      if (circuitFault) break;
+      digitalWrite(d.pin, HIGH);
+      if (!digitalRead(d.pin)) circuitFault = d.label;
+      digitalWrite(d.pin, LOW);
+    }
+    // Float them all first: a drive going HIGH next to one still LOW
+    // would meet it through a shell bond
+    xlrDrive(0, LOW);
+    for (uint8_t i = 0; i < sizeof(XLR_DRIVE_PINS) && !circuitFault; i++) {
+      xlrDrive(1 << i, HIGH);
+      if (!digitalRead(XLR_DRIVE_PINS[i])) circuitFault = XLR_DRIVE_LINES[i];
+      xlrDrive(1 << i, LOW);
+    }
+    xlrDrive(XD_ALL, LOW);
+  }
+  return circuitFault == NULL;
+}
+
+void CableTester::poll() {
+  // Idle: look for a cable to test, or report FLEX dropouts
+  serviceAuto();
+  serviceFlex(FLEX_EDGES_PER_POLL);
+  // Advance the running test, if any
+  serviceTest();
+  // A chained head has no resistance circuit to calibrate or watch
+  if (headNo > 1) return;
+  // EEPROM writes block for a few ms each; keep them out of tests
+  if (calDirty && !job.active) saveCalibration();
+  if (!job.active) serviceConfig();
+  if (!job.active) serviceStats();
+  serviceSupply();
+  serviceDrift();
+  for (uint8_t h = 1; h < headCount && h < HEAD_COUNT; h++) heads[h]->poll();
+}
+
+void CableTester::replySend() {
+  sendReply(replyTag);
+}
+
+// ===== COMMAND HANDLER =====
+// Commands that only observe pin state and are safe mid-test
+bool CableTester::isReadOnlyCommand(const char *cmd) {
+  return cmdIs(cmd, "READ") || cmdIs(cmd, "PINS") || cmdIs(cmd, "HELP") || cmdIs(cmd, "MEM") ||
+         cmdIs(cmd, "CALINFO");
+}
+
+void CableTester::handleCommand(char *cmd) {
+  normalizeCommand(cmd);
+  if (routeToHead(cmd)) return;
+
+  bool fast = false;
+  uint8_t test = TEST_NONE;
+  if (cmd[0] != '#') test = parseTestCommand(cmd, fast);
+
+  if (cmd[0] == '#') {
+    handleBatch(cmd);
+
+  } else if (test != TEST_NONE) {
+    // XC/XS/XR debug aliases skip the ready check
+    if (!systemReady && cmdIs(cmd, TEST_DEFS[test].cmd)) {
+      replyBegin("ERROR:NOT_READY");
+      replySend();
+      return;
+    }
+    if (isFlexRunning()) {
+      replyBegin("ERROR:BUSY:");
+      replyAdd(cmd);
+      replySend();
+      return;
+    }
+    if (headNo > 1 && TEST_DEFS[test].resistance) {
+      replyBegin("ERROR:NOT_ON_HEAD:");
+      replyAdd(cmd);
+      replySend();
+      return;
+    }
+    queueTest(test, fast);
+
+  } else if (cmdIs(cmd, "CANCEL")) {
+    cancelTests();
+    replyBegin("OK:CANCEL");
+    replySend();
+
+  } else if (cmdIs(cmd, "STATUS")) {
+    hostSeen();
+    sendStatus();
+
+  } else if (cmdIs(cmd, "ID")) {
+    hostSeen();
+    replyBegin("ID:");
+    replyAdd(TESTER_ID);
+    if (headCount > 1) replyField("HEADS", headCount);
+    replySend();
+
+  } else if (cmdIs(cmd, "CALINFO")) {
+    sendCalInfo();
+
+#if CABLE_TESTER_PROFILE
+  } else if (cmdIs(cmd, "PROFILE") || strncmp(cmd, "PROFILE ", 8) == 0) {
+    sendProfile(cmd[7] == ' ' ? cmd + 8 : NULL);
+#endif
+
+  } else if (cmdIs(cmd, "STATS") || strncmp(cmd, "STATS ", 6) == 0) {
+    handleStats(cmd[5] == ' ' ? cmd + 6 : NULL);
+
+  } else if (cmdIs(cmd, "RESET")) {
+    cancelTests();
+    replyBegin("OK:RESET");
+    replySend();
+
+  } else if (isTestRunning() && !isReadOnlyCommand(cmd)) {
+    // Debug commands drive pins directly; don't let them fight a test
+    replyBegin("ERROR:BUSY:");
+    replyAdd(cmd);
+    replySend();
+
+  } else if (cmdIs(cmd, "FLEX") || cmdIs(cmd, "FLEX TS") || cmdIs(cmd, "FLEX XLR") || cmdIs(cmd, "FLEX OFF")) {
+    // The FLEX sampler reads the board's own pins
+    if (headNo > 1 && (cmdIs(cmd, "FLEX TS") || cmdIs(cmd, "FLEX XLR"))) {
+      replyBegin("ERROR:NOT_ON_HEAD:");
+      replyAdd(cmd);
+      replySend();
+      return;
+    }
+    if (cmdIs(cmd, "FLEX OFF") && isFlexRunning()) {
+      stopFlex();
+      return;
+    }
+    if (cmdIs(cmd, "FLEX TS")) startFlex(SENSE_TS_TIP | SENSE_TS_SLEEVE);
+    if (cmdIs(cmd, "FLEX XLR")) startFlex(SENSE_XLR_PIN1 | SENSE_XLR_PIN2 | SENSE_XLR_PIN3 | SENSE_XLR_SHELL);
+    sendFlexStatus(!isFlexRunning() ? "OFF" : flexLines & SENSE_TS_TIP ? "TS" : "XLR");
+
+  } else if (isFlexRunning() && !isReadOnlyCommand(cmd)) {
+    // FLEX holds the drives on until FLEX OFF
+    replyBegin("ERROR:BUSY:");
+    replyAdd(cmd);
+    replySend();
+
+  } else if (headNo == 1 && boardCommand(cmd)) {
+    // Handled by the sketch
+
+  } else if (cmdIs(cmd, "SETTLE") || cmdIs(cmd, "SETTLE ADAPTIVE") || cmdIs(cmd, "SETTLE FIXED")) {
+    if (!cmdIs(cmd, "SETTLE")) adaptiveSettle = cmdIs(cmd, "SETTLE ADAPTIVE");
+    replyBegin("SETTLE:");
+    replyAdd(adaptiveSettle ? "ADAPTIVE" : "FIXED");
+    replySend();
+
+  } else if (cmdIs(cmd, "FAST") || cmdIs(cmd, "FAST ON") || cmdIs(cmd, "FAST OFF")) {
+    if (!cmdIs(cmd, "FAST")) fastMode = cmdIs(cmd, "FAST ON");
+    replyBegin("FAST:");
+    replyAdd(fastMode ? "ON" : "OFF");
+    replySend();
+
+  } else if (cmdIs(cmd, "BURST") || cmdIs(cmd, "BURST ON") || cmdIs(cmd, "BURST OFF")) {
+    if (!cmdIs(cmd, "BURST")) burstMode = cmdIs(cmd, "BURST ON");
+    replyBegin("BURST:");
+    replyAdd(burstMode ? "ON" : "OFF");
+    replySend();
+
+  } else if (cmdIs(cmd, "RESSTAT") || cmdIs(cmd, "RESSTAT ON") || cmdIs(cmd, "RESSTAT OFF")) {
+    if (!cmdIs(cmd, "RESSTAT")) resStats = cmdIs(cmd, "RESSTAT ON");
+    replyBegin("RESSTAT:");
+    replyAdd(resStats ? "ON" : "OFF");
+    replySend();
+
+  } else if (cmdIs(cmd, "OVERSAMPLE") || strncmp(cmd, "OVERSAMPLE ", 11) == 0) {
+    if (cmd[10] == ' ') {
+      const char *arg = cmd + 11;
+      if (cmdIs(arg, "OFF")) {
+        overBits = 0;
+      } else if (arg[0] >= '1' && arg[0] <= '0' + OVERSAMPLE_MAX_BITS && arg[1] == '\0') {
+        overBits = arg[0] - '0';
+      } else {
+        replyBegin("ERROR:OVERSAMPLE:");
+        replyAdd(arg);
+        replySend();
+        return;
+      }
+    }
+    replyBegin("OVERSAMPLE:");
+    if (overBits) replyUInt(overBits);
+    else replyAdd("OFF");
+    replySend();
+
+  } else if (cmdIs(cmd, "BOOT") || cmdIs(cmd, "BOOT FAST") || cmdIs(cmd, "BOOT FULL")) {
+    if (!cmdIs(cmd, "BOOT")) bootFast = cmdIs(cmd, "BOOT FAST");
+    replyBegin("BOOT:");
+    replyAdd(bootFast ? "FAST" : "FULL");
+    replySend();
+
+  } else if (cmdIs(cmd, "AUTO") || strncmp(cmd, "AUTO ", 5) == 0) {
+    if (cmd[4] == ' ') {
+      uint8_t kind = parseTestCommand(cmd + 5, fast);
+      if (cmdIs(cmd + 5, "OFF")) {
+        setAuto(TEST_NONE);
+      } else if (kind == TEST_NONE || kind == TEST_CAL || kind == TEST_XCAL ||
+                 (headNo > 1 && TEST_DEFS[kind].resistance)) {
+        replyBegin("ERROR:AUTO:");
+        replyAdd(cmd + 5);
+        replySend();
+        return;
+      } else {
+        autoFast = fast;
+        setAuto(kind);
+      }
+    }
+    replyBegin("AUTO:");
+    replyAdd(autoTest == TEST_NONE ? "OFF" : TEST_DEFS[autoTest].cmd);
+    if (autoTest != TEST_NONE && autoFast) replyAdd(" FAST");
+    replySend();
+
+  } else if (!handleToggle(cmd)) {
+    replyBegin("ERROR:UNKNOWN_CMD:");
+    replyAdd(cmd);
+    replySend();
+  }
+}
+
+// "H<n>:<cmd>", from head 1 outside a batch: head n handles cmd. False if
+// cmd isn't addressed to a head.
+bool CableTester::routeToHead(char *cmd) {
+  if (cmd[0] != 'H' || !isdigit(cmd[1]) || cmd[2] != ':') return false;
+  uint8_t n = cmd[1] - '0';
+  if (headNo != 1 || replyTag || n < 1 || n > headCount) {
+    replyBegin("ERROR:BAD_HEAD:");
+    replyAdd(cmd);
+    replySend();
+  } else {
+    heads[n - 1]->handleCommand(cmd + 3);
+  }
+  return true;
+}
+
+// Debug toggles (K12, TSTIP, ...): flip the pin, answer DEBUG:<label>:HIGH|LOW
+bool CableTester::handleToggle(const char *cmd) {
+  for (uint8_t i = 0; i < NUM_BOARD_TOGGLES; i++) {
+    const PinToggle &t = BOARD_TOGGLES[i];
+    if (!cmdIs(cmd, t.cmd)) continue;
+    bool state = !pinLevel(t.pin);
+    pinWrite(t.pin, state);
+    replyBegin("DEBUG:");
+    replyAdd(t.label);
+    replyChar(':');
+    replyAdd(state ? "HIGH" : "LOW");
+    replySend();
+    return true;
+  }
+  return false;
+}
+
+static const char *const DRIFT_PATHS[] = {"TS", "P2", "P3"};
+
+// :DRIFT:<path>:<mohm> names the baseline that has moved furthest, once
+// past CAL_DRIFT_WARN_MOHM (time to CAL/XCAL again)
+void CableTester::sendStatus() {
+  replyBegin("STATUS:");
+  replyAdd(systemReady ? "READY" : "NOT_READY");
+  if (circuitFault) {
+    replyAdd(":FAULT:");
+    replyAdd(circuitFault);
+  }
+  if (isTestRunning()) replyAdd(":BUSY");
+
+  const char *worstPath = NULL;
+  long worst = 0;
+  const Baseline *bases[] = {&tsBase, &p2Base, &p3Base};
+  for (uint8_t i = 0; i < 3; i++) {
+    if (i == 0 ? !isCalibrated : !isXlrCalibrated) continue;
+    long drift = baselineDrift(*bases[i]);
+    if (labs(drift) > CAL_DRIFT_WARN_MOHM && labs(drift) > labs(worst)) {
+      worst = drift;
+      worstPath = DRIFT_PATHS[i];
+    }
+  }
+  if (worstPath) {
+    replyAdd(":DRIFT:");
+    replyAdd(worstPath);
+    replyChar(':');
+    replyInt(worst);
+  }
+  replySend();
+}
+
+// ===== BATCHES =====
+// "#<tag> <cmd>;<cmd>...": run each command with its replies tagged, then
+// send the batch's END once its last test has answered
+void CableTester::handleBatch(char *line) {
+  char *p = line + 1;
+  long tag = 0;
+  while (isdigit(*p) && tag < TAG_AUTO) tag = tag * 10 + (*p++ - '0');
+  if (p == line + 1 || tag < 1 || tag >= TAG_AUTO || (*p != ' ' && *p != '\0')) {
+    replyBegin("ERROR:BAD_BATCH:");
+    replyAdd(line);
+    replySend();
+    return;
+  }
+
+  replyTag = tag;
+  char *entry = p;
+  while (entry != NULL) {
+    char *next = strchr(entry, ';');
+    if (next != NULL) *next++ = '\0';
+    normalizeCommand(entry);
+    if (entry[0] == '#') {
+      replyBegin("ERROR:BAD_BATCH:");
+      replyAdd(entry);
+      replySend();
+    } else if (entry[0] != '\0') {
+      handleCommand(entry);
+    }
+    entry = next;
+  }
+
+  replyTag = 0;
+  if (isBatchPending(tag)) {
+    // queueTest() left a slot for this
+    testQueue[(testQueueHead + testQueueCount) % TEST_QUEUE_SIZE] = {TEST_NONE, (uint16_t)tag, false};
+    testQueueCount++;
+  } else {
+    sendBatchEnd(tag);
+  }
+}
+
+// A test from this batch is running or queued
+bool CableTester::isBatchPending(uint16_t tag) {
+  if (job.active && job.tag == tag) return true;
+  for (uint8_t i = 0; i < testQueueCount; i++) {
+    const QueuedTest &q = testQueue[(testQueueHead + i) % TEST_QUEUE_SIZE];
+    if (q.kind != TEST_NONE && q.tag == tag) return true;
+  }
+  return false;
+}
+
+void CableTester::sendBatchEnd(uint16_t tag) {
+  replyBegin("END");
+  sendReply(tag);
+}
+
+// ===== AUTO MODE =====
+bool CableTester::isXlrTest(uint8_t kind) {
+  return kind == TEST_XCONT || kind == TEST_XSHELL || kind == TEST_XRES ||
+         kind == TEST_XFULL || kind == TEST_XFULL_SHELL;
+}
+
+// Arm (or, with TEST_NONE, stop) AUTO mode. A cable already in place
+// counts as inserted once the probes agree.
+void CableTester::setAuto(uint8_t kind) {
+  autoTest = kind;
+  autoPresent = false;
+  autoCount = 0;
+  if (!job.active) resetCircuit();
+}
+
+// Short pulse on the drives, read back on the senses: true if a cable joins any
+bool CableTester::isCableInserted() {
+  bool present = true;
+  if (isXlrTest(autoTest) || autoTest == TEST_BOTH) {
+    drive(XD_PIN1 | XD_PIN2 | XD_PIN3, HIGH);
+    delayMicroseconds(AUTO_PROBE_US);
+    present = senseNow() & (SENSE_XLR_PIN1 | SENSE_XLR_PIN2 | SENSE_XLR_PIN3);
+    drive(XD_ALL, LOW);
+  }
+  // BOTH waits for the TS cable too
+  if (!isXlrTest(autoTest) && present) {
+    pinWrite(TS_CONT_OUT_TIP, HIGH);
+    pinWrite(TS_CONT_OUT_SLEEVE, HIGH);
+    delayMicroseconds(AUTO_PROBE_US);
+    present = senseNow() & (SENSE_TS_TIP | SENSE_TS_SLEEVE);
+    pinWrite(TS_CONT_OUT_TIP, LOW);
+    pinWrite(TS_CONT_OUT_SLEEVE, LOW);
+  }
+  return present;
+}
+
+void CableTester::cableChanged(bool present) {
+  replyBegin(present ? "INSERTED" : "REMOVED");
+  sendEvent();
+}
+
+// One AUTO poll, only while nothing else is running
+void CableTester::serviceAuto() {
+  if (autoTest == TEST_NONE || !systemReady || job.active || testQueueCount > 0 || isFlexRunning()) return;
+  if (millis() - autoLastPoll < AUTO_POLL_MS) return;
+  autoLastPoll = millis();
+
+  // TS continuity needs K1+K2 up; park it and probe from the next poll
+  if (!isXlrTest(autoTest) && !pinLevel(K1_K2_RELAY)) {
+    pinWrite(K1_K2_RELAY, HIGH);
+    return;
+  }
+
+  if (isCableInserted() == autoPresent) {
+    autoCount = 0;
+    return;
+  }
+  if (++autoCount < AUTO_DEBOUNCE) return;
+  autoCount = 0;
+  autoPresent = !autoPresent;
+
+  cableChanged(autoPresent);
+  if (autoPresent) {
+    countStat(stats.inserts);
+    startTest(autoTest, TAG_AUTO, autoFast);
+  }
+}
+
+// ===== FLEX MODE =====
+// FLEX TS / FLEX XLR drive one connector's lines HIGH and leave them on.
+// A dropout is a watched sense line going LOW after it was HIGH; when it
+// comes back it's reported as EVENT:FLEX:DROP:<line>:AT:<ms>:US:<us>
+// (ms since FLEX started, duration to FLEX_SAMPLE_US). A line that stays
+// LOW is listed under :OPEN: in the status line instead.
+static const char *const SENSE_NAMES[] = {"TIP", "SLEEVE", "P1", "P2", "P3", "SHELL"};
+static_assert(sizeof(SENSE_NAMES) / sizeof(SENSE_NAMES[0]) == sizeof(SENSE_PINS), "one name per SENSE_* line");
+static_assert(1000 % FLEX_SAMPLE_US == 0, "FLEX timestamps are whole ticks per ms");
+
+constexpr uint32_t FLEX_TICKS_PER_MS = 1000 / FLEX_SAMPLE_US;
+
+void CableTester::startFlex(uint8_t lines) {
+  if (isFlexRunning()) flexStop();
+  resetCircuit();
+  if (lines & SENSE_TS_TIP) {
+    pinWrite(K1_K2_RELAY, HIGH);   // Continuity
+    pinWrite(TS_CONT_OUT_TIP, HIGH);
+    pinWrite(TS_CONT_OUT_SLEEVE, HIGH);
+  } else {
+    // Pins 1-3 from high-Z, K5/K6 on continuity. The far shell sense sees
+    // pin 1 through the far bond; driving the shell as well would fight
+    // pin 1 through the near bond while the drives change.
+    drive(0, LOW);
+    drive(XD_PIN1 | XD_PIN2 | XD_PIN3, HIGH);
+  }
+  flexLines = lines;
+  flexLevel = 0;
+  flexDropping = 0;
+  memset(flexDrops, 0, sizeof(flexDrops));
+  flexLongest = 0;
+  flexStart();
+}
+
+// FLEX OFF: report what's still queued, then the session's totals
+void CableTester::stopFlex() {
+  serviceFlex(255);
+  sendFlexStatus("OFF");
+  flexStop();
+  flexLines = 0;
+  restoreDrivePins();
+  resetCircuit();
+}
+
+// Up to maxEdges sense changes, oldest first
+void CableTester::serviceFlex(uint8_t maxEdges) {
+  if (!isFlexRunning()) return;
+  FlexEdge edge;
+  for (uint8_t n = 0; n < maxEdges && flexNext(edge); n++) {
+    uint8_t changed = (edge.sense ^ flexLevel) & flexLines;
+    flexLevel = edge.sense;
+    if (edge.tick < RELAY_SETTLE_MS * FLEX_TICKS_PER_MS) {
+      flexDropping = 0;
+      continue;
+    }
+    for (uint8_t i = 0; i < sizeof(SENSE_PINS); i++) {
+      uint8_t bit = 1 << i;
+      if (!(changed & bit)) continue;
+      if (!(edge.sense & bit)) {
+        flexDropTick[i] = edge.tick;
+        flexDropping |= bit;
+      } else if (flexDropping & bit) {
+        flexDropping &= ~bit;
+        flexDropout(i, flexDropTick[i], edge.tick - flexDropTick[i]);
+      }
+    }
+  }
+}
+
+void CableTester::flexDropout(uint8_t line, uint32_t startTick, uint32_t ticks) {
+  if (flexDrops[line] < 0xFFFF) flexDrops[line]++;
+  if (ticks > flexLongest) flexLongest = ticks;
+  replyBegin("FLEX:DROP:");
+  replyAdd(SENSE_NAMES[line]);
+  replyField("AT", startTick / FLEX_TICKS_PER_MS);
+  replyField("US", ticks * FLEX_SAMPLE_US);
+  sendReply(TAG_AUTO);
+}
+
+// FLEX:<state>[:MS:<ms>:<line>:<drops>...:LONGEST:<us>:LOST:<n>[:OPEN:<lines>]]
+// while running, and once more with FLEX OFF
+void CableTester::sendFlexStatus(const char *state) {
+  replyBegin("FLEX:");
+  replyAdd(state);
+  if (isFlexRunning()) {
+    replyField("MS", flexTicks() / FLEX_TICKS_PER_MS);
+    for (uint8_t i = 0; i < sizeof(SENSE_PINS); i++) {
+      if (flexLines & (1 << i)) replyField(SENSE_NAMES[i], flexDrops[i]);
+    }
+    replyField("LONGEST", flexLongest * FLEX_SAMPLE_US);
+    replyField("LOST", flexLost());
+    uint8_t open = flexLines & ~flexLevel;
+    for (uint8_t i = 0; i < sizeof(SENSE_PINS); i++) {
+      if (!(open & (1 << i))) continue;
+      replyAdd(open & ((1 << i) - 1) ? "," : ":OPEN:");
+      replyAdd(SENSE_NAMES[i]);
+    }
+  }
+  replySend();
+}
+
+// ===== TEST STEP SCHEDULER =====
+// Map a command (or debug alias) to its test, or TEST_NONE
+uint8_t CableTester::testKindForCommand(const char *cmd) {
+  for (int i = 0; i < NUM_TESTS; i++) {
+    if (cmdIs(cmd, TEST_DEFS[i].cmd)) return i;
+    if (TEST_DEFS[i].alias && cmdIs(cmd, TEST_DEFS[i].alias)) return i;
+  }
+  return TEST_NONE;
+}
+
+// A test command, optionally "<test> FAST" (the suffix is cut off in place)
+uint8_t CableTester::parseTestCommand(char *cmd, bool &fast) {
+  fast = false;
+  uint8_t kind = testKindForCommand(cmd);
+  size_t len = strlen(cmd);
+  if (kind != TEST_NONE || len < 6 || !cmdIs(cmd + len - 5, " FAST")) return kind;
+  cmd[len - 5] = '\0';
+  kind = testKindForCommand(cmd);
+  if (kind == TEST_NONE) cmd[len - 5] = ' ';
+  else fast = true;
+  return kind;
+}
+
+// Run now if idle, otherwise queue behind the running test
+// Tests from a batch (replyTag set) keep one slot free for its end marker
+void CableTester::queueTest(uint8_t kind, bool fast) {
+  if (!job.active) {
+    startTest(kind, replyTag, fast);
+    return;
+  }
+  if (testQueueCount >= TEST_QUEUE_SIZE - (replyTag ? 1 : 0)) {
+    replyBegin("ERROR:QUEUE_FULL:");
+    replyAdd(TEST_DEFS[kind].cmd);
+    replySend();
+    return;
+  }
+  testQueue[(testQueueHead + testQueueCount) % TEST_QUEUE_SIZE] = {kind, replyTag, fast};
+  testQueueCount++;
+}
+
+void CableTester::startTest(uint8_t kind, uint16_t tag, bool fast) {
+  memset(&job, 0, sizeof(job));
+  job.active = true;
+  job.kind = kind;
+  job.tag = tag;
+  job.binary = binaryResults;
+  job.fast = fast || fastMode;
+  job.overBits = overBits;
+  job.program = TEST_DEFS[kind].program;
+
+  testStarted(kind, tag);
+  job.startUs = job.phaseMark = micros();
+  serviceTest();
+}
+
+// Abort the running test (and anything queued), leaving the circuit safe
+// Batches cut short still get their END.
+void CableTester::cancelTests() {
+  if (job.active) {
+    job.active = false;
+    replyBegin("ERROR:CANCELLED:");
+    replyAdd(TEST_DEFS[job.kind].cmd);
+    sendReply(job.tag);
+  }
+  for (uint8_t i = 0; i < testQueueCount; i++) {
+    const QueuedTest &q = testQueue[(testQueueHead + i) % TEST_QUEUE_SIZE];
+    if (q.kind == TEST_NONE) sendBatchEnd(q.tag);
+  }
+  testQueueCount = 0;
+  adcStop();
+  if (isFlexRunning()) {
+    flexStop();
+    flexLines = 0;
+  }
+  restoreDrivePins();
+  resetCircuit();
+  showResult(SHOW_OFF);
+}
+
+void CableTester::startWait(unsigned long us) {
+  job.waiting = true;
+  job.waitStart = micros();
+  job.waitUs = us;
+}
+
+// Advance the running test as far as it can go without waiting
+void CableTester::serviceTest() {
+  while (job.active) {
+    if (job.waiting) {
+      if (micros() - job.waitStart < job.waitUs) return;
+      job.waiting = false;
+      if (!job.settling) profilePhase(PH_SWITCH);  // OP_WAIT; a settle is billed when it ends
+    }
+
+    const TestStep* seg = job.program[job.seg];
+    TestStep step;
+    memcpy_P(&step, &seg[job.idx], sizeof(TestStep));
+    if (step.op != OP_READ) job.snapValid = false;
+
+    switch (step.op) {
+      case OP_END:
+        profilePhase(PH_SWITCH);
+        job.seg++;
+        job.idx = 0;
+        if (job.program[job.seg] == NULL) {
+          finishTest();
+        }
+        continue;
+
+      case OP_WRITE:
+        pinWrite(step.pin, step.val);
+        break;
+
+      case OP_MODE:
+        pinSetMode(step.pin, step.val);
+        break;
+
+      case OP_WAIT:
+        job.idx++;
+        startWait((unsigned long)step.arg * 1000UL);
+        continue;
+
+      case OP_SETTLE:
+        if (!serviceSettle(step)) continue;  // Still polling
+        break;
+
+      case OP_READ:
+        // One snapshot per READ group: all sense bits from the same instant
+        if (!job.snapValid) {
+          job.snap = senseNow();
+          job.snapValid = true;
+        }
+        if (job.snap & step.pin) job.bits |= (1UL << step.val);
+        break;
+
+      case OP_XDRIVE:
+        drive(step.pin, step.val);
+        break;
+
+      case OP_ADC: {
+        // Start the burst, then stay on this step until it has all samples.
+        // A borderline reading takes more bursts (readingBorderline()).
+        if (!job.adcStarted) {
+          uint16_t count = step.val && burstMode ? RES_BURST_SAMPLES : step.arg;
+          if (step.val && count < (1u << 2 * job.overBits)) count = 1u << 2 * job.overBits;
+          adcStart(count);
+          job.adcStarted = true;
+        }
+        if (adcBusy()) return;
+        AdcBurst burst;
+        adcResult(burst);
+        AdcBurst &r = job.reading[job.adcCount];
+        if (r.count == 0 || burst.min < r.min) r.min = burst.min;
+        if (r.count == 0 || burst.max > r.max) r.max = burst.max;
+        r.count += burst.count;
+        r.sum += burst.sum;
+        r.sumSq += burst.sumSq;
+        r.outliers += burst.outliers;
+        if (step.val && r.count + burst.count <= RES_MAX_SAMPLES && readingBorderline(job.adcCount)) {
+          adcStart(burst.count);
+          return;
+        }
+        job.adc[job.adcCount] = r.sum / r.count;
+        job.fine[job.adcCount++] = ((uint64_t)r.sum << job.overBits) / r.count;
+        job.adcStarted = false;
+        break;
+      }
+
+      case OP_RESET:
+        resetCircuit();
+        break;
+
+      case OP_CHECK:
+        if (job.fast && checkFailed(step.arg)) {
+          stopTest();
+          continue;
+        }
+        break;
+    }
+    profilePhase(step.op == OP_SETTLE ? PH_SETTLE :
+                 step.op == OP_READ || step.op == OP_ADC ? PH_SAMPLE : PH_SWITCH);
+    job.idx++;
+  }
+}
+
+// Program complete: evaluate, show the result, send the response, start the next
+void CableTester::finishTest() {
+  job.active = false;
+  TestResults cont;
+  XlrContResults xcont;
+  XlrShellResults shell;
+  uint8_t flags = evaluateTest(cont, xcont, shell);
+  countStat(flags & RF_PASS ? stats.pass[job.kind] : stats.fail[job.kind]);
+  profilePhase(PH_EVAL);
+  if (job.binary) {
+    uint8_t record[BIN_MAX_RECORD];
+    uint8_t len = packTestResult(flags, record);
+    profilePhase(PH_FORMAT);
+    if (job.tag) {
+      replyBegin("BIN");
+      sendReply(job.tag);
+    }
+    sendRecord(job.tag, record, len);
+  } else {
+    buildTestResponse(flags, cont, xcont, shell);
+    profilePhase(PH_FORMAT);
+    sendReply(job.tag);
+  }
+  profilePhase(PH_SEND);
+  recordProfile();
+
+  while (testQueueCount > 0) {
+    QueuedTest next = testQueue[testQueueHead];
+    testQueueHead = (testQueueHead + 1) % TEST_QUEUE_SIZE;
+    testQueueCount--;
+    if (next.kind != TEST_NONE) {
+      startTest(next.kind, next.tag, next.fast);
+      return;
+    }
+    sendBatchEnd(next.tag);
+  }
+}
+
+// ===== FAST MODE =====
+// True if the readings behind `checks` already fail the test
+bool CableTester::checkFailed(uint16_t checks) {
+  if ((checks & CK_TIP) && (!jobBit(BIT_TT) || jobBit(BIT_TS))) return true;
+  if ((checks & CK_SLEEVE) && (!jobBit(BIT_SS) || jobBit(BIT_ST))) return true;
+  if ((checks & CK_RES) && !resPassCheck(job.fine[0], job.overBits, isCalibrated, tsBase)) return true;
+  for (uint8_t d = 0; d < 3; d++) {
+    if (!(checks & (CK_P1 << d))) continue;
+    for (uint8_t s = 0; s < 3; s++) {
+      if (jobBit(BIT_XP(d, s)) != (d == s)) return true;
+    }
+  }
+  if ((checks & CK_FAR) && !jobBit(BIT_FAR)) return true;
+  if ((checks & CK_NEAR) && (!jobBit(BIT_NEAR) || jobBit(BIT_SH_P2) || jobBit(BIT_SH_P3))) return true;
+  if ((checks & CK_P2RES) && !resPassCheck(job.fine[0], job.overBits, isXlrCalibrated, p2Base)) return true;
+  if ((checks & CK_P3RES) && !resPassCheck(job.fine[1], job.overBits, isXlrCalibrated, p3Base)) return true;
+  return false;
+}
+
+// A check failed in FAST mode: note every check still ahead as skipped
+// and go straight to the program's last segment (SEG_RESET)
+void CableTester::stopTest() {
+  restoreDrivePins();
+  uint8_t idx = job.idx + 1;
+  for (; job.program[job.seg + 1] != NULL; job.seg++, idx = 0) {
+    const TestStep* seg = job.program[job.seg];
+    for (;; idx++) {
+      TestStep step;
+      memcpy_P(&step, &seg[idx], sizeof(TestStep));
+      if (step.op == OP_END) break;
+      if (step.op == OP_CHECK) job.skipped |= step.arg;
+    }
+  }
+  job.idx = 0;
+}
+
+// Some of `checks` were skipped and the rest passed
+bool CableTester::checksUndecided(uint16_t checks) {
+  return (job.skipped & checks) && !checkFailed(checks & ~job.skipped);
+}
+
+// ":SKIP:<check>,..." for the skipped checks among `checks`
+void CableTester::formatSkipped(uint16_t checks) {
+  static const char *const CHECK_NAMES[] = {
+    "TIP", "SLEEVE", "RES", "P1", "P2", "P3", "FAR", "NEAR", "P2", "P3"
+  };
+  checks &= job.skipped;
+  if (checks == 0) return;
+  replyAdd(":SKIP:");
+  uint16_t items = replyLen;
+  for (uint8_t i = 0; i < 10; i++) {
+    if (checks & (1 << i)) replyItem(items, CHECK_NAMES[i]);
+  }
+}
+
+// ===== PROFILING =====
+// Bill the time since the last mark to a phase of the running test. Waits
+// and polling steps are billed when they complete, so time the loop spends
+// elsewhere meanwhile counts towards the step it held up.
+void CableTester::profilePhase(uint8_t phase) {
+#if CABLE_TESTER_PROFILE
+  unsigned long now = micros();
+  job.phaseUs[phase] += now - job.phaseMark;
+  job.phaseMark = now;
+#endif
+}
+
+// Add the finished job's phase times to its command's profile
+void CableTester::recordProfile() {
+#if CABLE_TESTER_PROFILE
+  job.phaseUs[PH_TOTAL] = job.phaseMark - job.startUs;
+  for (uint8_t i = 0; i < PH_COUNT; i++) {
+    PhaseProfile &p = profiles[job.kind][i];
+    uint32_t us = job.phaseUs[i];
+    if (p.count == 0 || us < p.minUs) p.minUs = us;
+    if (us > p.maxUs) p.maxUs = us;
+    if (p.count < 0xFFFF) p.count++;
+    uint8_t bin = profileBin(us);
+    if (p.bins[bin] == 0xFF) {
+      for (uint8_t b = 0; b < PROFILE_BINS; b++) p.bins[b] >>= 1;
+    }
+    p.bins[bin]++;
+  }
+#endif
+}
+
+#if CABLE_TESTER_PROFILE
+uint8_t CableTester::profileBin(uint32_t us) {
+  uint8_t bin = 0;
+  us >>= 4;
+  while (us > 0 && bin < PROFILE_BINS - 1) {
+    us >>= 1;
+    bin++;
+  }
+  return bin;
+}
+
+// Estimated percentile: interpolated across its bin (narrowed to min..max)
+uint32_t CableTester::profilePercentile(const PhaseProfile &p, uint8_t percent) {
+  uint16_t total = 0;
+  for (uint8_t b = 0; b < PROFILE_BINS; b++) total += p.bins[b];
+  if (total == 0) return 0;
+
+  uint16_t rank = ((uint32_t)total * percent + 99) / 100;
+  uint16_t below = 0;
+  uint8_t b = 0;
+  while (below + p.bins[b] < rank) below += p.bins[b++];
+
+  uint32_t lo = b == 0 ? 0 : 1UL << (b + 3);
+  uint32_t hi = b == PROFILE_BINS - 1 ? p.maxUs : 1UL << (b + 4);
+  if (lo < p.minUs) lo = p.minUs;
+  if (hi > p.maxUs) hi = p.maxUs;
+  if (hi <= lo) return lo;
+  return lo + (hi - lo) * (rank - below) / p.bins[b];
+}
+
+// "<min>/<p50>/<p99>/<max>" in us
+void CableTester::formatProfile(const PhaseProfile &p) {
+  replyUInt(p.minUs);
+  replyChar('/');
+  replyUInt(profilePercentile(p, 50));
+  replyChar('/');
+  replyUInt(profilePercentile(p, 99));
+  replyChar('/');
+  replyUInt(p.maxUs);
+}
+
+// PROFILE: total time of every command run since PROFILE RESET
+//   PROFILE:CONT:120:8100/8200/9100/9800:RES:40:...   (<cmd>:<count>:<min>/<p50>/<p99>/<max>)
+// PROFILE <cmd>: that command's phases, same figures
+//   PROFILE:CONT:N:120:SWITCH:...:SETTLE:...:SAMPLE:...:EVAL:...:FORMAT:...:SEND:...:TOTAL:...
+// PROFILE RESET: clear them all
+void CableTester::sendProfile(const char *arg) {
+  static const char *const PHASE_NAMES[PH_COUNT] = {
+    "SWITCH", "SETTLE", "SAMPLE", "EVAL", "FORMAT", "SEND", "TOTAL"
+  };
+
+  if (arg == NULL) {
+    replyBegin("PROFILE");
+    for (uint8_t k = 0; k < TEST_KIND_COUNT; k++) {
+      const PhaseProfile &total = profiles[k][PH_TOTAL];
+      if (total.count == 0) continue;
+      replyField(TEST_DEFS[k].cmd, total.count);
+      replyChar(':');
+      formatProfile(total);
+    }
+    replySend();
+    return;
+  }
+
+  if (cmdIs(arg, "RESET")) {
+    memset(profiles, 0, sizeof(profiles));
+    replyBegin("PROFILE:RESET");
+    replySend();
+    return;
+  }
+
+  uint8_t kind = testKindForCommand(arg);
+  if (kind == TEST_NONE) {
+    replyBegin("ERROR:PROFILE:");
+    replyAdd(arg);
+    replySend();
+    return;
+  }
+  replyBegin("PROFILE:");
+  replyAdd(TEST_DEFS[kind].cmd);
+  replyField("N", profiles[kind][PH_TOTAL].count);
+  if (profiles[kind][PH_TOTAL].count > 0) {
+    for (uint8_t i = 0; i < PH_COUNT; i++) {
+      replyChar(':');
+      replyAdd(PHASE_NAMES[i]);
+      replyChar(':');
+      formatProfile(profiles[kind][i]);
+    }
+  }
+  replySend();
+}
+#endif // CABLE_TESTER_PROFILE
+
+// ===== ADAPTIVE SETTLE =====
+// Find the inputs an OP_SETTLE watches: RES_SENSE for a STEP_RES_DRAIN,
+// else the next group of OP_READ steps, or RES_SENSE if an OP_ADC comes
+// first. None = nothing to wait for.
+void CableTester::findSettleSense() {
+  const TestStep* seg = job.program[job.seg];
+  TestStep step;
+  memcpy_P(&step, &seg[job.idx], sizeof(TestStep));
+  job.senseMask = 0;
+  job.senseAnalog = step.pin == RES_SENSE;
+  if (job.senseAnalog) return;
+  for (uint8_t i = job.idx + 1; ; i++) {
+    TestStep next;
+    memcpy_P(&next, &seg[i], sizeof(TestStep));
+    if (next.op == OP_END) return;
+    if (next.op == OP_ADC) {
+      if (job.senseMask == 0) job.senseAnalog = true;
+      return;
+    }
+    if (next.op == OP_READ) {
+      job.senseMask |= next.pin;
+    } else if (job.senseMask != 0) {
+      return;  // End of the READ group
+    }
+  }
+}
+
+int CableTester::readSettleSense() {
+  if (job.senseAnalog) return analogRead(RES_SENSE);
+  return senseNow() & job.senseMask;
+}
+
+// One poll of an OP_SETTLE step. Returns true once settled (or timed out);
+// otherwise schedules the next poll and returns false.
+bool CableTester::serviceSettle(const TestStep &step) {
+  unsigned long now = micros();
+  unsigned long timeoutUs = (unsigned long)step.arg * 1000UL;
+
+  if (!job.settling) {
+    job.settling = true;
+    job.settleStart = now;
+    job.runLength = 0;
+    findSettleSense();
+  }
+
+  unsigned long elapsed = now - job.settleStart;
+  unsigned long settledUs;
+
+  if (!adaptiveSettle) {
+    if (elapsed < timeoutUs) {
+      startWait(timeoutUs - elapsed);
+      return false;
+    }
+    settledUs = elapsed;
+  } else if (job.senseMask == 0 && !job.senseAnalog) {
+    settledUs = 0;
+  } else {
+    int value = readSettleSense();
+    bool agrees = job.senseAnalog ? abs(value - job.runValue) <= ADC_SETTLE_TOL
+                                  : value == job.runValue;
+    if (job.runLength == 0 || !agrees) {
+      job.runLength = 1;
+      job.runValue = value;
+      job.runStart = elapsed;
+    } else {
+      job.runLength++;
+    }
+
+    if (job.runLength >= SETTLE_AGREE) {
+      settledUs = job.runStart;
+    } else if (elapsed >= timeoutUs) {
+      settledUs = elapsed;
+    } else {
+      startWait(SETTLE_POLL_US);
+      return false;
+    }
+  }
+
+  job.settling = false;
+  if (step.val && job.settleCount < 8) job.settleUs[job.settleCount++] = settledUs;
+  return true;
+}
+
+// ":SETTLE:<us>,<us>..." for reported settle slots [first, first + count)
+// (those a FAST stop left empty are dropped)
+void CableTester::formatSettle(uint8_t first, uint8_t count) {
+  if (first + count > job.settleCount) count = first < job.settleCount ? job.settleCount - first : 0;
+  if (count == 0) return;
+  replyAdd(":SETTLE:");
+  for (uint8_t i = first; i < first + count; i++) {
+    if (i > first) replyChar(',');
+    replyUInt(job.settleUs[i]);
+  }
+}
+
+// ===== RESULT EVALUATION =====
+bool CableTester::jobBit(uint8_t bit) {
+  return (job.bits >> bit) & 1;
+}
+
+void CableTester::decodeContinuity(TestResults &results) {
+  results.tipToTip = jobBit(BIT_TT);
+  results.tipToSleeve = jobBit(BIT_TS);
+  results.sleeveToSleeve = jobBit(BIT_SS);
+  results.sleeveToTip = jobBit(BIT_ST);
+
+  // PASS: signal goes tip->tip and sleeve->sleeve, no cross-connection
+  results.overallPass = results.tipToTip && !results.tipToSleeve &&
+                        results.sleeveToSleeve && !results.sleeveToTip;
+
+  // REVERSED: signal goes tip->sleeve and sleeve->tip
+  results.reversed = !results.tipToTip && results.tipToSleeve &&
+                     !results.sleeveToSleeve && results.sleeveToTip;
+
+  // SHORT: tip and sleeve are shorted together
+  results.shorted = results.tipToSleeve || results.sleeveToTip;
+
+  // OPEN: no signal detected
+  results.openTip = !results.tipToTip && !results.tipToSleeve;
+  results.openSleeve = !results.sleeveToSleeve && !results.sleeveToTip;
+}
+
+void CableTester::decodeXlrContinuity(XlrContResults &r) {
+  r.overallPass = true;
+  for (int d = 0; d < 3; d++) {
+    for (int s = 0; s < 3; s++) {
+      r.p[d][s] = jobBit(BIT_XP(d, s));
+      if (d == s && !r.p[d][s]) r.overallPass = false;  // should be connected
+      if (d != s && r.p[d][s])  r.overallPass = false;  // should NOT be connected
+    }
+  }
+}
+
+void CableTester::decodeXlrShell(XlrShellResults &r) {
+  r.farShellBond = jobBit(BIT_FAR);
+  r.nearShellBond = jobBit(BIT_NEAR);
+  r.shellToP2 = jobBit(BIT_SH_P2);
+  r.shellToP3 = jobBit(BIT_SH_P3);
+  r.shellToShell = jobBit(BIT_SH_SH);
+  r.overallPass = r.nearShellBond && r.farShellBond && !r.shellToP2 && !r.shellToP3;
+}
+
+// True if any drive reached any sense line (wiring error rather than open)
+bool CableTester::xlrContAnyConnection(const XlrContResults &r) {
+  for (int d = 0; d < 3; d++)
+    for (int s = 0; s < 3; s++)
+      if (r.p[d][s]) return true;
+  return false;
+}
+
+// Decode the finished job, show its result and store calibration readings.
+// Returns RF_* flags; the text and binary responses are both built from it.
+uint8_t CableTester::evaluateTest(TestResults &cont, XlrContResults &xcont, XlrShellResults &shell) {
+  uint8_t flags = 0;
+  trackReadings();
+
+  switch (job.kind) {
+    case TEST_CONT:
+      decodeContinuity(cont);
+      if (cont.overallPass) flags = RF_PASS | RF_CONT_PASS;
+      if (cont.overallPass) showResult(SHOW_PASS);
+      else if (cont.reversed || cont.shorted) showResult(SHOW_ERROR);  // Wiring error
+      else showResult(SHOW_FAIL);                                      // Open connection
+      break;
+
+    case TEST_XCONT:
+      decodeXlrContinuity(xcont);
+      if (xcont.overallPass) flags = RF_PASS | RF_CONT_PASS;
+      if (xcont.overallPass) showResult(SHOW_PASS);
+      else if (xlrContAnyConnection(xcont)) showResult(SHOW_ERROR);
+      else showResult(SHOW_FAIL);
+      break;
+
+    case TEST_XSHELL:
+      decodeXlrShell(shell);
+      if (shell.overallPass) flags = RF_PASS | RF_SHELL_PASS;
+      if (shell.overallPass) showResult(SHOW_PASS);
+      else if (shell.nearShellBond || shell.farShellBond) showResult(SHOW_ERROR);
+      else showResult(SHOW_FAIL);
+      break;
+
+    case TEST_RES:
+      if (resPassCheck(job.fine[0], job.overBits, isCalibrated, tsBase)) flags = RF_PASS | RF_RES_PASS;
+      if (flags & RF_PASS) showResult(SHOW_PASS);
+      else showResult(SHOW_FAIL);
+      break;
+
+    case TEST_XRES:
+      if (xlrResPassCheck()) flags = RF_PASS | RF_RES_PASS;
+      if (flags & RF_PASS) showResult(SHOW_PASS);
+      else showResult(SHOW_FAIL);
+      break;
+
+    case TEST_CAL:
+      if (storeCalibration(job.adc[0])) flags = RF_PASS;
+      break;
+
+    case TEST_XCAL:
+      if (storeXlrCalibration(job.adc[0], job.adc[1])) flags = RF_PASS;
+      break;
+
+    case TEST_FULL:
+      decodeContinuity(cont);
+      if (cont.overallPass) flags |= RF_CONT_PASS;
+      if (resPassCheck(job.fine[0], job.overBits, isCalibrated, tsBase)) flags |= RF_RES_PASS;
+      if (flags == (RF_CONT_PASS | RF_RES_PASS)) flags |= RF_PASS;
+      if (flags & RF_PASS) showResult(SHOW_PASS);
+      else if (cont.reversed || cont.shorted) showResult(SHOW_ERROR);
+      else showResult(SHOW_FAIL);
+      break;
+
+    case TEST_XFULL:
+    case TEST_XFULL_SHELL: {
+      bool withShell = job.kind == TEST_XFULL_SHELL;
+      decodeXlrContinuity(xcont);
+      if (xcont.overallPass) flags |= RF_CONT_PASS;
+      if (!(job.skipped & CK_XRES_ALL) && xlrResPassCheck()) flags |= RF_RES_PASS;
+      uint8_t needed = RF_CONT_PASS | RF_RES_PASS;
+      if (withShell) {
+        decodeXlrShell(shell);
+        if (shell.overallPass) flags |= RF_SHELL_PASS;
+        needed |= RF_SHELL_PASS;
+      }
+      if (flags == needed) flags |= RF_PASS;
+      if (flags & RF_PASS) showResult(SHOW_PASS);
+      else if (!xcont.overallPass && xlrContAnyConnection(xcont)) showResult(SHOW_ERROR);
+      else showResult(SHOW_FAIL);
+      break;
+    }
+
+    case TEST_BOTH:
+      decodeContinuity(cont);
+      decodeXlrContinuity(xcont);
+      if (cont.overallPass && xcont.overallPass) flags = RF_PASS | RF_CONT_PASS;
+      if (flags & RF_PASS) showResult(SHOW_PASS);
+      else if (cont.reversed || cont.shorted ||
+               (!xcont.overallPass && xlrContAnyConnection(xcont))) showResult(SHOW_ERROR);
+      else showResult(SHOW_FAIL);
+      break;
+  }
+  return flags;
+}
+
+// Format the evaluated job's text response into the reply
+void CableTester::buildTestResponse(uint8_t flags, const TestResults &cont, const XlrContResults &xcont,
+                                    const XlrShellResults &shell) {
+  bool pass = flags & RF_PASS;
+
+  replyBegin("");
+  switch (job.kind) {
+    case TEST_CONT:
+      formatResults(cont);
+      formatSkipped(CK_CONT_ALL);
+      formatSettle(0, 2);
+      break;
+
+    case TEST_XCONT:
+      formatXlrContResults(xcont);
+      formatSkipped(CK_XCONT_ALL);
+      formatSettle(0, 3);
+      break;
+
+    case TEST_XSHELL:
+      formatXlrShellResults(shell);
+      formatSkipped(CK_XSHELL_ALL);
+      formatSettle(0, 2);
+      break;
+
+    case TEST_RES:
+      formatResResult("RES:");
+      formatSettle(0, 1);
+      break;
+
+    case TEST_XRES:
+      formatXlrResResult();
+      formatSkipped(CK_XRES_ALL);
+      formatSettle(0, 2);
+      break;
+
+    case TEST_CAL:
+      replyAdd(pass ? "CAL:OK" : "CAL:FAIL");
+      replyField("ADC", pass ? tsBase.calADC : job.adc[0]);
+      if (!pass) replyAdd(":NO_CABLE");
+      break;
+
+    case TEST_XCAL:
+      replyAdd(pass ? "XCAL:OK" : "XCAL:FAIL");
+      replyField("P2ADC", pass ? p2Base.calADC : job.adc[0]);
+      replyField("P3ADC", pass ? p3Base.calADC : job.adc[1]);
+      if (!pass) replyAdd(":NO_CABLE");
+      break;
+
+    case TEST_FULL:
+      replyAdd(pass ? "FULL:PASS|" : "FULL:FAIL|");
+      if ((job.skipped & CK_CONT_ALL) == CK_CONT_ALL) {
+        replyAdd("RESULT:SKIP");
+      } else {
+        formatResults(cont);
+        formatSkipped(CK_CONT_ALL);
+        formatSettle(1, 2);
+      }
+      replyChar('|');
+      formatResResult("RES:");
+      formatSettle(0, 1);
+      break;
+
+    case TEST_XFULL:
+    case TEST_XFULL_SHELL: {
+      bool withShell = job.kind == TEST_XFULL_SHELL;
+      replyAdd(pass ? "XFULL:PASS|" : "XFULL:FAIL|");
+      formatXlrContResults(xcont);
+      formatSkipped(CK_XCONT_ALL);
+      formatSettle(0, 3);
+      if (withShell) {
+        // SEG_XLR_SCAN: the shell result's drives are pin 1 (slot 0) and shell (slot 3)
+        replyChar('|');
+        formatXlrShellResults(shell);
+        formatSkipped(CK_XSHELL_ALL);
+        formatSettle(0, 1);
+        if (job.settleCount > 3) {
+          replyChar(',');
+          replyUInt(job.settleUs[3]);
+        }
+      }
+      replyChar('|');
+      if ((job.skipped & CK_XRES_ALL) == CK_XRES_ALL) {
+        replyAdd("XRES:SKIP");
+      } else {
+        formatXlrResResult();
+        formatSkipped(CK_XRES_ALL);
+        formatSettle(withShell ? 4 : 3, 2);
+      }
+      break;
+    }
+
+    case TEST_BOTH:
+      // SEG_BOTH_CONT: TIP and SLEEVE drive in slots 0 and 1, with pins 1 and 2
+      replyAdd(pass ? "BOTH:PASS|" : "BOTH:FAIL|");
+      formatResults(cont);
+      formatSkipped(CK_CONT_ALL);
+      formatSettle(0, 2);
+      replyChar('|');
+      formatXlrContResults(xcont);
+      formatSkipped(CK_XCONT_ALL);
+      formatSettle(0, 3);
+      break;
+
+    default:
+      replyAdd("ERROR:UNKNOWN_TEST");
+  }
+}
+
+// Pack the finished job into a binary result record (see BINARY RESULTS).
+// Returns the record length.
+uint8_t CableTester::packTestResult(uint8_t flags, uint8_t *buf) {
+  bool tsRes = job.kind == TEST_RES || job.kind == TEST_CAL || job.kind == TEST_FULL;
+  bool xlrRes = job.kind == TEST_XRES || job.kind == TEST_XCAL ||
+                job.kind == TEST_XFULL || job.kind == TEST_XFULL_SHELL;
+  uint16_t cal[2] = {0, 0};
+  uint32_t mohm[2] = {0, 0};
+  if (tsRes && isCalibrated) {
+    flags |= RF_CALIBRATED;
+    cal[0] = tsBase.adc;
+    mohm[0] = cableMilliohms(job.fine[0], job.overBits, tsBase);
+  } else if (xlrRes && isXlrCalibrated) {
+    flags |= RF_CALIBRATED;
+    cal[0] = p2Base.adc;
+    cal[1] = p3Base.adc;
+    mohm[0] = cableMilliohms(job.fine[0], job.overBits, p2Base);
+    mohm[1] = cableMilliohms(job.fine[1], job.overBits, p3Base);
+  }
+
+  uint8_t n = 0;
+  buf[n++] = BIN_MAGIC;
+  buf[n++] = job.kind;
+  buf[n++] = flags;
+  n = putLE(buf, n, job.bits | (uint32_t)job.skipped << BIT_SKIP, 4);
+  for (uint8_t i = 0; i < 2; i++) n = putLE(buf, n, job.adc[i], 2);
+  for (uint8_t i = 0; i < 2; i++) n = putLE(buf, n, cal[i], 2);
+  for (uint8_t i = 0; i < 2; i++) n = putLE(buf, n, mohm[i], 4);
+  buf[n++] = job.settleCount;
+  for (uint8_t i = 0; i < job.settleCount; i++) n = putLE(buf, n, job.settleUs[i], 2);
+  return n;
+}
+
+// Little-endian field writer for packTestResult()
+uint8_t CableTester::putLE(uint8_t *buf, uint8_t pos, uint32_t value, uint8_t bytes) {
+  for (uint8_t i = 0; i < bytes; i++) buf[pos++] = (value >> (8 * i)) & 0xFF;
+  return pos;
+}
+
+// ===== RESPONSE FORMATTING =====
+// Each formatter appends its sub-response to the reply.
+void CableTester::formatResults(const TestResults &r) {
+  replyAdd(r.overallPass ? "RESULT:PASS" : "RESULT:FAIL");
+
+  // Raw readings: TT=tipToTip, TS=tipToSleeve, SS=sleeveToSleeve, ST=sleeveToTip
+  replyFlag("TT", r.tipToTip);
+  replyFlag("TS", r.tipToSleeve);
+  replyFlag("SS", r.sleeveToSleeve);
+  replyFlag("ST", r.sleeveToTip);
+
+  // Add failure reason if failed
+  if (!r.overallPass) {
+    replyAdd(":REASON:");
+    if (r.reversed) {
+      replyAdd("REVERSED");
+    } else if (r.shorted) {
+      replyAdd("SHORT");
+    } else if (r.openTip && r.openSleeve) {
+      replyAdd("NO_CABLE");
+    } else if (r.openTip) {
+      replyAdd("TIP_OPEN");
+    } else if (r.openSleeve) {
+      replyAdd("SLEEVE_OPEN");
+    } else {
+      replyAdd("UNKNOWN");
+    }
+  }
+}
+
+// XCONT/XSHELL of XFULL SHELL: SKIP instead of FAIL, without a reason,
+// when a FAST stop elsewhere cut them short before they failed
+void CableTester::formatXlrContResults(const XlrContResults &r) {
+  bool undecided = !r.overallPass && checksUndecided(CK_XCONT_ALL);
+  replyAdd(r.overallPass ? "XCONT:PASS" : undecided ? "XCONT:SKIP" : "XCONT:FAIL");
+  for (int d = 0; d < 3; d++) {
+    for (int s = 0; s < 3; s++) {
+      replyAdd(":P");
+      replyChar('1' + d);
+      replyChar('1' + s);
+      replyChar(':');
+      replyBit(r.p[d][s]);
+    }
+  }
+
+  // Failure reason
+  if (!r.overallPass && !undecided) {
+    replyAdd(":REASON:");
+    if (!xlrContAnyConnection(r)) {
+      replyAdd("NO_CABLE");
+    } else {
+      // Only rows that were driven (FAST may skip the rest)
+      uint16_t issues = replyLen;
+      for (int i = 0; i < 3; i++) {
+        if (!r.p[i][i] && !(job.skipped & (CK_P1 << i))) {
+          replyItem(issues, "P");
+          replyChar('1' + i);
+          replyAdd("_OPEN");
+        }
+      }
+      for (int d = 0; d < 3; d++) {
+        for (int s = 0; s < 3; s++) {
+          if (d != s && r.p[d][s]) {   // Never set in a skipped row
+            replyItem(issues, "P");
+            replyChar('1' + d);
+            replyAdd("_P");
+            replyChar('1' + s);
+            replyAdd("_SHORT");
+          }
+        }
+      }
+      if (replyLen == issues) replyAdd("UNKNOWN");
+    }
+  }
+}
+
+void CableTester::formatXlrShellResults(const XlrShellResults &r) {
+  bool undecided = !r.overallPass && checksUndecided(CK_XSHELL_ALL);
+  replyAdd(r.overallPass ? "XSHELL:PASS" : undecided ? "XSHELL:SKIP" : "XSHELL:FAIL");
+  replyFlag("NEAR", r.nearShellBond);
+  replyFlag("FAR", r.farShellBond);
+  replyFlag("SS", r.shellToShell);
+
+  if (!r.overallPass && !undecided) {
+    replyAdd(":REASON:");
+    uint16_t issues = replyLen;
+    if (!r.nearShellBond && !(job.skipped & CK_NEAR)) replyItem(issues, "NEAR_SHELL_OPEN");
+    if (!r.farShellBond && !(job.skipped & CK_FAR)) replyItem(issues, "FAR_SHELL_OPEN");
+    if (r.shellToP2) replyItem(issues, "SHELL_P2_SHORT");
+    if (r.shellToP3) replyItem(issues, "SHELL_P3_SHORT");
+    if (replyLen == issues) replyAdd("UNKNOWN");
+  }
+}
+
+// ===== CALIBRATION =====
+// Calibrate with a known-good short cable (or direct short).
+// Establishes baseline ADC that includes Vce_sat + parasitic resistance.
+// Cable resistance is then measured relative to this baseline.
+// PROG_CAL measures with the TS resistance path; this stores the result.
+bool CableTester::storeCalibration(int measuredADC) {
+  // Reject if reading is too high (no cable or bad connection)
+  if (measuredADC > CAL_REJECT_THRESHOLD) {
+    showResult(SHOW_FAIL);
+    return false;
+  }
+
+  setBaseline(tsBase, measuredADC, supplyMv);
+  isCalibrated = true;
+  calibrationChanged();
+
+  showResult(SHOW_PASS);
+  return true;
+}
+
+// Calibrates both pin 2 and pin 3 paths separately since relay contact
+// resistance can differ between K4 LOW (pin 2) and K4 HIGH (pin 3).
+bool CableTester::storeXlrCalibration(int measuredP2, int measuredP3) {
+  // Reject if either reading is too high (no cable or bad connection)
+  if (measuredP2 > CAL_REJECT_THRESHOLD || measuredP3 > CAL_REJECT_THRESHOLD) {
+    showResult(SHOW_FAIL);
+    return false;
+  }
+
+  setBaseline(p2Base, measuredP2, supplyMv);
+  setBaseline(p3Base, measuredP3, supplyMv);
+  isXlrCalibrated = true;
+  calibrationChanged();
+
+  showResult(SHOW_PASS);
+  return true;
+}
+
+// ===== STORED CALIBRATION =====
+static_assert(sizeof(CalRecord) == 16, "CalRecord layout is shared by both boards");
+
+static const char CAL_MEASURED[] = "CAL";   // calSource for a calibration taken this boot
+
+uint16_t crc16(const uint8_t *data, uint8_t len) {
+  uint16_t crc = 0xFFFF;
+  while (len--) {
+    crc ^= (uint16_t)*data++ << 8;
+    for (uint8_t i = 0; i < 8; i++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+bool CableTester::calRecordValid(const CalRecord &rec) {
+  return rec.magic == CAL_MAGIC &&
+         rec.crc == crc16((const uint8_t *)&rec, offsetof(CalRecord, crc));
+}
+
+// A fresh CAL/XCAL: AGE restarts and poll() saves it
+void CableTester::calibrationChanged() {
+  calSource = CAL_MEASURED;
+  calSetAt = millis();
+  calAgeBase = 0;
+  calInStore = false;
+  calDirty = calSlots() > 0;
+}
+
+// Readings past CAL_REJECT_THRESHOLD are dropped as storeCalibration() would
+void CableTester::applyCalRecord(const CalRecord &rec) {
+  isCalibrated = (rec.flags & CALF_TS) && rec.ts >= 0 && rec.ts <= CAL_REJECT_THRESHOLD;
+  if (isCalibrated) setBaseline(tsBase, rec.ts, rec.tsMv);
+  isXlrCalibrated = (rec.flags & CALF_XLR) &&
+                    rec.p2 >= 0 && rec.p2 <= CAL_REJECT_THRESHOLD &&
+                    rec.p3 >= 0 && rec.p3 <= CAL_REJECT_THRESHOLD;
+  if (isXlrCalibrated) {
+    setBaseline(p2Base, rec.p2, rec.xlrMv);
+    setBaseline(p3Base, rec.p3, rec.xlrMv);
+  }
+}
+
+bool CableTester::loadCalibration() {
+  CalRecord rec;
+  CalRecord newest;
+  bool found = false;
+  for (uint8_t slot = 0; slot < calSlots(); slot++) {
+    if (!readCalSlot(slot, rec) || !calRecordValid(rec)) continue;
+    // Serial-number compare: seq wraps after 65535 saves
+    if (found && (int16_t)(rec.seq - newest.seq) <= 0) continue;
+    newest = rec;
+    calSlot = slot;
+    found = true;
+  }
+  if (!found) return false;
+
+  calStored = true;
+  calSeq = newest.seq;
+  calInStore = true;
+  applyCalRecord(newest);
+  calSource = calStorage();
+  calSetAt = millis();
+  calAgeBase = 0;
+  return true;
+}
+
+bool CableTester::saveCalibration() {
+  calDirty = false;
+  uint8_t slots = calSlots();
+  if (slots == 0) return false;
+
+  CalRecord rec;
+  rec.magic = CAL_MAGIC;
+  rec.flags = (isCalibrated ? CALF_TS : 0) | (isXlrCalibrated ? CALF_XLR : 0);
+  rec.seq = calStored ? calSeq + 1 : 0;
+  rec.ts = tsBase.calADC;
+  rec.p2 = p2Base.calADC;
+  rec.p3 = p3Base.calADC;
+  rec.tsMv = tsBase.calMv;
+  rec.xlrMv = p2Base.calMv;
+  rec.crc = crc16((const uint8_t *)&rec, offsetof(CalRecord, crc));
+
+  uint8_t slot = calStored ? (calSlot + 1) % slots : 0;
+  if (!writeCalSlot(slot, rec)) return false;
+  calStored = true;
+  calSlot = slot;
+  calSeq = rec.seq;
+  calInStore = true;
+  return true;
+}
+
+bool CableTester::restoreCalibration(const uint8_t *data, uint8_t len, unsigned long ageSeconds) {
+  if (len != sizeof(CalRecord) || calSource == CAL_MEASURED) return false;
+  CalRecord rec;
+  memcpy(&rec, data, len);
+  if (!calRecordValid(rec)) return false;
+
+  calStored = true;
+  calSlot = 0;
+  calSeq = rec.seq;
+  calInStore = true;
+  applyCalRecord(rec);
+  calSource = calStorage();
+  calSetAt = millis();
+  calAgeBase = ageSeconds;
+  return true;
+}
+
+// ===== SESSION CONFIG =====
+static_assert(sizeof(ConfigRecord) == 6, "ConfigRecord layout is shared by both boards");
+
+void CableTester::currentConfig(ConfigRecord &rec) {
+  rec.magic = CONFIG_MAGIC;
+  rec.flags = (fastMode ? CFGF_FAST : 0) | (burstMode ? CFGF_BURST : 0) |
+              (resStats ? CFGF_RESSTAT : 0) | (adaptiveSettle ? 0 : CFGF_SETTLE) |
+              (autoFast ? CFGF_AUTO_FAST : 0) | (bootFast ? CFGF_BOOT_FAST : 0);
+  rec.overBits = overBits;
+  rec.autoTest = autoTest;
+  rec.crc = 0;
+}
+
+bool CableTester::configRecordValid(const ConfigRecord &rec) {
+  return rec.magic == CONFIG_MAGIC &&
+         rec.crc == crc16((const uint8_t *)&rec, offsetof(ConfigRecord, crc));
+}
+
+// Settings this build can't take (an AUTO test AUTO rejects, too many
+// OVERSAMPLE bits) come back as their defaults
+void CableTester::applyConfig(const ConfigRecord &rec) {
+  fastMode = rec.flags & CFGF_FAST;
+  burstMode = rec.flags & CFGF_BURST;
+  resStats = rec.flags & CFGF_RESSTAT;
+  adaptiveSettle = !(rec.flags & CFGF_SETTLE);
+  bootFast = rec.flags & CFGF_BOOT_FAST;
+  overBits = rec.overBits <= OVERSAMPLE_MAX_BITS ? rec.overBits : 0;
+  autoFast = rec.flags & CFGF_AUTO_FAST;
+  bool autoOk = rec.autoTest < NUM_TESTS && rec.autoTest != TEST_CAL && rec.autoTest != TEST_XCAL;
+  setAuto(autoOk ? rec.autoTest : (uint8_t)TEST_NONE);
+  currentConfig(savedConfig);
+}
+
+bool CableTester::loadConfig() {
+  ConfigRecord rec;
+  if (!readConfig(rec) || !configRecordValid(rec)) return false;
+  applyConfig(rec);
+  return true;
+}
+
+// Called between tests: EEPROM writes block for a few ms each, and one
+// failed write isn't retried every loop
+void CableTester::serviceConfig() {
+  ConfigRecord rec;
+  currentConfig(rec);
+  if (memcmp(&rec, &savedConfig, offsetof(ConfigRecord, crc)) == 0) return;
+  rec.crc = crc16((const uint8_t *)&rec, offsetof(ConfigRecord, crc));
+  savedConfig = rec;
+  configSaved = true;
+  writeConfig(rec);
+}
+
+bool CableTester::restoreConfig(const uint8_t *data, uint8_t len) {
+  if (len != sizeof(ConfigRecord) || configSaved) return false;
+  ConfigRecord rec;
+  memcpy(&rec, data, len);
+  if (!configRecordValid(rec)) return false;
+  applyConfig(rec);
+  return true;
+}
+
+// ===== WEAR COUNTERS =====
+static_assert(sizeof(StatsRecord) == 120, "StatsRecord layout is shared by both boards");
+
+static const char *const RELAY_NAMES[] = {"K12", "K3", "K4", "K5", "K6"};
+static_assert(sizeof(RELAY_NAMES) / sizeof(RELAY_NAMES[0]) == RELAY_COUNT, "a name per relay");
+
+void CableTester::countStat(uint32_t &counter) {
+  counter++;
+  if (!statsDirty) statsChangedAt = millis();
+  statsDirty = true;
+}
+
+bool CableTester::statsRecordValid(const StatsRecord &rec) {
+  return rec.magic == STATS_MAGIC &&
+         rec.crc == crc16((const uint8_t *)&rec, offsetof(StatsRecord, crc));
+}
+
+// Slots per head (head n's from (n - 1) * ring), 0 = nowhere to save.
+// Keeping a head to its own slots means a save mostly rewrites the bytes
+// of its previous lap, and EEPROM.put() skips the ones that match.
+uint8_t CableTester::statsRing() {
+  return statsSlots() / headCount;
+}
+
+// Newest valid record of every head, wherever a different head count
+// left it
+void CableTester::loadStats() {
+  StatsRecord rec;
+  for (uint8_t slot = 0; slot < statsSlots(); slot++) {
+    if (!readStatsSlot(slot, rec) || !statsRecordValid(rec)) continue;
+    if (rec.head < 1 || rec.head > headCount) continue;
+    CableTester &t = *heads[rec.head - 1];
+    // Serial-number compare: seq wraps after 65535 saves
+    if (t.statsStored && (int16_t)(rec.seq - t.stats.seq) <= 0) continue;
+    t.stats = rec;
+    t.statsSlot = slot;
+    t.statsStored = true;
+  }
+}
+
+// Head 1 writes head `t`'s counters to the next slot of its ring
+bool CableTester::saveStats(CableTester &t) {
+  t.statsDirty = false;
+  t.statsSaveNow = false;
+  uint8_t ring = statsRing();
+  if (ring == 0) return false;
+  uint8_t first = (t.headNo - 1) * ring;
+
+  StatsRecord rec = t.stats;
+  rec.magic = STATS_MAGIC;
+  rec.head = t.headNo;
+  rec.seq = t.statsStored ? t.stats.seq + 1 : 0;
+  rec.crc = crc16((const uint8_t *)&rec, offsetof(StatsRecord, crc));
+
+  bool inRing = t.statsStored && t.statsSlot >= first && t.statsSlot < first + ring;
+  uint8_t slot = inRing ? first + (t.statsSlot - first + 1) % ring : first;
+  if (!writeStatsSlot(slot, rec)) return false;
+  t.stats.seq = rec.seq;
+  t.statsSlot = slot;
+  t.statsStored = true;
+  return true;
+}
+
+// Called between tests: at most one record per poll, since each write
+// blocks. A failed write waits for the next count and STATS_SAVE_MS.
+void CableTester::serviceStats() {
+  for (uint8_t h = 0; h < headCount; h++) {
+    CableTester &t = *heads[h];
+    if (!t.statsDirty) continue;
+    if (!t.statsSaveNow && millis() - t.statsChangedAt < STATS_SAVE_MS) continue;
+    saveStats(t);
+    return;
+  }
+}
+
+bool CableTester::restoreStats(const uint8_t *data, uint8_t len) {
+  if (len != sizeof(StatsRecord) || statsStored) return false;
+  StatsRecord rec;
+  memcpy(&rec, data, len);
+  if (!statsRecordValid(rec) || rec.head != headNo) return false;
+
+  for (uint8_t i = 0; i < RELAY_COUNT; i++) stats.relays[i] += rec.relays[i];
+  stats.inserts += rec.inserts;
+  for (uint8_t k = 0; k < TEST_KIND_COUNT; k++) {
+    stats.pass[k] += rec.pass[k];
+    stats.fail[k] += rec.fail[k];
+  }
+  stats.resets = rec.resets;
+  stats.seq = rec.seq;
+  statsSlot = 0;
+  statsStored = true;
+  return true;
+}
+
+// STATS:SAVED:<0|1>:RESETS:<n>:K12:<n>:K3:<n>:K4:<n>:K5:<n>:K6:<n>:INS:<n>
+//   [:<test>:<pass>:<fail>...] (tests that have run)
+// STATS SAVE writes the counters at the next idle poll instead of after
+// STATS_SAVE_MS; STATS RESET zeroes them (new relays or jacks), counts the
+// reset and saves. Either answers with the counters.
+void CableTester::handleStats(const char *arg) {
+  if (arg && cmdIs(arg, "RESET")) {
+    uint16_t resets = stats.resets + 1;
+    uint16_t seq = stats.seq;
+    memset(&stats, 0, sizeof(stats));
+    stats.resets = resets;
+    stats.seq = seq;
+    statsDirty = true;
+    statsSaveNow = true;
+  } else if (arg && cmdIs(arg, "SAVE")) {
+    statsSaveNow = statsDirty;
+  } else if (arg) {
+    replyBegin("ERROR:STATS:");
+    replyAdd(arg);
+    replySend();
+    return;
+  }
+
+  replyBegin("STATS");
+  replyFlag("SAVED", !statsDirty);
+  replyField("RESETS", stats.resets);
+  for (uint8_t i = 0; i < RELAY_COUNT; i++) replyField(RELAY_NAMES[i], stats.relays[i]);
+  replyField("INS", stats.inserts);
+  for (uint8_t k = 0; k < TEST_KIND_COUNT; k++) {
+    if (stats.pass[k] == 0 && stats.fail[k] == 0) continue;
+    replyField(TEST_DEFS[k].cmd, stats.pass[k]);
+    replyChar(':');
+    replyUInt(stats.fail[k]);
+  }
+  replySend();
+}
+
+// CALINFO:SRC:<CAL|storage|NONE>[:AGE:<s>]:STORE:<storage>:SAVED:<0|1>[:SEQ:<n>]
+//   :MV:<supply>:TS:<0|1>[:CAL:<adc>:CALMV:<mv>:DRIFT:<mohm>]
+//   :XLR:<0|1>[:P2CAL:<adc>:P3CAL:<adc>:XCALMV:<mv>:P2DRIFT:<mohm>:P3DRIFT:<mohm>]
+// AGE is seconds since it was measured. The UNO Q's MPU dates its copy;
+// the Mega has no clock, so a calibration loaded from EEPROM counts from
+// boot.
+void CableTester::sendCalInfo() {
+  replyBegin("CALINFO:SRC:");
+  replyAdd(calSource);
+  if (isCalibrated || isXlrCalibrated) {
+    replyField("AGE", calAgeBase + (millis() - calSetAt) / 1000);
+  }
+  replyAdd(":STORE:");
+  replyAdd(calStorage());
+  replyFlag("SAVED", calInStore);
+  if (calStored) replyField("SEQ", calSeq);
+  replyField("MV", supplyMv);
+  replyFlag("TS", isCalibrated);
+  if (isCalibrated) {
+    replyField("CAL", tsBase.calADC);
+    replyField("CALMV", tsBase.calMv);
+    replyField("DRIFT", baselineDrift(tsBase));
+  }
+  replyFlag("XLR", isXlrCalibrated);
+  if (isXlrCalibrated) {
+    replyField("P2CAL", p2Base.calADC);
+    replyField("P3CAL", p3Base.calADC);
+    replyField("XCALMV", p2Base.calMv);
+    replyField("P2DRIFT", baselineDrift(p2Base));
+    replyField("P3DRIFT", baselineDrift(p3Base));
+  }
+  replySend();
+}
+
+// ===== RESISTANCE =====
+// Readings come from SEG_RES_SAMPLE: K3/K4 route the shared circuit
+// (RES_SENSE), RES_TEST_OUT pulses current through the PN2222A, and the
+// mean of a RES_SAMPLES burst is stored.
+
+//
+// With V = counts * SUPPLY_VOLTAGE / ADC_MAX the supply cancels out:
+//   R = (Vsense - Vcal) / ((SUPPLY - Vcal) / R_sense)
+//     = R_sense * (adc - cal) / (ADC_MAX - cal)
+// The divisor only changes on calibration, so calScale() turns it into a
+// Q16 milliohms-per-count reciprocal once and each reading is one integer
+// multiply and shift: no float math (software-emulated on the Mega) and
+// the same MOHM for the same counts on every run. adc <= ADC_MAX, so
+// (adc - cal) * scale <= RES_SENSE_MOHM << 16 and fits 32 bits; an
+// OVERSAMPLE reading carries `bits` more and takes the 64-bit product.
+//
+// Below CAL_MIN_MA through the sense resistor the calibration means
+// nothing; that current is a headroom in counts, fixed at compile time.
+constexpr uint8_t CAL_SCALE_SHIFT = 16;
+constexpr uint16_t CAL_MIN_MA = 1;
+constexpr long CAL_MIN_HEADROOM = (long)CAL_MIN_MA * RES_SENSE_MOHM / 1000 * ADC_MAX / BoardAdc::SUPPLY_MV;
+static_assert(((uint64_t)RES_SENSE_MOHM << CAL_SCALE_SHIFT) <= 0xFFFFFFFFull,
+              "Q16 milliohm product must fit 32 bits");
+
+// Q16 milliohms per ADC count above calibration; 0 = unusable calibration.
+// Readings land within 1 mΩ of the exact quotient.
+uint32_t CableTester::calScale(int calADC) {
+  long headroom = ADC_MAX - calADC;
+  if (headroom <= CAL_MIN_HEADROOM) return 0;
+  return (((uint32_t)RES_SENSE_MOHM << CAL_SCALE_SHIFT) + headroom - 1) / headroom;
+}
+
+// Cable resistance in milliohms from a reading in 1/2^bits counts
+// relative to the baseline
+long CableTester::cableMilliohms(long reading, uint8_t bits, const Baseline &b) {
+  long base = (long)b.adc << bits;
+  if (reading <= base) return 0;
+  if (reading > (long)ADC_MAX << bits) reading = (long)ADC_MAX << bits;  // Keeps the product in range
+  if (bits == 0) return ((uint32_t)(reading - base) * b.scale) >> CAL_SCALE_SHIFT;
+  return ((uint64_t)(reading - base) * b.scale) >> (CAL_SCALE_SHIFT + bits);
+}
+
+// Check pass/fail: use calibrated resistance if available, else absolute ADC
+bool CableTester::resPassCheck(long reading, uint8_t bits, bool calibrated, const Baseline &b) {
+  if (calibrated) {
+    return cableMilliohms(reading, bits, b) <= MAX_CABLE_MOHM;
+  }
+  return (reading >> bits) <= RES_PASS_THRESHOLD;
+}
+
+// Format resistance result for the TS reading
+void CableTester::formatResResult(const char* prefix) {
+  bool pass = resPassCheck(job.fine[0], job.overBits, isCalibrated, tsBase);
+
+  replyAdd(prefix);
+  replyAdd(pass ? "PASS" : "FAIL");
+  replyField("ADC", job.adc[0]);
+  if (isCalibrated) {
+    long milliohms = cableMilliohms(job.fine[0], job.overBits, tsBase);
+    replyField("CAL", tsBase.adc);
+    replyField("MOHM", milliohms);
+    replyAdd(":OHM:");
+    replyOhms(milliohms);
+  } else {
+    replyAdd(":OHM:UNCAL");
+  }
+  if (job.overBits) replyField("BITS", readingBits(0));
+  formatReadingStats("", 0);
+}
+
+// Both pins must pass (each against its own calibration)
+bool CableTester::xlrResPassCheck() {
+  return resPassCheck(job.fine[0], job.overBits, isXlrCalibrated, p2Base) &&
+         resPassCheck(job.fine[1], job.overBits, isXlrCalibrated, p3Base);
+}
+
+// Combined result using per-pin XLR calibration
+void CableTester::formatXlrResResult() {
+  bool overallPass = xlrResPassCheck();
+
+  replyAdd(overallPass ? "XRES:PASS" : "XRES:FAIL");
+  replyField("P2ADC", job.adc[0]);
+  replyField("P3ADC", job.adc[1]);
+  if (isXlrCalibrated) {
+    long mohm2 = cableMilliohms(job.fine[0], job.overBits, p2Base);
+    long mohm3 = cableMilliohms(job.fine[1], job.overBits, p3Base);
+    replyField("P2CAL", p2Base.adc);
+    replyField("P3CAL", p3Base.adc);
+    replyField("P2MOHM", mohm2);
+    replyAdd(":P2OHM:");
+    replyOhms(mohm2);
+    replyField("P3MOHM", mohm3);
+    replyAdd(":P3OHM:");
+    replyOhms(mohm3);
+  } else {
+    replyAdd(":OHM:UNCAL");
+  }
+  if (job.overBits) {
+    replyField("P2BITS", readingBits(0));
+    replyField("P3BITS", readingBits(1));
+  }
+  formatReadingStats("P2", 0);
+  formatReadingStats("P3", 1);
+}
+
+// ===== READING STATISTICS =====
+// Each OP_ADC slot keeps its bursts' count, sum, sum of squares, min, max
+// and outliers (AdcBurst, gathered per conversion by the board layer), so
+// spread and intermittent contact are visible without storing samples.
+// Variance is (n * sum(x^2) - sum(x)^2) / (n * (n - 1)), in 64-bit integers.
+
+// Pass limit of ADC slot `slot` in 1/16 counts (means above it fail), -1 = none.
+// A Mega count is ~20 mΩ, too coarse to place the limit in whole counts.
+long CableTester::readingLimit(uint8_t slot) {
+  bool calibrated;
+  const Baseline *b;
+  switch (job.kind) {
+    case TEST_RES:
+    case TEST_FULL:
+      calibrated = isCalibrated;
+      b = &tsBase;
+      break;
+    case TEST_XRES:
+    case TEST_XFULL:
+    case TEST_XFULL_SHELL:
+      calibrated = isXlrCalibrated;
+      b = slot ? &p3Base : &p2Base;
+      break;
+    default:
+      return -1;
+  }
+  if (!calibrated) return ((long)RES_PASS_THRESHOLD << 4) + 8;
+  if (b->scale == 0) return -1;
+  return ((long)b->adc << 4) + ((uint32_t)(MAX_CABLE_MOHM + 1) << (CAL_SCALE_SHIFT + 4)) / b->scale;
+}
+
+// More samples could still move the reading across the limit: its mean is
+// within RES_RESAMPLE_SIGMAS standard errors (or one count) of it. With
+// d = 16 * n * (mean - limit):
+//   d^2 <= 256 * (k^2 * (n * sum(x^2) - sum(x)^2) / (n - 1) + n^2)
+bool CableTester::readingBorderline(uint8_t slot) {
+  const AdcBurst &r = job.reading[slot];
+  long limit = readingLimit(slot);
+  if (limit < 0 || r.count < 2) return false;
+  uint64_t n = r.count;
+  int64_t d = ((int64_t)r.sum << 4) - (int64_t)limit * r.count;
+  uint64_t spread = (n * r.sumSq - (uint64_t)r.sum * r.sum) / (n - 1);
+  return (uint64_t)(d * d) <= 256 * (RES_RESAMPLE_SIGMAS * RES_RESAMPLE_SIGMAS * spread + n * n);
+}
+
+// Effective resolution of ADC slot `slot` in bits: the converter's own
+// plus one per 4x of samples, up to the OVERSAMPLE setting. Averaging only
+// resolves steps finer than a count when noise spreads the samples across
+// neighbouring counts, so a reading with SD below half a count
+// (4 * (n * sum(x^2) - sum(x)^2) < n * (n - 1)) gains nothing.
+uint8_t CableTester::readingBits(uint8_t slot) {
+  const AdcBurst &r = job.reading[slot];
+  uint8_t gained = 0;
+  while (gained < job.overBits && (1ul << 2 * (gained + 1)) <= r.count) gained++;
+  uint64_t n = r.count;
+  if (n < 2 || 4 * (n * r.sumSq - (uint64_t)r.sum * r.sum) < n * (n - 1)) gained = 0;
+  return BoardAdc::BITS + gained;
+}
+
+// floor(sqrt(v)) bit by bit: no float math on the Mega
+static uint32_t isqrt(uint64_t v) {
+  uint64_t root = 0;
+  uint64_t bit = 1ULL << 62;
+  while (bit > v) bit >>= 2;
+  while (bit) {
+    if (v >= root + bit) {
+      v -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+// RESSTAT ON: ":<pin>N:<samples>:<pin>SD:<counts, 1 decimal>:<pin>MIN:..:<pin>MAX:..:<pin>OUT:.."
+static void replyStat(const char *pin, const char *key) {
+  replyChar(':');
+  replyAdd(pin);
+  replyAdd(key);
+  replyChar(':');
+}
+
+void CableTester::formatReadingStats(const char *pin, uint8_t slot) {
+  const AdcBurst &r = job.reading[slot];
+  if (!resStats || r.count == 0) return;
+  uint64_t n = r.count;
+  uint32_t sd10 = n < 2 ? 0 : isqrt(100 * (n * r.sumSq - (uint64_t)r.sum * r.sum) / (n * (n - 1)));
+  replyStat(pin, "N");
+  replyUInt(r.count);
+  replyStat(pin, "SD");
+  replyUInt(sd10 / 10);
+  replyChar('.');
+  replyChar('0' + sd10 % 10);
+  replyStat(pin, "MIN");
+  replyUInt(r.min);
+  replyStat(pin, "MAX");
+  replyUInt(r.max);
+  replyStat(pin, "OUT");
+  replyUInt(r.outliers);
+}
+
+// ===== BASELINE TRACKING =====
+// The sense divider is read against the same rail that drives it, so the
+// supply cancels out of a reading except through the transistor's fixed
+// Vce(sat): the headroom ADC_MAX - cal scales with (V - Vce) / V. Each
+// baseline keeps the supply measured at CAL and is rescaled to the rolling
+// supply estimate (serviceSupply(), idle only) without a new CAL.
+//
+// Fixture contact resistance can only be seen falling: a cable can't read
+// below zero ohms, so a reading under the baseline means the baseline is
+// high. trackBaseline() moves it a quarter of the way down each time (up
+// to CAL_REZERO_MAX_MOHM). A rising contact resistance needs a CAL; STATUS
+// flags it once a baseline has moved CAL_DRIFT_WARN_MOHM.
+void CableTester::setBaseline(Baseline &b, int calADC, uint16_t calMv) {
+  b.calADC = calADC;
+  b.calMv = calMv;
+  b.rezero = 0;
+  b.adc = -1;
+  updateBaseline(b, supplyMv);
+}
+
+// Effective baseline for supply nowMv; calScale() only reruns on a change
+void CableTester::updateBaseline(Baseline &b, uint16_t nowMv) {
+  long headroom = ADC_MAX - b.calADC;
+  if (b.calMv > VCE_SAT_MV && nowMv > VCE_SAT_MV && nowMv != b.calMv) {
+    // Q16 (now - Vce) / now * cal / (cal - Vce), rounded; every step fits 32 bits
+    uint32_t ratio = ((uint32_t)(nowMv - VCE_SAT_MV) << 16) / nowMv;
+    ratio = (ratio * b.calMv + (b.calMv - VCE_SAT_MV) / 2) / (b.calMv - VCE_SAT_MV);
+    headroom = (headroom * ratio + 0x8000) >> 16;
+  }
+  int adc = ADC_MAX - headroom + b.rezero;
+  if (adc < 0) adc = 0;
+  if (adc == b.adc) return;
+  b.adc = adc;
+  b.scale = calScale(adc);
+}
+
+void CableTester::trackBaseline(Baseline &b, int reading, uint16_t nowMv) {
+  int below = b.adc - reading;
+  if (below <= ADC_SETTLE_TOL) return;
+  int step = below / 4 > 0 ? below / 4 : 1;
+  Baseline next = b;
+  next.rezero -= step;
+  updateBaseline(next, nowMv);
+  if (baselineDrift(next) >= -CAL_REZERO_MAX_MOHM) b = next;
+}
+
+// Signed baseline shift since CAL, in milliohms of cable
+long CableTester::baselineDrift(const Baseline &b) {
+  long counts = b.adc - b.calADC;
+  long mohm = ((uint32_t)(counts < 0 ? -counts : counts) * b.scale) >> CAL_SCALE_SHIFT;
+  return counts < 0 ? -mohm : mohm;
+}
+
+// Before evaluating a finished resistance test
+void CableTester::trackReadings() {
+  switch (job.kind) {
+    case TEST_RES:
+    case TEST_FULL:
+      if (isCalibrated && job.adcCount > 0) trackBaseline(tsBase, job.adc[0], supplyMv);
+      break;
+    case TEST_XRES:
+    case TEST_XFULL:
+    case TEST_XFULL_SHELL:
+      // A FAST stop can leave either reading unmeasured
+      if (isXlrCalibrated && job.adcCount > 0) trackBaseline(p2Base, job.adc[0], supplyMv);
+      if (isXlrCalibrated && job.adcCount > 1) trackBaseline(p3Base, job.adc[1], supplyMv);
+      break;
+    default:
+      break;
+  }
+}
+
+// Rolling supply estimate (a quarter of each new reading), idle only
+void CableTester::serviceSupply() {
+  if (job.active || millis() - supplyLastPoll < SUPPLY_POLL_MS) return;
+  supplyLastPoll = millis();
+  uint16_t mv = readSupplyMv();
+  if (mv == 0) return;
+  supplyMv = supplyMv ? supplyMv + ((long)mv - supplyMv) / 4 : mv;
+  if (isCalibrated) updateBaseline(tsBase, supplyMv);
+  if (isXlrCalibrated) {
+    updateBaseline(p2Base, supplyMv);
+    updateBaseline(p3Base, supplyMv);
+  }
+}
+
+// EVENT:DRIFT:<path>:<mohm> once per baseline as it moves past
+// CAL_DRIFT_WARN_MOHM, idle only; a CAL/XCAL that brings it back re-arms it
+void CableTester::serviceDrift() {
+  if (job.active) return;
+  const Baseline *bases[] = {&tsBase, &p2Base, &p3Base};
+  for (uint8_t i = 0; i < 3; i++) {
+    uint8_t bit = 1 << i;
+    bool calibrated = i == 0 ? isCalibrated : isXlrCalibrated;
+    long drift = calibrated ? baselineDrift(*bases[i]) : 0;
+    if (labs(drift) <= CAL_DRIFT_WARN_MOHM) {
+      driftWarned &= ~bit;
+    } else if (!(driftWarned & bit)) {
+      driftWarned |= bit;
+      replyBegin("DRIFT:");
+      replyAdd(DRIFT_PATHS[i]);
+      replyChar(':');
+      replyInt(drift);
+      sendEvent();
+    }
+  }
+}
+
+// ===== CIRCUIT =====
+void CableTester::resetCircuit() {
+  // All relays and test outputs off
+  for (uint8_t pin : OUTPUT_PINS) pinWrite(pin, LOW);
+}
+
+// XLR tests float unused drives; a cancelled test may leave them high-Z
+void CableTester::restoreDrivePins() {
+  drive(XD_ALL, LOW);
+}
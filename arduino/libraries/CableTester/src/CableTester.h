@@ -0,0 +1,686 @@
+/*
+ * CableTester.h - Shared test engine for the Greenlight TS/XLR cable testers
+ *
+ * Both testers run this one code path: the step programs, scheduler and
+ * test queue, tagged batches, AUTO and FLEX modes, result evaluation,
+ * response formatting and calibration. Board differences (pin map, ADC width,
+ * supply voltage, fast I/O) are compile-time traits, see BoardTraits.h.
+ * Sketch differences (transport, display, board-only commands) live in a
+ * CableTester subclass in the sketch:
+ *
+ *   cable_tester.ino  Mega 2560: USB serial, RGB result LED
+ *   sketch.ino        UNO Q: Router Bridge RPC, LED matrix
+ *
+ * The subclass implements sendReply() / sendRecord() / showResult(), calls
+ * begin() from setup() and handleCommand() / poll() from loop(). Every
+ * response, including a test's result when its program completes, goes out
+ * through sendReply().
+ *
+ * Tests are programs: a list of step segments (drive pin, settle, sample,
+ * release) run cooperatively from poll(). serviceTest() executes steps
+ * until it reaches one that has to wait and returns immediately, so the
+ * sketch keeps reading commands and animating its display during a
+ * measurement, and commands can be queued or cancelled while a test is in
+ * progress.
+ *
+ * Multi-head (TEST HEADS in BoardTraits.h): the sketch's tester is head 1
+ * and attachHead() adds one instance per chained head. Head 1 routes
+ * "H<n>:<cmd>" to head n and polls every head, so each runs its own test
+ * and queue and their waits interleave; the sketch sends a head's replies
+ * behind "H<n>:".
+ */
+
+#ifndef CABLE_TESTER_H
+#define CABLE_TESTER_H
+
+#include <Arduino.h>
+#include "BoardTraits.h"
+#include "Reply.h"
+
+// Step segments are flash tables on the Mega; elsewhere plain const data
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#else
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#ifndef memcpy_P
+#define memcpy_P memcpy
+#endif
+#endif
+
+// ===== CONFIGURATION =====
+const int RELAY_SETTLE_MS = 10;     // Relay armature travel (fixed); line drain timeout
+const int SIGNAL_SETTLE_MS = 50;    // Sense settle timeout
+
+// AUTO mode cable detection (~1% probe duty)
+const unsigned long AUTO_POLL_MS = 50;
+const unsigned int AUTO_PROBE_US = 500;  // Drive-to-read time; raise if :SETTLE: reports more
+const uint8_t AUTO_DEBOUNCE = 3;         // Agreeing probes before insert/remove counts
+
+// FLEX mode: one connector's continuity drives stay on while the cable is
+// flexed, and the board samples the sense inputs every FLEX_SAMPLE_US
+// (see BoardTraits.h). Changes in the first RELAY_SETTLE_MS are the drives
+// and relays settling, not the cable.
+const uint8_t FLEX_EDGES_PER_POLL = 8;   // Sense changes handled per poll()
+
+// Adaptive settle: after a drive change, poll the sense inputs until
+// SETTLE_AGREE successive readings (SETTLE_POLL_US apart) agree, instead of
+// always waiting the full timeout. Relay moves can't be observed from the
+// sense lines, so those stay fixed RELAY_SETTLE_MS waits.
+// (ADC_SETTLE_TOL is per board, see BoardTraits.h.)
+const uint8_t SETTLE_AGREE = 8;
+const unsigned long SETTLE_POLL_US = 25;
+
+// Resistance test config (ADC_MAX, SUPPLY_VOLTAGE and the ADC thresholds
+// are per board). Resistances are integer milliohms throughout.
+constexpr long MAX_CABLE_MOHM = 1000;        // Max cable resistance to pass (1Ω)
+constexpr long RES_SENSE_MOHM = 20000;       // High-side sense resistor (20Ω)
+constexpr long VCE_SAT_MV = 300;             // PN2222A saturation voltage estimate
+// Base: D6 → 330Ω → base. Emitter grounded, so Ib ≈ 12mA — solid drive, no degeneration.
+
+// Baseline tracking (see BASELINE TRACKING in CableTester.cpp)
+const unsigned long SUPPLY_POLL_MS = 1000;   // Idle supply measurement interval
+constexpr long CAL_DRIFT_WARN_MOHM = 100;    // STATUS warns past this baseline shift
+constexpr long CAL_REZERO_MAX_MOHM = 200;    // Re-zeroing stops this far below CAL
+
+// ===== TEST RESULTS =====
+struct TestResults {
+  // Raw readings
+  bool tipToTip;       // Signal sent to TIP, read on TIP_SENSE
+  bool tipToSleeve;    // Signal sent to TIP, read on SLEEVE_SENSE
+  bool sleeveToSleeve; // Signal sent to SLEEVE, read on SLEEVE_SENSE
+  bool sleeveToTip;    // Signal sent to SLEEVE, read on TIP_SENSE
+  // Interpreted results
+  bool overallPass;
+  bool reversed;
+  bool shorted;
+  bool openTip;
+  bool openSleeve;
+};
+
+struct XlrContResults {
+  // 3x3 continuity matrix: [drive][sense]
+  // Index 0=pin1, 1=pin2, 2=pin3
+  bool p[3][3];
+  bool overallPass;
+};
+
+struct XlrShellResults {
+  bool nearShellBond;   // drive shell, sense pin1
+  bool farShellBond;    // drive pin1, sense shell
+  bool shellToShell;    // drive shell, sense shell
+  bool shellToP2;       // shell shorted to pin2
+  bool shellToP3;       // shell shorted to pin3
+  bool overallPass;
+};
+
+// showResult() codes
+#define SHOW_OFF    0
+#define SHOW_PASS   1
+#define SHOW_FAIL   2
+#define SHOW_ERROR  3
+
+// ===== TEST PROGRAMS =====
+enum StepOp {
+  OP_END,      // End of segment
+  OP_WRITE,    // digitalWrite(pin, val)
+  OP_MODE,     // pinMode(pin, val)
+  OP_WAIT,     // Wait arg ms
+  OP_SETTLE,   // Wait until the next READ group / ADC input (pin RES_SENSE: A0) is stable, arg ms max
+  OP_READ,     // Sense bit val = sense input pin (a SENSE_* mask) from readSense()
+  OP_XDRIVE,   // XLR drives in mask pin = level val, all other XLR drives high-Z
+  OP_ADC,      // Next ADC slot = mean of an arg-sample burst (adcStart()); val 1 = shorter in BURST mode
+  OP_RESET,    // resetCircuit()
+  OP_CHECK     // Checks arg (CK_*) are measured; FAST stops here if one failed
+};
+
+struct TestStep {
+  uint8_t op;
+  uint8_t pin;
+  uint8_t val;
+  uint16_t arg;
+};
+
+#define STEP_WRITE(pin, level)     {OP_WRITE, (pin), (level), 0}
+#define STEP_MODE(pin, mode)       {OP_MODE, (pin), (mode), 0}
+#define STEP_WAIT(ms)              {OP_WAIT, 0, 0, (ms)}
+#define STEP_SETTLE(ms)            {OP_SETTLE, 0, 1, (ms)}   // Settle time is reported
+#define STEP_DRAIN(ms)             {OP_SETTLE, 0, 0, (ms)}   // Release after a drive, not reported
+#define STEP_READ(sense, bit)      {OP_READ, (sense), (bit), 0}
+#define STEP_XDRIVE(lines, level)  {OP_XDRIVE, (lines), (level), 0}
+#define STEP_RES_DRAIN(ms)         {OP_SETTLE, RES_SENSE, 0, (ms)}   // Until A0 is back at rest
+#define STEP_ADC(count)            {OP_ADC, RES_SENSE, 0, (count)}
+#define STEP_RES_ADC()             {OP_ADC, RES_SENSE, 1, RES_SAMPLES}   // RES_BURST_SAMPLES in BURST mode
+#define STEP_RESET()               {OP_RESET, 0, 0, 0}
+#define STEP_CHECK(checks)         {OP_CHECK, 0, 0, (checks)}
+#define STEP_END()                 {OP_END, 0, 0, 0}
+
+// Sense result bits (index into job.bits)
+#define BIT_TT          0    // Drive TIP, sense TIP
+#define BIT_TS          1    // Drive TIP, sense SLEEVE
+#define BIT_SS          2    // Drive SLEEVE, sense SLEEVE
+#define BIT_ST          3    // Drive SLEEVE, sense TIP
+#define BIT_XP(d, s)    (4 + (d) * 3 + (s))   // XLR matrix p[d][s], bits 4-12
+#define BIT_FAR         13   // Drive pin1, sense shell
+#define BIT_NEAR        14   // Drive shell, sense pin1
+#define BIT_SH_P2       15   // Drive shell, sense pin2
+#define BIT_SH_P3       16   // Drive shell, sense pin3
+#define BIT_SH_SH       17   // Drive shell, sense shell
+#define BIT_SKIP        20   // Bits 20-29: CK_* checks FAST skipped (binary record)
+
+// Checks (STEP_CHECK): what one drive or ADC reading decides. In FAST mode
+// (FAST ON, or "<test> FAST") the first failing check ends the test: the
+// program jumps to its last segment (the reset) and every check it
+// passed over is reported as skipped.
+#define CK_TIP          0x001   // Drive TIP: TT, TS
+#define CK_SLEEVE       0x002   // Drive SLEEVE: SS, ST
+#define CK_RES          0x004   // TS resistance
+#define CK_P1           0x008   // Drive XLR pin 1/2/3: its matrix row
+#define CK_P2           0x010
+#define CK_P3           0x020
+#define CK_FAR          0x040   // Drive pin 1, sense shell
+#define CK_NEAR         0x080   // Drive shell: near bond, shell shorts
+#define CK_P2RES        0x100   // XLR pin 2 / pin 3 resistance
+#define CK_P3RES        0x200
+#define CK_CONT_ALL     (CK_TIP | CK_SLEEVE)
+#define CK_XCONT_ALL    (CK_P1 | CK_P2 | CK_P3)
+#define CK_XSHELL_ALL   (CK_FAR | CK_NEAR)
+#define CK_XRES_ALL     (CK_P2RES | CK_P3RES)
+
+// Resistance sampling: readings and calibration (Mega: ~13 ms / ~53 ms at ADC_PRESCALE 7).
+// BURST ON shortens each reading's capture, and so the time RES_TEST_OUT
+// heats the sense resistor and transistor, to RES_BURST_SAMPLES (~3.3 ms);
+// calibration always takes the full CAL_SAMPLES.
+#define RES_SAMPLES          128
+#define RES_BURST_SAMPLES    32
+#define CAL_SAMPLES          512
+// A reading within RES_RESAMPLE_SIGMAS standard errors of the pass limit
+// takes another burst of the same length, up to RES_MAX_SAMPLES in all.
+#define RES_MAX_SAMPLES      512
+#define RES_RESAMPLE_SIGMAS  3
+// OVERSAMPLE <k> keeps k more bits of each reading's mean (decimation)
+// and makes every reading at least 4^k samples; k <= OVERSAMPLE_MAX_BITS.
+#define OVERSAMPLE_MAX_BITS  4
+
+enum TestKind {
+  TEST_CONT, TEST_XCONT, TEST_XSHELL, TEST_RES, TEST_XRES,
+  TEST_CAL, TEST_XCAL, TEST_FULL, TEST_XFULL, TEST_XFULL_SHELL, TEST_BOTH,
+  TEST_KIND_COUNT,
+  TEST_NONE = 0xFF
+};
+
+struct TestDef {
+  const char* cmd;
+  const char* alias;
+  const TestStep* const* program;
+  bool resistance;             // Needs the resistance circuit (head 1 only)
+};
+
+// Indexed by TestKind (TestPrograms.cpp)
+extern const TestDef TEST_DEFS[];
+extern const int NUM_TESTS;
+
+// ===== BINARY RESULTS =====
+// With binaryResults set, each test result goes to sendRecord() as a packed
+// record instead of a text line (other responses stay text). Little-endian:
+//   magic 0xB1, kind (TestKind), flags (RF_*), bits u32 (BIT_* sense matrix),
+//   adc u16 x2, cal u16 x2, milliohms u32 x2, settle count, settle us u16 x n
+#define BIN_MAGIC        0xB1
+#define BIN_MAX_RECORD   (24 + 2 * 8)
+#define RF_PASS          0x01   // Overall pass (CAL/XCAL: baseline stored)
+#define RF_CONT_PASS     0x02
+#define RF_SHELL_PASS    0x04
+#define RF_RES_PASS      0x08
+#define RF_CALIBRATED    0x10   // cal / milliohm fields are valid
+
+// ===== PROFILING =====
+// Every completed test adds one duration per phase to its command's
+// profile (PROFILE, PROFILE <cmd>, PROFILE RESET). Octave bins: bin i holds
+// [2^(i+3), 2^(i+4)) us, bin 0 everything under 16 us and the last bin
+// everything from 262 ms up. When a bin would overflow all of them halve,
+// so the shape keeps following recent tests. TEST_KIND_COUNT * PH_COUNT
+// PhaseProfiles of 26 bytes: ~2 KB. Build with -DCABLE_TESTER_PROFILE=0 to
+// leave the table out; PROFILE then answers ERROR:UNKNOWN_CMD.
+#ifndef CABLE_TESTER_PROFILE
+#define CABLE_TESTER_PROFILE 1
+#endif
+
+enum ProfilePhase {
+  PH_SWITCH,   // Drive/relay writes and fixed relay waits
+  PH_SETTLE,   // OP_SETTLE: sense/ADC settle and line drain
+  PH_SAMPLE,   // READ snapshots and ADC bursts
+  PH_EVAL,     // evaluateTest(), including showResult()
+  PH_FORMAT,   // Text response or binary record
+  PH_SEND,     // sendReply() / sendRecord()
+  PH_TOTAL,    // First step to sent
+  PH_COUNT
+};
+
+#define PROFILE_BINS  16
+
+struct PhaseProfile {
+  uint32_t minUs;
+  uint32_t maxUs;
+  uint16_t count;              // Tests since PROFILE RESET (saturates)
+  uint8_t bins[PROFILE_BINS];
+};
+
+// ===== STORED CALIBRATION =====
+// Passing CAL/XCAL readings are saved as one CalRecord covering both, so a
+// power cycle doesn't cost a recalibration. Saves go round-robin over the
+// board's calSlots() (16 in the Mega EEPROM: each cell takes 1/16 of the
+// writes) and the newest valid seq wins on load. A record that fails its
+// CRC is skipped, so a save torn by a power cut leaves the previous one.
+// Same layout on both boards (little-endian, no padding, 16 bytes).
+#define CAL_MAGIC        0xCB   // 0xCA: 12-byte records without the supply
+#define CALF_TS          0x01   // ts is valid
+#define CALF_XLR         0x02   // p2/p3 are valid
+
+struct CalRecord {
+  uint8_t magic;
+  uint8_t flags;           // CALF_*
+  uint16_t seq;            // Save count, wraps; newest wins
+  int16_t ts;              // TS calADC
+  int16_t p2;              // XLR pin 2 calADC
+  int16_t p3;              // XLR pin 3 calADC
+  uint16_t tsMv;           // Supply at CAL, mV (0 = not measured)
+  uint16_t xlrMv;          // Supply at XCAL
+  uint16_t crc;            // crc16() of the bytes before it
+};
+
+uint16_t crc16(const uint8_t *data, uint8_t len);   // CRC-16/CCITT-FALSE
+
+// ===== SESSION CONFIG =====
+// Head 1's mode settings survive a power cycle as one ConfigRecord
+// (readConfig()/writeConfig(), CRC-checked like a CalRecord): FAST, BURST,
+// RESSTAT, OVERSAMPLE, SETTLE, AUTO and BOOT. poll() saves it when idle
+// after one changes. FORMAT and the baud rate belong to the host link and
+// start from their defaults. Same layout on both boards (6 bytes).
+#define CONFIG_MAGIC     0xC6
+#define CFGF_FAST        0x01   // FAST ON
+#define CFGF_BURST       0x02   // BURST ON
+#define CFGF_RESSTAT     0x04   // RESSTAT ON
+#define CFGF_SETTLE      0x08   // SETTLE FIXED
+#define CFGF_AUTO_FAST   0x10   // AUTO <test> FAST
+#define CFGF_BOOT_FAST   0x20   // BOOT FAST
+
+struct ConfigRecord {
+  uint8_t magic;
+  uint8_t flags;           // CFGF_*
+  uint8_t overBits;        // OVERSAMPLE, 0 = OFF
+  uint8_t autoTest;        // AUTO test, TEST_NONE = off
+  uint16_t crc;            // crc16() of the bytes before it
+};
+
+// ===== WEAR COUNTERS =====
+// Every head counts its relay pull-ins, the cables AUTO saw go in and the
+// passes/fails of each test command (STATS), so worn relays and jacks can
+// be replaced on schedule. Head 1 writes each head's counters back as one
+// StatsRecord, round-robin over that head's share of statsSlots() (newest
+// valid seq wins, as for a CalRecord), once STATS_SAVE_MS (10 min) has
+// passed since its first unsaved count: a busy fixture costs one slot
+// write per head per 10 minutes rather than one per test, and a power cut
+// loses at most that much. STATS SAVE writes sooner. Same layout on both
+// boards (120 bytes).
+#define STATS_MAGIC      0x58   // 0x57: 112-byte records from before BOTH
+#define STATS_SAVE_MS    600000UL
+
+struct StatsRecord {
+  uint8_t magic;
+  uint8_t head;                      // Test head, 1..HEAD_COUNT
+  uint16_t seq;                      // This head's save count, wraps; newest wins
+  uint32_t relays[RELAY_COUNT];      // Pull-ins, OUTPUT_PINS order (K1+K2, K3 .. K6)
+  uint32_t inserts;                  // Cables AUTO saw go in
+  uint32_t pass[TEST_KIND_COUNT];    // Per TestKind (CAL/XCAL: baseline stored)
+  uint32_t fail[TEST_KIND_COUNT];
+  uint16_t resets;                   // STATS RESETs (fixture parts replaced)
+  uint16_t crc;                      // crc16() of the bytes before it
+};
+
+// sendReply() tag for AUTO mode events (batch tags are 1-65534)
+#define TAG_AUTO  0xFFFF
+
+bool cmdIs(const char *cmd, const char *name);
+void normalizeCommand(char *cmd);   // Trim and uppercase in place
+
+class CableTester {
+public:
+  // Pin setup, idle circuit, stored calibration and config, then the
+  // circuit check and (unless BOOT FAST) selfTest(); the result is
+  // isReady(). Head 1 also begins the attached heads.
+  bool begin();
+
+  // Head 1 only, before begin(): `other` becomes the next head (2, 3, ...)
+  // on the head chain. Returns false past HEAD_COUNT.
+  bool attachHead(CableTester &other);
+  uint8_t head() const { return headNo; }
+
+  // One command line or "#<tag> <cmd>;<cmd>..." batch, parsed in place.
+  // Test commands start now when idle, otherwise they queue behind the
+  // running test; each answers through sendReply() when it completes.
+  void handleCommand(char *cmd);
+
+  // From loop(): AUTO probing while idle, then advance the running test
+  // (on every head)
+  void poll();
+
+  bool isReady() const { return systemReady; }
+  // Line that failed the power-on circuit check, NULL = none
+  const char *bootFault() const { return circuitFault; }
+  bool isFastBoot() const { return bootFast; }
+  bool isTestRunning() const { return job.active; }
+  bool isFlexRunning() const { return flexLines != 0; }
+
+  // Send replyBuf, tagged with the batch being handled (if any)
+  void replySend();
+
+  // Test results go to sendRecord(); read when each test starts
+  bool binaryResults = false;
+
+  // Rolling supply estimate in mV (readSupplyMv() while idle); 0 = not
+  // measured yet
+  uint16_t getSupplyVoltage() const { return supplyMv; }
+
+  // Newest valid record in calSlots(), if any (begin() calls this)
+  bool loadCalibration();
+  // Save the current calibration to the next slot. Done from poll() once
+  // a CAL/XCAL passes and no test is running.
+  bool saveCalibration();
+  // Apply a record fetched by the sketch (UNO Q: pushed from the MPU).
+  // ageSeconds: how old it was when fetched. Ignored once this boot has
+  // calibrated.
+  bool restoreCalibration(const uint8_t *data, uint8_t len, unsigned long ageSeconds);
+  // Apply a ConfigRecord fetched by the sketch (UNO Q: pushed from the
+  // MPU). Ignored once this boot has saved one.
+  bool restoreConfig(const uint8_t *data, uint8_t len);
+  // Add a StatsRecord fetched by the sketch (UNO Q: pushed from the MPU)
+  // to what head 1 counted since boot. Ignored once one is stored.
+  bool restoreStats(const uint8_t *data, uint8_t len);
+
+protected:
+  // --- Sketch hooks ---
+  // Deliver replyBuf as one response. tag: 0 = none, TAG_AUTO = AUTO
+  // event, otherwise the batch it belongs to
+  virtual void sendReply(uint16_t tag) = 0;
+  // Deliver a finished test as a binary record (see BINARY RESULTS)
+  virtual void sendRecord(uint16_t tag, const uint8_t *record, uint8_t len) = 0;
+  // Show SHOW_* on the board's display
+  virtual void showResult(uint8_t result) = 0;
+  // Power-on display check, skipped with BOOT FAST; false leaves the
+  // tester NOT_READY
+  virtual bool selfTest() { return true; }
+  // Board-only commands, tried before the shared debug commands (head 1
+  // only). Returns false if cmd isn't one (ERROR:UNKNOWN_CMD).
+  virtual bool boardCommand(const char *cmd) { (void)cmd; return false; }
+  // Commands that only observe pin state and are safe mid-test
+  virtual bool isReadOnlyCommand(const char *cmd);
+  // A test is about to run its first step
+  virtual void testStarted(uint8_t kind, uint16_t tag) { (void)kind; (void)tag; }
+  // ID or STATUS arrived
+  virtual void hostSeen() {}
+  // AUTO saw a cable go in or come out: EVENT:INSERTED / EVENT:REMOVED
+  virtual void cableChanged(bool present);
+  // replyBuf is an event that isn't a test result (INSERTED/REMOVED,
+  // DRIFT)
+  virtual void sendEvent() { sendReply(TAG_AUTO); }
+  // Every test of batch `tag` has answered: #<tag>:END
+  virtual void sendBatchEnd(uint16_t tag);
+  // Calibration storage (see STORED CALIBRATION): slot count (0 = RAM
+  // only), slot read/write, and its name for CALINFO. readCalSlot()
+  // returns false for an empty or unreadable slot; the CRC is checked here.
+  virtual uint8_t calSlots() { return 0; }
+  virtual bool readCalSlot(uint8_t slot, CalRecord &rec) { (void)slot; (void)rec; return false; }
+  virtual bool writeCalSlot(uint8_t slot, const CalRecord &rec) { (void)slot; (void)rec; return false; }
+  virtual const char *calStorage() { return "RAM"; }
+  // Session config storage (see SESSION CONFIG), false = none or unreadable
+  virtual bool readConfig(ConfigRecord &rec) { (void)rec; return false; }
+  virtual bool writeConfig(const ConfigRecord &rec) { (void)rec; return false; }
+  // Wear counter storage (see WEAR COUNTERS), shared by every head; slots
+  // as for calibration
+  virtual uint8_t statsSlots() { return 0; }
+  virtual bool readStatsSlot(uint8_t slot, StatsRecord &rec) { (void)slot; (void)rec; return false; }
+  virtual bool writeStatsSlot(uint8_t slot, const StatsRecord &rec) { (void)slot; (void)rec; return false; }
+
+  uint8_t autoTest = TEST_NONE;        // Test run on insertion, TEST_NONE = off
+  bool autoFast = false;               // "AUTO <test> FAST"
+
+private:
+  // Running test state
+  struct TestJob {
+    bool active;
+    uint8_t kind;
+    uint16_t tag;            // Batch the test came from, 0 = none
+    bool binary;             // Result goes to sendRecord()
+    const TestStep* const* program;
+    uint8_t seg;             // Current segment in program
+    uint8_t idx;             // Current step in segment
+    bool waiting;
+    unsigned long waitStart; // micros() when the current wait began
+    unsigned long waitUs;
+    bool adcStarted;         // Current OP_ADC burst is running
+    uint8_t adcCount;        // ADC slots filled so far
+    int adc[2];              // TS/P2 reading, P3 reading
+    AdcBurst reading[2];     // Every burst of each ADC slot, summed
+    uint8_t overBits;        // OVERSAMPLE bits the test runs with
+    long fine[2];            // adc[] in 1/2^overBits counts
+    bool settling;           // OP_SETTLE in progress
+    unsigned long settleStart;
+    unsigned long runStart;  // Offset of the first reading in the agreeing run
+    uint8_t runLength;
+    int runValue;            // Sense pattern (digital) or ADC reading of the run
+    uint8_t senseMask;       // SENSE_* inputs polled by the current OP_SETTLE
+    bool senseAnalog;
+    uint8_t snap;            // readSense() snapshot shared by a READ group
+    bool snapValid;
+    uint8_t settleCount;     // Reported settle slots filled so far
+    unsigned long settleUs[8];
+    uint32_t bits;           // Sense results, see BIT_*
+    bool fast;               // Stop at the first failing check
+    uint16_t skipped;        // CK_* never measured (FAST stop)
+    unsigned long startUs;   // micros() at the first step
+    unsigned long phaseMark; // micros() when the phase being timed began
+    unsigned long phaseUs[PH_COUNT];
+  };
+
+  // Tests waiting behind the running one. A TEST_NONE entry marks the end
+  // of a batch (sendBatchEnd() when reached).
+  struct QueuedTest {
+    uint8_t kind;
+    uint16_t tag;
+    bool fast;               // "<test> FAST"
+  };
+
+  static const int TEST_QUEUE_SIZE = 8;
+
+  // Zero-ohm reference for one resistance path (TS, XLR pin 2, XLR pin 3).
+  // Readings compare against adc: calADC corrected for the supply having
+  // moved since CAL and for re-zeroing (see BASELINE TRACKING).
+  struct Baseline {
+    int calADC;              // Reading at CAL/XCAL
+    uint16_t calMv;          // Supply then, mV
+    int rezero;              // Learned correction, counts (<= 0)
+    int adc;                 // Effective baseline
+    uint32_t scale;          // calScale(adc)
+  };
+
+  uint8_t headNo = 1;
+  CableTester *heads[HEAD_COUNT] = {this};  // Head 1: head n is heads[n - 1], as attached
+  uint8_t headCount = 1;
+
+  bool systemReady = false;
+  bool adaptiveSettle = true;         // SETTLE FIXED restores the full waits
+  bool fastMode = false;              // FAST ON: every test stops at its first failing check
+  bool burstMode = false;             // BURST ON: resistance readings take RES_BURST_SAMPLES
+  bool resStats = false;              // RESSTAT ON: RES/XRES report each reading's statistics
+  uint8_t overBits = 0;               // OVERSAMPLE <k>: resistance readings keep k extra bits
+  bool bootFast = false;              // BOOT FAST: no selfTest() display check at power-on
+  const char *circuitFault = NULL;    // Line circuitCheck() failed on
+  ConfigRecord savedConfig = {};      // Stored (or default) config; poll() saves on a difference
+  bool configSaved = false;           // A config was saved this boot
+  uint16_t replyTag = 0;              // Batch being handled, 0 = none
+
+  TestJob job;
+  QueuedTest testQueue[TEST_QUEUE_SIZE];
+  uint8_t testQueueHead = 0;
+  uint8_t testQueueCount = 0;
+
+#if CABLE_TESTER_PROFILE
+  // Shared by the heads (same programs); head 1's begin() clears it
+  static PhaseProfile profiles[TEST_KIND_COUNT][PH_COUNT];
+#endif
+
+  // FLEX mode
+  uint8_t flexLines = 0;               // SENSE_* inputs watched, 0 = off
+  uint8_t flexLevel = 0;               // Sense snapshot as of the last change
+  uint8_t flexDropping = 0;            // Lines low since flexDropTick after being high
+  uint32_t flexDropTick[sizeof(SENSE_PINS)];
+  uint16_t flexDrops[sizeof(SENSE_PINS)];   // Dropouts per line (saturates)
+  uint32_t flexLongest = 0;            // Ticks
+
+  // AUTO mode
+  bool autoPresent = false;            // Debounced probe state
+  uint8_t autoCount = 0;               // Successive probes disagreeing with autoPresent
+  unsigned long autoLastPoll = 0;
+
+  // Calibration (saved through calSlots(), see STORED CALIBRATION)
+  Baseline tsBase = {};                // TS reading with zero-ohm reference
+  bool isCalibrated = false;
+  Baseline p2Base = {};                // XLR pins 2 and 3, each through its own relay path
+  Baseline p3Base = {};
+  bool isXlrCalibrated = false;
+  uint16_t supplyMv = 0;
+  unsigned long supplyLastPoll = 0;
+  const char *calSource = "NONE";      // CAL = measured this boot, else calStorage() it came from
+  unsigned long calSetAt = 0;          // millis() when measured or loaded
+  unsigned long calAgeBase = 0;        // Seconds old when loaded
+  bool calStored = false;              // calSlot/calSeq hold the newest stored record
+  uint8_t calSlot = 0;
+  uint16_t calSeq = 0;
+  bool calInStore = false;             // The active calibration is that record
+  bool calDirty = false;               // Measured; poll() saves it when idle
+  uint8_t driftWarned = 0;             // Baselines already reported by serviceDrift(), 1 << path
+
+  // Wear counters (see WEAR COUNTERS); head 1 saves every head's
+  StatsRecord stats = {};              // Counts; seq is the stored record's
+  uint8_t relayLevels = 0;             // Relays pulled in, bit i = OUTPUT_PINS[i]
+  bool statsStored = false;            // statsSlot/stats.seq hold the newest stored record
+  uint8_t statsSlot = 0;
+  bool statsDirty = false;             // Counted since the last save
+  bool statsSaveNow = false;           // STATS SAVE/RESET: don't wait for STATS_SAVE_MS
+  unsigned long statsChangedAt = 0;    // millis() of the first unsaved count
+
+  // Fixture I/O on this head: the board pins, or the head chain
+  void pinWrite(uint8_t pin, uint8_t level);
+  void pinSetMode(uint8_t pin, uint8_t mode);
+  uint8_t pinLevel(uint8_t pin);
+  uint8_t senseNow();
+  void drive(uint8_t lines, uint8_t level);
+
+  // Commands
+  bool routeToHead(char *cmd);
+  void handleBatch(char *line);
+  bool isBatchPending(uint16_t tag);
+  bool handleToggle(const char *cmd);
+  void sendStatus();
+
+  // AUTO mode
+  static bool isXlrTest(uint8_t kind);
+  void setAuto(uint8_t kind);
+  bool isCableInserted();
+  void serviceAuto();
+
+  // FLEX mode
+  void startFlex(uint8_t lines);
+  void stopFlex();
+  void serviceFlex(uint8_t maxEdges);
+  void flexDropout(uint8_t line, uint32_t startTick, uint32_t ticks);
+  void sendFlexStatus(const char *state);
+
+  // Scheduler
+  static uint8_t testKindForCommand(const char *cmd);
+  static uint8_t parseTestCommand(char *cmd, bool &fast);
+  void queueTest(uint8_t kind, bool fast);
+  void startTest(uint8_t kind, uint16_t tag, bool fast);
+  void cancelTests();
+  void startWait(unsigned long us);
+  void serviceTest();
+  void finishTest();
+  bool checkFailed(uint16_t checks);
+  bool checksUndecided(uint16_t checks);
+  void stopTest();
+
+  // Profiling
+  void profilePhase(uint8_t phase);
+  void recordProfile();
+  static uint8_t profileBin(uint32_t us);
+  static uint32_t profilePercentile(const PhaseProfile &p, uint8_t percent);
+  static void formatProfile(const PhaseProfile &p);
+  void sendProfile(const char *arg);
+
+  // Adaptive settle
+  void findSettleSense();
+  int readSettleSense();
+  bool serviceSettle(const TestStep &step);
+  void formatSettle(uint8_t first, uint8_t count);
+  void formatSkipped(uint16_t checks);
+
+  // Evaluation and formatting
+  bool jobBit(uint8_t bit);
+  void decodeContinuity(TestResults &results);
+  void decodeXlrContinuity(XlrContResults &r);
+  void decodeXlrShell(XlrShellResults &r);
+  static bool xlrContAnyConnection(const XlrContResults &r);
+  uint8_t evaluateTest(TestResults &cont, XlrContResults &xcont, XlrShellResults &shell);
+  void buildTestResponse(uint8_t flags, const TestResults &cont, const XlrContResults &xcont,
+                         const XlrShellResults &shell);
+  uint8_t packTestResult(uint8_t flags, uint8_t *buf);
+  static uint8_t putLE(uint8_t *buf, uint8_t pos, uint32_t value, uint8_t bytes);
+  void formatResults(const TestResults &r);
+  void formatXlrContResults(const XlrContResults &r);
+  void formatXlrShellResults(const XlrShellResults &r);
+
+  // Calibration and resistance
+  bool storeCalibration(int measuredADC);
+  bool storeXlrCalibration(int measuredP2, int measuredP3);
+  void calibrationChanged();
+  void setBaseline(Baseline &b, int calADC, uint16_t calMv);
+  static void updateBaseline(Baseline &b, uint16_t nowMv);
+  static void trackBaseline(Baseline &b, int reading, uint16_t nowMv);
+  static long baselineDrift(const Baseline &b);
+  void trackReadings();
+  void serviceSupply();
+  void serviceDrift();
+  static bool calRecordValid(const CalRecord &rec);
+  bool circuitCheck();
+  void currentConfig(ConfigRecord &rec);
+  void applyConfig(const ConfigRecord &rec);
+  static bool configRecordValid(const ConfigRecord &rec);
+  bool loadConfig();
+  void serviceConfig();
+  void countStat(uint32_t &counter);
+  static bool statsRecordValid(const StatsRecord &rec);
+  uint8_t statsRing();
+  void loadStats();
+  bool saveStats(CableTester &t);
+  void serviceStats();
+  void handleStats(const char *arg);
+  void applyCalRecord(const CalRecord &rec);
+  void sendCalInfo();
+  static uint32_t calScale(int calADC);
+  static long cableMilliohms(long reading, uint8_t bits, const Baseline &b);
+  static bool resPassCheck(long reading, uint8_t bits, bool calibrated, const Baseline &b);
+  bool xlrResPassCheck();
+  void formatResResult(const char* prefix);
+  void formatXlrResResult();
+  long readingLimit(uint8_t slot);
+  bool readingBorderline(uint8_t slot);
+  uint8_t readingBits(uint8_t slot);
+  void formatReadingStats(const char *pin, uint8_t slot);
+
+  // Circuit
+  void resetCircuit();
+  void restoreDrivePins();
+};
+
+#endif // CABLE_TESTER_H
@@ -0,0 +1,84 @@
+/*
+ * Reply.cpp - Heap-free response writer, see Reply.h
+ */
+
+#include "Reply.h"
+
+char replyBuf[REPLY_SIZE];
+uint16_t replyLen = 0;
+uint16_t replyPeak = 0;
+
+void replyBegin(const char *s) {
+  replyLen = 0;
+  replyBuf[0] = '\0';
+  replyAdd(s);
+}
+
+void replyChar(char c) {
+  if (replyLen >= REPLY_SIZE - 1) return;
+  replyBuf[replyLen++] = c;
+  replyBuf[replyLen] = '\0';
+  if (replyLen > replyPeak) replyPeak = replyLen;
+}
+
+void replyAdd(const char *s) {
+  while (*s) replyChar(*s++);
+}
+
+void replyUInt(unsigned long value) {
+  char digits[10];
+  uint8_t n = 0;
+  do {
+    digits[n++] = '0' + value % 10;
+    value /= 10;
+  } while (value > 0);
+  while (n > 0) replyChar(digits[--n]);
+}
+
+void replyInt(long value) {
+  if (value < 0) {
+    replyChar('-');
+    replyUInt(0UL - (unsigned long)value);
+  } else {
+    replyUInt(value);
+  }
+}
+
+void replyBit(bool value) {
+  replyChar(value ? '1' : '0');
+}
+
+// ":KEY:<value>"
+void replyField(const char *key, long value) {
+  replyChar(':');
+  replyAdd(key);
+  replyChar(':');
+  replyInt(value);
+}
+
+// ":KEY:1" / ":KEY:0"
+void replyFlag(const char *key, bool value) {
+  replyChar(':');
+  replyAdd(key);
+  replyChar(':');
+  replyBit(value);
+}
+
+// Milliohms as ohms with three decimals ("0.450"), no float formatting
+void replyOhms(long milliohms) {
+  if (milliohms < 0) {
+    replyChar('-');
+    milliohms = -milliohms;
+  }
+  replyUInt(milliohms / 1000);
+  replyChar('.');
+  replyChar('0' + milliohms / 100 % 10);
+  replyChar('0' + milliohms / 10 % 10);
+  replyChar('0' + milliohms % 10);
+}
+
+// Comma-separated list item; `start` is replyLen where the list began
+void replyItem(uint16_t start, const char *s) {
+  if (replyLen > start) replyChar(',');
+  replyAdd(s);
+}
@@ -0,0 +1,34 @@
+/*
+ * Reply.h - Heap-free response writer
+ *
+ * Responses are built in one static buffer with the reply*() helpers rather
+ * than Arduino String: String concatenation allocates on every append and
+ * fragments the Mega's 8 KB of SRAM over thousands of tests. Build a
+ * response and send it straight away (CableTester::replySend()); the buffer
+ * isn't held across calls. Text past REPLY_SIZE is dropped (MEM reports the
+ * longest response, so that can be checked).
+ */
+
+#ifndef CABLE_TESTER_REPLY_H
+#define CABLE_TESTER_REPLY_H
+
+#include <Arduino.h>
+
+#define REPLY_SIZE  512
+
+extern char replyBuf[REPLY_SIZE];
+extern uint16_t replyLen;
+extern uint16_t replyPeak;           // Longest response since boot
+
+void replyBegin(const char *s);
+void replyChar(char c);
+void replyAdd(const char *s);
+void replyUInt(unsigned long value);
+void replyInt(long value);
+void replyBit(bool value);
+void replyField(const char *key, long value);   // ":KEY:<value>"
+void replyFlag(const char *key, bool value);    // ":KEY:1" / ":KEY:0"
+void replyOhms(long milliohms);                 // "0.450", no float formatting
+void replyItem(uint16_t start, const char *s);  // Comma-separated list item
+
+#endif // CABLE_TESTER_REPLY_H
@@ -0,0 +1,318 @@
+/*
+ * TestPrograms.cpp - Step programs for every test, indexed by TestKind
+ *
+ * Segments are flash tables on the Mega (PROGMEM, read back with memcpy_P);
+ * pin names come from the board's pin map, so both testers run the same
+ * programs.
+ */
+
+#include "CableTester.h"
+
+// Relays to rest and settle once (K5/K6 LOW = XLR continuity mode)
+const TestStep SEG_REST[] PROGMEM = {
+  STEP_RESET(),
+  STEP_WAIT(RELAY_SETTLE_MS),
+  STEP_END()
+};
+
+const TestStep SEG_RESET[] PROGMEM = {
+  STEP_RESET(),
+  STEP_END()
+};
+
+// K1+K2 continuity mode, then drive TIP and SLEEVE in turn
+const TestStep SEG_TS_CONT[] PROGMEM = {
+  STEP_WRITE(K1_K2_RELAY, HIGH),
+  STEP_WAIT(RELAY_SETTLE_MS),
+  // === TEST 1: SEND SIGNAL TO TIP ===
+  STEP_WRITE(TS_CONT_OUT_TIP, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_READ(SENSE_TS_TIP, BIT_TT),
+  STEP_READ(SENSE_TS_SLEEVE, BIT_TS),
+  STEP_CHECK(CK_TIP),
+  STEP_WRITE(TS_CONT_OUT_TIP, LOW),
+  STEP_DRAIN(RELAY_SETTLE_MS),
+  // === TEST 2: SEND SIGNAL TO SLEEVE ===
+  STEP_WRITE(TS_CONT_OUT_SLEEVE, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_READ(SENSE_TS_SLEEVE, BIT_SS),
+  STEP_READ(SENSE_TS_TIP, BIT_ST),
+  STEP_CHECK(CK_SLEEVE),
+  STEP_WRITE(TS_CONT_OUT_SLEEVE, LOW),
+  STEP_END()
+};
+
+// XLR continuity, 3x3 matrix: pin1, pin2, pin3 only (no shell).
+// Shell bond is tested separately via XSHELL since some connectors have
+// non-conductive coated shells. Each pin is driven with the others high-Z
+// (STEP_XDRIVE floats every XLR drive it isn't driving).
+// Shell drive must be high-Z during pin tests — if a cable has shell
+// bonded to pin1, the shell drive held LOW would fight the pin1 drive signal.
+// Caller leaves K5/K6 LOW (continuity mode).
+const TestStep SEG_XLR_CONT[] PROGMEM = {
+  // Drive pin 1
+  STEP_XDRIVE(XD_PIN1, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_READ(SENSE_XLR_PIN1, BIT_XP(0, 0)),
+  STEP_READ(SENSE_XLR_PIN2, BIT_XP(0, 1)),
+  STEP_READ(SENSE_XLR_PIN3, BIT_XP(0, 2)),
+  STEP_CHECK(CK_P1),
+  STEP_XDRIVE(XD_PIN1, LOW),
+  STEP_DRAIN(RELAY_SETTLE_MS),
+  // Drive pin 2
+  STEP_XDRIVE(XD_PIN2, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_READ(SENSE_XLR_PIN1, BIT_XP(1, 0)),
+  STEP_READ(SENSE_XLR_PIN2, BIT_XP(1, 1)),
+  STEP_READ(SENSE_XLR_PIN3, BIT_XP(1, 2)),
+  STEP_CHECK(CK_P2),
+  STEP_XDRIVE(XD_PIN2, LOW),
+  STEP_DRAIN(RELAY_SETTLE_MS),
+  // Drive pin 3
+  STEP_XDRIVE(XD_PIN3, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_READ(SENSE_XLR_PIN1, BIT_XP(2, 0)),
+  STEP_READ(SENSE_XLR_PIN2, BIT_XP(2, 1)),
+  STEP_READ(SENSE_XLR_PIN3, BIT_XP(2, 2)),
+  STEP_CHECK(CK_P3),
+  STEP_XDRIVE(XD_PIN3, LOW),
+  STEP_DRAIN(RELAY_SETTLE_MS),
+  // Restore all drive pins to OUTPUT LOW for resetCircuit()
+  STEP_XDRIVE(XD_ALL, LOW),
+  STEP_END()
+};
+
+// XLR shell bond at both cable ends. Only usable with uncoated/conductive
+// connector shells; test jacks must have shell UNBONDED from pin 1.
+//   drive pin1 → sense shell = far end shell bond
+//   drive shell → sense pin1 = near end shell bond (+ pin2/pin3 shorts)
+// Caller leaves K5/K6 LOW.
+const TestStep SEG_XLR_SHELL[] PROGMEM = {
+  // --- Drive pin1, read shell (far end bond) ---
+  STEP_XDRIVE(XD_PIN1, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_READ(SENSE_XLR_SHELL, BIT_FAR),
+  STEP_CHECK(CK_FAR),
+  STEP_XDRIVE(XD_PIN1, LOW),
+  STEP_DRAIN(RELAY_SETTLE_MS),
+  // --- Drive shell, read pin1/pin2/pin3/shell (near end bond + shorts) ---
+  STEP_XDRIVE(XD_SHELL, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_READ(SENSE_XLR_PIN1, BIT_NEAR),
+  STEP_READ(SENSE_XLR_PIN2, BIT_SH_P2),
+  STEP_READ(SENSE_XLR_PIN3, BIT_SH_P3),
+  STEP_READ(SENSE_XLR_SHELL, BIT_SH_SH),
+  STEP_CHECK(CK_NEAR),
+  // Restore drive pins to OUTPUT LOW
+  STEP_XDRIVE(XD_ALL, LOW),
+  STEP_END()
+};
+
+// XLR continuity and shell bond in one sweep, for XFULL SHELL: the 3x3
+// matrix drives as SEG_XLR_CONT, the pin 1 drive also reads the shell (far
+// bond), then one shell drive for the near bond and shell shorts. Four
+// drive/settle cycles where SEG_XLR_CONT + SEG_XLR_SHELL take five.
+// Settle slots: pin1, pin2, pin3, shell. Caller leaves K5/K6 LOW.
+const TestStep SEG_XLR_SCAN[] PROGMEM = {
+  // Drive pin 1 (far shell bond from the same snapshot)
+  STEP_XDRIVE(XD_PIN1, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_READ(SENSE_XLR_PIN1, BIT_XP(0, 0)),
+  STEP_READ(SENSE_XLR_PIN2, BIT_XP(0, 1)),
+  STEP_READ(SENSE_XLR_PIN3, BIT_XP(0, 2)),
+  STEP_READ(SENSE_XLR_SHELL, BIT_FAR),
+  STEP_CHECK(CK_P1 | CK_FAR),
+  STEP_XDRIVE(XD_PIN1, LOW),
+  STEP_DRAIN(RELAY_SETTLE_MS),
+  // Drive pin 2
+  STEP_XDRIVE(XD_PIN2, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_READ(SENSE_XLR_PIN1, BIT_XP(1, 0)),
+  STEP_READ(SENSE_XLR_PIN2, BIT_XP(1, 1)),
+  STEP_READ(SENSE_XLR_PIN3, BIT_XP(1, 2)),
+  STEP_CHECK(CK_P2),
+  STEP_XDRIVE(XD_PIN2, LOW),
+  STEP_DRAIN(RELAY_SETTLE_MS),
+  // Drive pin 3
+  STEP_XDRIVE(XD_PIN3, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_READ(SENSE_XLR_PIN1, BIT_XP(2, 0)),
+  STEP_READ(SENSE_XLR_PIN2, BIT_XP(2, 1)),
+  STEP_READ(SENSE_XLR_PIN3, BIT_XP(2, 2)),
+  STEP_CHECK(CK_P3),
+  STEP_XDRIVE(XD_PIN3, LOW),
+  STEP_DRAIN(RELAY_SETTLE_MS),
+  // Drive shell (near bond + pin2/pin3 shorts)
+  STEP_XDRIVE(XD_SHELL, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_READ(SENSE_XLR_PIN1, BIT_NEAR),
+  STEP_READ(SENSE_XLR_PIN2, BIT_SH_P2),
+  STEP_READ(SENSE_XLR_PIN3, BIT_SH_P3),
+  STEP_READ(SENSE_XLR_SHELL, BIT_SH_SH),
+  STEP_CHECK(CK_NEAR),
+  STEP_XDRIVE(XD_ALL, LOW),
+  STEP_END()
+};
+
+// TS and XLR continuity in one scan, for BOTH. The TS and XLR lines are
+// separate circuits, so TIP drives alongside pin 1 and SLEEVE alongside
+// pin 2: each pair shares one settle window and one snapshot. One relay
+// wait and three drive/settle cycles, where CONT then XCONT take two
+// relay waits and five cycles.
+// A wire joining the two cables shows up as a short in one matrix, except
+// TIP to pin 1 or SLEEVE to pin 2 (driven together); test cables wired
+// across the jacks with CONT and XCONT.
+// Settle slots: TIP + pin1, SLEEVE + pin2, pin3.
+const TestStep SEG_BOTH_CONT[] PROGMEM = {
+  // K1+K2 continuity mode, K5/K6 LOW = XLR continuity mode; one relay wait
+  STEP_WRITE(K5_RELAY, LOW),
+  STEP_WRITE(K6_RELAY, LOW),
+  STEP_WRITE(K1_K2_RELAY, HIGH),
+  STEP_WAIT(RELAY_SETTLE_MS),
+  // Drive TIP and pin 1
+  STEP_WRITE(TS_CONT_OUT_TIP, HIGH),
+  STEP_XDRIVE(XD_PIN1, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_READ(SENSE_TS_TIP, BIT_TT),
+  STEP_READ(SENSE_TS_SLEEVE, BIT_TS),
+  STEP_READ(SENSE_XLR_PIN1, BIT_XP(0, 0)),
+  STEP_READ(SENSE_XLR_PIN2, BIT_XP(0, 1)),
+  STEP_READ(SENSE_XLR_PIN3, BIT_XP(0, 2)),
+  STEP_CHECK(CK_TIP | CK_P1),
+  STEP_WRITE(TS_CONT_OUT_TIP, LOW),
+  STEP_XDRIVE(XD_PIN1, LOW),
+  STEP_DRAIN(RELAY_SETTLE_MS),
+  // Drive SLEEVE and pin 2
+  STEP_WRITE(TS_CONT_OUT_SLEEVE, HIGH),
+  STEP_XDRIVE(XD_PIN2, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_READ(SENSE_TS_SLEEVE, BIT_SS),
+  STEP_READ(SENSE_TS_TIP, BIT_ST),
+  STEP_READ(SENSE_XLR_PIN1, BIT_XP(1, 0)),
+  STEP_READ(SENSE_XLR_PIN2, BIT_XP(1, 1)),
+  STEP_READ(SENSE_XLR_PIN3, BIT_XP(1, 2)),
+  STEP_CHECK(CK_SLEEVE | CK_P2),
+  STEP_WRITE(TS_CONT_OUT_SLEEVE, LOW),
+  STEP_XDRIVE(XD_PIN2, LOW),
+  STEP_DRAIN(RELAY_SETTLE_MS),
+  // Drive pin 3
+  STEP_XDRIVE(XD_PIN3, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_READ(SENSE_XLR_PIN1, BIT_XP(2, 0)),
+  STEP_READ(SENSE_XLR_PIN2, BIT_XP(2, 1)),
+  STEP_READ(SENSE_XLR_PIN3, BIT_XP(2, 2)),
+  STEP_CHECK(CK_P3),
+  STEP_XDRIVE(XD_PIN3, LOW),
+  STEP_DRAIN(RELAY_SETTLE_MS),
+  STEP_XDRIVE(XD_ALL, LOW),
+  STEP_END()
+};
+
+// K1+K2 LOW = short far end + res path, K3 LOW = route resistance to TS
+const TestStep SEG_TS_RES_ROUTE[] PROGMEM = {
+  STEP_WRITE(K1_K2_RELAY, LOW),
+  STEP_WRITE(K3_RELAY, LOW),
+  STEP_WAIT(RELAY_SETTLE_MS),
+  STEP_END()
+};
+
+// K5/K6 HIGH = pins 2/3 to resistance mode, K3 HIGH = route to XLR,
+// K4 LOW = pin 2. One relay step for all four.
+const TestStep SEG_XRES_ROUTE_P2[] PROGMEM = {
+  STEP_WRITE(K5_RELAY, HIGH),
+  STEP_WRITE(K6_RELAY, HIGH),
+  STEP_WRITE(K3_RELAY, HIGH),
+  STEP_WRITE(K4_RELAY, LOW),
+  STEP_WAIT(RELAY_SETTLE_MS),
+  STEP_END()
+};
+
+// K4 HIGH = pin 3, once A0 shows the pin 2 current has stopped (K4 never
+// switches under load)
+const TestStep SEG_XRES_SELECT_P3[] PROGMEM = {
+  STEP_RES_DRAIN(RELAY_SETTLE_MS),
+  STEP_WRITE(K4_RELAY, HIGH),
+  STEP_WAIT(RELAY_SETTLE_MS),
+  STEP_END()
+};
+
+// Enable current through PN2222A, settle, sample RES_SENSE, disable.
+// The drive is on for the settle and the capture only (shorter in BURST mode).
+const TestStep SEG_RES_SAMPLE[] PROGMEM = {
+  STEP_WRITE(RES_TEST_OUT, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_RES_ADC(),
+  STEP_WRITE(RES_TEST_OUT, LOW),
+  STEP_END()
+};
+
+// Same as SEG_RES_SAMPLE with more samples for a stable baseline
+const TestStep SEG_CAL_SAMPLE[] PROGMEM = {
+  STEP_WRITE(RES_TEST_OUT, HIGH),
+  STEP_SETTLE(SIGNAL_SETTLE_MS),
+  STEP_ADC(CAL_SAMPLES),
+  STEP_WRITE(RES_TEST_OUT, LOW),
+  STEP_END()
+};
+
+// Resistance checks, after the reading's SEG_RES_SAMPLE (FAST stops here)
+const TestStep SEG_CHECK_RES[] PROGMEM = {
+  STEP_CHECK(CK_RES),
+  STEP_END()
+};
+
+const TestStep SEG_CHECK_P2RES[] PROGMEM = {
+  STEP_CHECK(CK_P2RES),
+  STEP_END()
+};
+
+const TestStep SEG_CHECK_P3RES[] PROGMEM = {
+  STEP_CHECK(CK_P3RES),
+  STEP_END()
+};
+
+// --- Programs ---
+// FULL/XFULL run rest-state phases first so each relay moves at most once.
+
+const TestStep* const PROG_CONT[]   = {SEG_TS_CONT, SEG_RESET, NULL};
+const TestStep* const PROG_XCONT[]  = {SEG_REST, SEG_XLR_CONT, SEG_RESET, NULL};
+const TestStep* const PROG_XSHELL[] = {SEG_REST, SEG_XLR_SHELL, SEG_RESET, NULL};
+const TestStep* const PROG_RES[]    = {SEG_TS_RES_ROUTE, SEG_RES_SAMPLE, SEG_CHECK_RES, SEG_RESET, NULL};
+const TestStep* const PROG_XRES[]   = {SEG_XRES_ROUTE_P2, SEG_RES_SAMPLE, SEG_CHECK_P2RES,
+                                       SEG_XRES_SELECT_P3, SEG_RES_SAMPLE, SEG_CHECK_P3RES,
+                                       SEG_RESET, NULL};
+const TestStep* const PROG_CAL[]    = {SEG_TS_RES_ROUTE, SEG_CAL_SAMPLE, SEG_RESET, NULL};
+const TestStep* const PROG_XCAL[]   = {SEG_XRES_ROUTE_P2, SEG_CAL_SAMPLE,
+                                       SEG_XRES_SELECT_P3, SEG_CAL_SAMPLE, SEG_RESET, NULL};
+// TS: rest state (K1+K2 LOW, K3 LOW) is already the resistance path, so
+// RES runs first and K1+K2 only has to pull in once for continuity.
+const TestStep* const PROG_FULL[]   = {SEG_REST, SEG_RES_SAMPLE, SEG_CHECK_RES, SEG_TS_CONT,
+                                       SEG_RESET, NULL};
+// XLR: continuity (and shell) share the rest-state settle, then
+// K3/K5/K6 energize once and K4 flips once.
+const TestStep* const PROG_XFULL[]  = {SEG_REST, SEG_XLR_CONT,
+                                       SEG_XRES_ROUTE_P2, SEG_RES_SAMPLE, SEG_CHECK_P2RES,
+                                       SEG_XRES_SELECT_P3, SEG_RES_SAMPLE, SEG_CHECK_P3RES,
+                                       SEG_RESET, NULL};
+const TestStep* const PROG_XFULL_SHELL[] = {SEG_REST, SEG_XLR_SCAN,
+                                            SEG_XRES_ROUTE_P2, SEG_RES_SAMPLE, SEG_CHECK_P2RES,
+                                            SEG_XRES_SELECT_P3, SEG_RES_SAMPLE, SEG_CHECK_P3RES,
+                                            SEG_RESET, NULL};
+const TestStep* const PROG_BOTH[]   = {SEG_BOTH_CONT, SEG_RESET, NULL};
+
+// Indexed by TestKind
+const TestDef TEST_DEFS[] = {
+  {"CONT",        NULL,  PROG_CONT,         false},
+  {"XCONT",       "XC",  PROG_XCONT,        false},
+  {"XSHELL",      "XS",  PROG_XSHELL,       false},
+  {"RES",         NULL,  PROG_RES,          true},
+  {"XRES",        "XR",  PROG_XRES,         true},
+  {"CAL",         NULL,  PROG_CAL,          true},
+  {"XCAL",        NULL,  PROG_XCAL,         true},
+  {"FULL",        NULL,  PROG_FULL,         true},
+  {"XFULL",       NULL,  PROG_XFULL,        true},
+  {"XFULL SHELL", NULL,  PROG_XFULL_SHELL,  true},
+  {"BOTH",        NULL,  PROG_BOTH,         false},
+};
+const int NUM_TESTS = sizeof(TEST_DEFS) / sizeof(TEST_DEFS[0]);
+static_assert(sizeof(TEST_DEFS) / sizeof(TEST_DEFS[0]) == TEST_KIND_COUNT, "one TEST_DEFS entry per TestKind");
@@ -0,0 +1,116 @@
+/*
+ * HeadChain.cpp - Test heads 2..HEAD_COUNT on a shift register chain, see
+ * TEST HEADS in BoardTraits.h
+ *
+ * The Mega keeps a 16-bit output frame per chained head and shifts the
+ * whole chain out on every change, so a write costs ~50 digitalWrite()s per
+ * chained head (~0.2 ms each); sense snapshots are loaded in parallel and
+ * shifted in, 8 bits per head.
+ */
+
+#include "../BoardTraits.h"
+
+#if CABLE_TESTER_HEADS > 1
+
+constexpr uint8_t CHAIN_HEADS = HEAD_COUNT - 1;
+constexpr uint8_t ENABLE_BIT = sizeof(OUTPUT_PINS);         // XLR_DRIVE_PINS[i] enable: bit 12 + i
+static_assert(sizeof(OUTPUT_PINS) + sizeof(XLR_DRIVE_PINS) <= 16, "a head's outputs fit two 74HC595s");
+
+static uint16_t frames[CHAIN_HEADS];       // Head n is frames[n - 2]
+
+// Frame bit behind a head-1 pin number, -1 if the head doesn't have it
+static int8_t outputBit(uint8_t pin) {
+  for (uint8_t i = 0; i < sizeof(OUTPUT_PINS); i++) {
+    if (OUTPUT_PINS[i] == pin) return i;
+  }
+  return -1;
+}
+
+static int8_t enableBit(uint8_t pin) {
+  for (uint8_t i = 0; i < sizeof(XLR_DRIVE_PINS); i++) {
+    if (XLR_DRIVE_PINS[i] == pin) return ENABLE_BIT + i;
+  }
+  return -1;
+}
+
+// The furthest head goes first, MSB first, so each frame ends up in its
+// own registers; one latch pulse moves every head's outputs together
+static void shiftFrames() {
+  for (int8_t h = CHAIN_HEADS - 1; h >= 0; h--) {
+    for (int8_t bit = 15; bit >= 0; bit--) {
+      digitalWrite(HEAD_DATA, (frames[h] >> bit) & 1);
+      digitalWrite(HEAD_CLOCK, HIGH);
+      digitalWrite(HEAD_CLOCK, LOW);
+    }
+  }
+  digitalWrite(HEAD_LATCH, HIGH);
+  digitalWrite(HEAD_LATCH, LOW);
+}
+
+static void setBit(uint8_t head, int8_t bit, bool on) {
+  if (bit < 0) return;
+  uint16_t &frame = frames[head - 2];
+  frame = on ? frame | (1u << bit) : frame & ~(1u << bit);
+}
+
+// Every XLR drive enabled and LOW, like head 1 after begin()
+void headBegin() {
+  pinMode(HEAD_DATA, OUTPUT);
+  pinMode(HEAD_CLOCK, OUTPUT);
+  pinMode(HEAD_LATCH, OUTPUT);
+  pinMode(HEAD_LOAD, OUTPUT);
+  pinMode(HEAD_SENSE, INPUT);
+  digitalWrite(HEAD_LOAD, HIGH);
+  for (uint16_t &frame : frames) frame = ((1u << sizeof(XLR_DRIVE_PINS)) - 1) << ENABLE_BIT;
+  shiftFrames();
+}
+
+void headWrite(uint8_t head, uint8_t pin, uint8_t level) {
+  setBit(head, outputBit(pin), level);
+  shiftFrames();
+}
+
+void headMode(uint8_t head, uint8_t pin, uint8_t mode) {
+  setBit(head, enableBit(pin), mode == OUTPUT);
+  shiftFrames();
+}
+
+uint8_t headLevel(uint8_t head, uint8_t pin) {
+  int8_t bit = outputBit(pin);
+  return bit >= 0 && (frames[head - 2] >> bit) & 1;
+}
+
+// A 74HC165 shifts on the clock's rising edge, so each bit is read before
+// the pulse, not after it as shiftIn() does
+uint8_t headSense(uint8_t head) {
+  digitalWrite(HEAD_LOAD, LOW);
+  digitalWrite(HEAD_LOAD, HIGH);
+  uint8_t sense = 0;
+  for (uint8_t h = 2; h <= head; h++) {
+    sense = 0;
+    for (int8_t bit = 7; bit >= 0; bit--) {
+      if (digitalRead(HEAD_SENSE)) sense |= 1 << bit;
+      digitalWrite(HEAD_CLOCK, HIGH);
+      digitalWrite(HEAD_CLOCK, LOW);
+    }
+  }
+  return sense & ((1 << sizeof(SENSE_PINS)) - 1);
+}
+
+// As xlrDrive(): released lines go first, so two drives never fight
+// through a shorted cable
+void headXlrDrive(uint8_t head, uint8_t lines, uint8_t level) {
+  for (uint8_t i = 0; i < sizeof(XLR_DRIVE_PINS); i++) {
+    if (!(lines & (1 << i))) setBit(head, ENABLE_BIT + i, false);
+  }
+  shiftFrames();
+  for (uint8_t i = 0; i < sizeof(XLR_DRIVE_PINS); i++) {
+    if (lines & (1 << i)) {
+      setBit(head, ENABLE_BIT + i, true);
+      setBit(head, outputBit(XLR_DRIVE_PINS[i]), level);
+    }
+  }
+  shiftFrames();
+}
+
+#endif // CABLE_TESTER_HEADS > 1
@@ -0,0 +1,290 @@
+/*
+ * Mega2560.cpp - Mega 2560 board I/O layer: port-register sense/drive and
+ * the interrupt-driven ADC burst
+ */
+
+#if defined(ARDUINO_AVR_MEGA2560)
+
+#include "../BoardTraits.h"
+
+const PinToggle BOARD_TOGGLES[] = {
+  // --- TS Relay Toggles ---
+  {"K12",   K1_K2_RELAY,        "K1+K2(D14)"},
+  {"K3",    K3_RELAY,           "K3(D15)"},
+  {"K4",    K4_RELAY,           "K4(D16)"},
+  // --- XLR Relay Toggles ---
+  {"K5",    K5_RELAY,           "K5(D62)"},
+  {"K6",    K6_RELAY,           "K6(D63)"},
+  // --- TS Test Signals ---
+  {"TSTIP", TS_CONT_OUT_TIP,    "TS_CONT_OUT_TIP(D3)"},
+  {"TSSLV", TS_CONT_OUT_SLEEVE, "TS_CONT_OUT_SLEEVE(D2)"},
+  {"TSRES", RES_TEST_OUT,       "RES_TEST_OUT(D6)"},
+  // --- XLR Test Signals ---
+  {"XLR1",  XLR_CONT_OUT_PIN1,  "XLR_CONT_OUT_PIN1(D69)"},
+  {"XLR2",  XLR_CONT_OUT_PIN2,  "XLR_CONT_OUT_PIN2(D65)"},
+  {"XLR3",  XLR_CONT_OUT_PIN3,  "XLR_CONT_OUT_PIN3(D64)"},
+  {"XLRS",  XLR_CONT_OUT_SHELL, "XLR_CONT_OUT_SHELL(D61)"},
+};
+const uint8_t NUM_BOARD_TOGGLES = sizeof(BOARD_TOGGLES) / sizeof(BOARD_TOGGLES[0]);
+
+// analogRead() keeps the core's default ADC setup between bursts
+void boardBegin() {
+}
+
+// ===== FAST I/O =====
+// Continuity drive/sense straight from the port registers. The sense inputs
+// sit on four ports (K, F, G, E); readSense() reads them back to back with
+// interrupts off, so every bit of the snapshot comes from the same instant.
+// xlrDrive() switches all four XLR drives with one write per register.
+// Port and bit come from the pin numbers in Mega2560.h at compile time;
+// the static_asserts catch a rewire onto a port these functions don't read.
+constexpr char megaPort(uint8_t pin) {
+  return pin == 4 ? 'G' : (pin == 2 || pin == 3 || pin == 5) ? 'E' :
+         (pin >= 54 && pin <= 61) ? 'F' : (pin >= 62 && pin <= 69) ? 'K' : 0;
+}
+constexpr uint8_t megaBit(uint8_t pin) {
+  return pin == 2 ? _BV(PE4) : pin == 3 ? _BV(PE5) : pin == 4 ? _BV(PG5) : pin == 5 ? _BV(PE3) :
+         (pin >= 54 && pin <= 61) ? _BV(pin - 54) :  // A0-A7 = PF0-PF7
+         (pin >= 62 && pin <= 69) ? _BV(pin - 62) :  // A8-A15 = PK0-PK7
+         0;
+}
+
+static_assert(megaPort(TS_CONT_IN_TIP) == 'E' && megaPort(TS_CONT_IN_SLEEVE) == 'G',
+              "readSense() reads TIP from PINE, SLEEVE from PING");
+static_assert(megaPort(XLR_CONT_IN_PIN1) == 'K' && megaPort(XLR_CONT_IN_PIN2) == 'K' &&
+              megaPort(XLR_CONT_IN_PIN3) == 'K' && megaPort(XLR_CONT_IN_SHELL) == 'F',
+              "readSense() reads XLR pins 1-3 from PINK, shell from PINF");
+static_assert(megaPort(XLR_CONT_OUT_PIN1) == 'K' && megaPort(XLR_CONT_OUT_PIN2) == 'K' &&
+              megaPort(XLR_CONT_OUT_PIN3) == 'K' && megaPort(XLR_CONT_OUT_SHELL) == 'F',
+              "xlrDrive() writes XLR pins 1-3 on PORTK, shell on PORTF");
+
+constexpr uint8_t XLR_DRIVE_K = megaBit(XLR_CONT_OUT_PIN1) | megaBit(XLR_CONT_OUT_PIN2) |
+                                megaBit(XLR_CONT_OUT_PIN3);
+constexpr uint8_t XLR_DRIVE_F = megaBit(XLR_CONT_OUT_SHELL);
+
+uint8_t readSense() {
+  uint8_t sreg = SREG;
+  cli();
+  uint8_t k = PINK;
+  uint8_t f = PINF;
+  uint8_t g = PING;
+  uint8_t e = PINE;
+  SREG = sreg;
+
+  uint8_t sense = 0;
+  if (e & megaBit(TS_CONT_IN_TIP)) sense |= SENSE_TS_TIP;
+  if (g & megaBit(TS_CONT_IN_SLEEVE)) sense |= SENSE_TS_SLEEVE;
+  if (k & megaBit(XLR_CONT_IN_PIN1)) sense |= SENSE_XLR_PIN1;
+  if (k & megaBit(XLR_CONT_IN_PIN2)) sense |= SENSE_XLR_PIN2;
+  if (k & megaBit(XLR_CONT_IN_PIN3)) sense |= SENSE_XLR_PIN3;
+  if (f & megaBit(XLR_CONT_IN_SHELL)) sense |= SENSE_XLR_SHELL;
+  return sense;
+}
+
+// Drive the XLR lines in `lines` to `level`; every other XLR drive goes
+// high-Z (input, no pull-up). K5/K6 share PORTK and are left untouched.
+void xlrDrive(uint8_t lines, uint8_t level) {
+  uint8_t k = 0;
+  uint8_t f = 0;
+  if (lines & XD_PIN1) k |= megaBit(XLR_CONT_OUT_PIN1);
+  if (lines & XD_PIN2) k |= megaBit(XLR_CONT_OUT_PIN2);
+  if (lines & XD_PIN3) k |= megaBit(XLR_CONT_OUT_PIN3);
+  if (lines & XD_SHELL) f |= megaBit(XLR_CONT_OUT_SHELL);
+
+  uint8_t sreg = SREG;
+  cli();
+  PORTK = (PORTK & ~XLR_DRIVE_K) | (level ? k : 0);
+  DDRK = (DDRK & ~XLR_DRIVE_K) | k;
+  PORTF = (PORTF & ~XLR_DRIVE_F) | (level ? f : 0);
+  DDRF = (DDRF & ~XLR_DRIVE_F) | f;
+  SREG = sreg;
+}
+
+// ===== BUFFERED ADC =====
+// RES_SENSE bursts: the ADC free-runs on A0 and ADC_vect sums each
+// conversion, so an OP_ADC step costs count / sample rate instead of
+// count * a delay. When the count is reached the ISR drops back to the
+// single-conversion /128 setup analogRead() expects. The squares fit 32
+// bits: 1023^2 * 4100 < 2^32, and bursts are at most RES_MAX_SAMPLES.
+static uint16_t adcSamples;                // Burst length
+static volatile uint16_t adcPending;       // Conversions still to sum
+static volatile uint32_t adcAccum;
+static volatile uint32_t adcAccumSq;
+static volatile uint16_t adcMin, adcMax;
+static AdcOutliers adcOutliers;            // Not volatile: read with interrupts off
+static volatile uint16_t adcLatest;        // Last conversion, for READ/PINS mid-burst
+static volatile bool adcRunning;
+static volatile bool adcDiscard;           // First conversion after a mux change
+
+#define ADC_IDLE  (_BV(ADEN) | 7)  // analogRead() setup: enabled, /128
+
+ISR(ADC_vect) {
+  uint16_t value = ADC;
+  if (adcDiscard) {
+    adcDiscard = false;
+    return;
+  }
+  if (adcPending == adcSamples) adcMin = adcMax = value;
+  if (value < adcMin) adcMin = value;
+  if (value > adcMax) adcMax = value;
+  adcOutliers.add(value);
+  adcLatest = value;
+  adcAccum += value;
+  adcAccumSq += (uint32_t)value * value;
+  if (--adcPending == 0) {
+    ADCSRA = ADC_IDLE;
+    adcRunning = false;
+  }
+}
+
+void adcStart(uint16_t count) {
+  uint8_t sreg = SREG;
+  cli();
+  adcAccum = 0;
+  adcAccumSq = 0;
+  adcOutliers.reset();
+  adcSamples = count;
+  adcPending = count;
+  adcDiscard = true;
+  adcRunning = true;
+  ADMUX = _BV(REFS0) | ((RES_SENSE - A0) & 0x07);  // AVcc reference
+  ADCSRB = 0;                                       // Free-running, ADC0-7
+  ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIE) | ADC_PRESCALE;
+  SREG = sreg;
+}
+
+void adcStop() {
+  uint8_t sreg = SREG;
+  cli();
+  ADCSRA = ADC_IDLE;
+  adcPending = 0;
+  adcRunning = false;
+  SREG = sreg;
+}
+
+bool adcBusy() {
+  return adcRunning;
+}
+
+// Sums of the finished burst (the ISR is done with them)
+void adcResult(AdcBurst &burst) {
+  burst.count = adcSamples;
+  burst.sum = adcAccum;
+  burst.sumSq = adcAccumSq;
+  burst.min = adcMin;
+  burst.max = adcMax;
+  uint8_t sreg = SREG;
+  cli();
+  burst.outliers = adcOutliers.count();
+  SREG = sreg;
+}
+
+// A0 reading that doesn't disturb a running burst
+int readResSense() {
+  if (!adcRunning) return analogRead(RES_SENSE);
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t value = adcLatest;
+  SREG = sreg;
+  return value;
+}
+
+// AVcc from the internal bandgap read against it: Vcc = 1.1 V * 1023 / counts.
+// The bandgap (1.1 V +/-10% per chip) is only used for drift, so its
+// absolute error mostly cancels. 0 during a burst. Blocks ~1.2 ms: mux
+// settle plus two conversions.
+uint16_t readSupplyMv() {
+  if (adcRunning) return 0;
+  ADMUX = _BV(REFS0) | 0x1E;             // AVcc reference, 1.1 V bandgap input
+  ADCSRB = 0;
+  delayMicroseconds(BANDGAP_SETTLE_US);
+  uint16_t value = 0;
+  for (uint8_t i = 0; i < 2; i++) {       // First conversion after the switch is off
+    ADCSRA = ADC_IDLE | _BV(ADSC);
+    while (ADCSRA & _BV(ADSC)) {}
+    value = ADC;
+  }
+  if (value == 0) return 0;
+  return (uint32_t)BANDGAP_MV * ADC_MAX / value;
+}
+
+// ===== FLEX SAMPLING =====
+// Timer2 in CTC mode fires TIMER2_COMPA_vect every FLEX_SAMPLE_US; the ISR
+// takes a readSense() snapshot and queues it only when it differs from the
+// last one, so a steady cable costs no queue space. flexStop() puts Timer2
+// back the way the core's init() left it (phase-correct PWM, /64).
+constexpr uint16_t FLEX_TIMER_TOP = FLEX_SAMPLE_US * 2 - 1;   // 2 MHz timer clock
+static_assert(FLEX_TIMER_TOP <= 255, "FLEX_SAMPLE_US too long for 8-bit Timer2 at /8");
+static_assert((FLEX_QUEUE & (FLEX_QUEUE - 1)) == 0, "FLEX_QUEUE must be a power of two");
+
+static FlexEdge flexQueue[FLEX_QUEUE];
+static volatile uint8_t flexHead, flexTail;
+static volatile uint32_t flexTick;
+static volatile uint16_t flexLostCount;
+static uint8_t flexLast;                    // ISR only
+
+ISR(TIMER2_COMPA_vect) {
+  uint8_t sense = readSense();
+  uint32_t tick = ++flexTick;
+  if (sense == flexLast) return;
+  flexLast = sense;
+  uint8_t next = (flexHead + 1) & (FLEX_QUEUE - 1);
+  if (next == flexTail) {
+    flexLostCount++;
+    return;
+  }
+  flexQueue[flexHead].tick = tick;
+  flexQueue[flexHead].sense = sense;
+  flexHead = next;
+}
+
+// The first snapshot counts as a change from all-low
+void flexStart() {
+  uint8_t sreg = SREG;
+  cli();
+  flexHead = flexTail = 0;
+  flexTick = 0;
+  flexLostCount = 0;
+  flexLast = 0;
+  TCCR2A = _BV(WGM21);                 // CTC, TOP = OCR2A
+  TCNT2 = 0;
+  OCR2A = FLEX_TIMER_TOP;
+  TIFR2 = _BV(OCF2A);
+  TIMSK2 = _BV(OCIE2A);
+  TCCR2B = _BV(CS21);                  // /8
+  SREG = sreg;
+}
+
+void flexStop() {
+  uint8_t sreg = SREG;
+  cli();
+  TIMSK2 = 0;
+  TCCR2A = _BV(WGM20);
+  TCCR2B = _BV(CS22);
+  SREG = sreg;
+}
+
+bool flexNext(FlexEdge &edge) {
+  if (flexTail == flexHead) return false;
+  edge = flexQueue[flexTail];
+  flexTail = (flexTail + 1) & (FLEX_QUEUE - 1);
+  return true;
+}
+
+uint32_t flexTicks() {
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t tick = flexTick;
+  SREG = sreg;
+  return tick;
+}
+
+uint16_t flexLost() {
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t lost = flexLostCount;
+  SREG = sreg;
+  return lost;
+}
+
+#endif // ARDUINO_AVR_MEGA2560
@@ -0,0 +1,79 @@
+/*
+ * Mega2560.h - Arduino Mega 2560 tester: pin map and hardware traits
+ *
+ * 5V logic, 10-bit ADC. Wiring notes are in the cable_tester.ino header.
+ * Included through BoardTraits.h only.
+ */
+
+#ifndef CABLE_TESTER_BOARD_MEGA2560_H
+#define CABLE_TESTER_BOARD_MEGA2560_H
+
+// ===== PIN DEFINITIONS =====
+
+// --- TS Cable Testing ---
+// Continuity signals
+constexpr uint8_t TS_CONT_OUT_SLEEVE = 2;   // Continuity signal output to SLEEVE
+constexpr uint8_t TS_CONT_OUT_TIP = 3;      // Continuity signal output to TIP
+constexpr uint8_t TS_CONT_IN_SLEEVE = 4;    // Continuity sense input from SLEEVE
+constexpr uint8_t TS_CONT_IN_TIP = 5;       // Continuity sense input from TIP
+
+// --- Resistance (shared TS/XLR via K3/K4 relay switching) ---
+constexpr uint8_t RES_TEST_OUT = 6;         // PN2222A base drive for resistance test
+constexpr uint8_t RES_SENSE = A0;           // Analog input: resistance measurement
+
+// --- Relay Drives ---
+constexpr uint8_t K1_K2_RELAY = 14;         // TS test mode: LOW = short far end + res path, HIGH = continuity
+constexpr uint8_t K3_RELAY = 15;            // Resistance circuit: LOW = TS, HIGH = XLR
+constexpr uint8_t K4_RELAY = 16;            // XLR resistance pin select: LOW = Pin 2, HIGH = Pin 3
+constexpr uint8_t K5_RELAY = 63;            // XLR Pin 2: LOW = continuity, HIGH = resistance (into K4)
+constexpr uint8_t K6_RELAY = 62;            // XLR Pin 3: LOW = continuity, HIGH = resistance (into K4)
+
+// --- XLR Cable Testing ---
+// Continuity signals (paired drive/read with pulldown resistors)
+constexpr uint8_t XLR_CONT_OUT_PIN1 = 69;   // Continuity signal output to XLR Pin 1
+constexpr uint8_t XLR_CONT_IN_PIN1 = 68;    // Continuity sense input from XLR Pin 1
+constexpr uint8_t XLR_CONT_OUT_PIN2 = 65;   // Continuity signal output to XLR Pin 2 (K5)
+constexpr uint8_t XLR_CONT_IN_PIN2 = 67;    // Continuity sense input from XLR Pin 2 (K5)
+constexpr uint8_t XLR_CONT_OUT_PIN3 = 64;   // Continuity signal output to XLR Pin 3 (K6)
+constexpr uint8_t XLR_CONT_IN_PIN3 = 66;    // Continuity sense input from XLR Pin 3 (K6)
+constexpr uint8_t XLR_CONT_OUT_SHELL = 61;  // Continuity signal output to XLR shell (near side)
+constexpr uint8_t XLR_CONT_IN_SHELL = 60;   // Continuity sense input from XLR shell (far side)
+
+// --- Head chain (TEST HEADS in BoardTraits.h) ---
+// Build with -DCABLE_TESTER_HEADS=<n> (2-4) for heads 2..n on the chain
+#ifndef CABLE_TESTER_HEADS
+#define CABLE_TESTER_HEADS 1
+#endif
+constexpr uint8_t HEAD_DATA = 22;           // 74HC595 serial in (first register of head 2)
+constexpr uint8_t HEAD_CLOCK = 23;          // Shift clock, 74HC595 SRCLK and 74HC165 CLK
+constexpr uint8_t HEAD_LATCH = 24;          // 74HC595 RCLK: every head's outputs change together
+constexpr uint8_t HEAD_SENSE = 25;          // 74HC165 serial out (head 2's)
+constexpr uint8_t HEAD_LOAD = 26;           // 74HC165 SH/LD: LOW loads every head's senses
+
+// ===== HARDWARE TRAITS =====
+constexpr const char* TESTER_ID = "TS_TESTER_1";
+
+// High-side sense topology: 5V → R_sense(20Ω) → cable → relay → collector, emitter → GND
+// A0 reads junction of R_sense and cable. Lower ADC = more current = lower cable resistance.
+typedef AdcTraits<10, 5000> BoardAdc;   // 10-bit, Arduino USB supply voltage
+constexpr int ADC_MAX = BoardAdc::MAX;
+constexpr float SUPPLY_VOLTAGE = BoardAdc::SUPPLY;
+constexpr int RES_PASS_THRESHOLD = 120;    // Absolute ADC threshold (uncalibrated fallback, ~1Ω)
+constexpr int CAL_REJECT_THRESHOLD = 600;  // Calibration reading above this = no cable
+constexpr int ADC_SETTLE_TOL = 2;          // ADC counts that still "agree"
+constexpr int ADC_OUTLIER_TOL = 8;         // Burst sample this far off counts as an outlier (~170 mΩ)
+constexpr uint16_t BANDGAP_MV = 1100;       // Internal reference, readSupplyMv()
+constexpr unsigned int BANDGAP_SETTLE_US = 1000;
+
+// Buffered resistance sampling: OP_ADC runs the ADC free-running and sums
+// conversions in the ADC interrupt. Rate = 16 MHz / prescaler / 13 cycles.
+// The ATmega2560 gives full 10-bit resolution at a 50-200 kHz ADC clock,
+// so /128 (125 kHz); /64 (250 kHz) is twice as fast but loses resolution.
+constexpr uint8_t ADC_PRESCALE = 7;   // ADPS2:0 — 7 = /128 (~9.6k samples/s)
+
+// FLEX sampling: Timer2 compare interrupt (CTC, 16 MHz / 8) snapshots the
+// sense inputs every FLEX_SAMPLE_US and queues changes, FLEX_QUEUE deep.
+constexpr unsigned int FLEX_SAMPLE_US = 50;   // 20k samples/s, ~5 us of ISR each
+constexpr uint8_t FLEX_QUEUE = 32;            // Power of two
+
+#endif // CABLE_TESTER_BOARD_MEGA2560_H
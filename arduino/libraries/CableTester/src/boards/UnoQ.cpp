@@ -0,0 +1,168 @@
+/*
+ * UnoQ.cpp - UNO Q board I/O layer: digitalRead() sense snapshots and the
+ * chunked analogRead() burst
+ */
+
+#if defined(ARDUINO_ARCH_ZEPHYR)
+
+#include "../BoardTraits.h"
+
+#include <string.h>
+
+const PinToggle BOARD_TOGGLES[] = {
+  // --- Relay toggles ---
+  {"K12",   K1_K2_RELAY,        "K1+K2(D7)"},
+  {"K3",    K3_RELAY,           "K3(D8)"},
+  {"K4",    K4_RELAY,           "K4(D9)"},
+  {"K5",    K5_RELAY,           "K5(D10)"},
+  {"K6",    K6_RELAY,           "K6(D11)"},
+  // --- Signal toggles ---
+  {"TSTIP", TS_CONT_OUT_TIP,    "TS_CONT_OUT_TIP(D3)"},
+  {"TSSLV", TS_CONT_OUT_SLEEVE, "TS_CONT_OUT_SLEEVE(D2)"},
+  {"TSRES", RES_TEST_OUT,       "RES_TEST_OUT(D6)"},
+  {"XLR1",  XLR_CONT_OUT_PIN1,  "XLR_CONT_OUT_PIN1(D12)"},
+  {"XLR2",  XLR_CONT_OUT_PIN2,  "XLR_CONT_OUT_PIN2(D13)"},
+  {"XLR3",  XLR_CONT_OUT_PIN3,  "XLR_CONT_OUT_PIN3(D15/A1)"},
+  {"XLRS",  XLR_CONT_OUT_SHELL, "XLR_CONT_OUT_SHELL(D16/A2)"},
+};
+const uint8_t NUM_BOARD_TOGGLES = sizeof(BOARD_TOGGLES) / sizeof(BOARD_TOGGLES[0]);
+
+void boardBegin() {
+  analogReadResolution(14);
+}
+
+// Snapshot of every continuity sense input. The Zephyr core doesn't expose
+// the GPIO port registers to sketches, so the reads are taken back to back
+// with interrupts off — the same instant for all bits, as far as the test
+// is concerned.
+uint8_t readSense() {
+  bool level[sizeof(SENSE_PINS)];
+  noInterrupts();
+  for (uint8_t i = 0; i < sizeof(SENSE_PINS); i++) level[i] = digitalRead(SENSE_PINS[i]);
+  interrupts();
+
+  uint8_t sense = 0;
+  for (uint8_t i = 0; i < sizeof(SENSE_PINS); i++) {
+    if (level[i]) sense |= 1 << i;
+  }
+  return sense;
+}
+
+// Drive the XLR lines in `lines` to `level`; every other XLR drive goes
+// high-Z. Lines are released before any is driven so two drives never
+// fight through a shorted cable.
+void xlrDrive(uint8_t lines, uint8_t level) {
+  for (uint8_t i = 0; i < sizeof(XLR_DRIVE_PINS); i++) {
+    if (!(lines & (1 << i))) pinMode(XLR_DRIVE_PINS[i], INPUT);
+  }
+  for (uint8_t i = 0; i < sizeof(XLR_DRIVE_PINS); i++) {
+    if (lines & (1 << i)) {
+      pinMode(XLR_DRIVE_PINS[i], OUTPUT);
+      digitalWrite(XLR_DRIVE_PINS[i], level);
+    }
+  }
+}
+
+// ===== BUFFERED ADC =====
+// adcBusy() does the sampling: each call bursts conversions until the count
+// is reached or ADC_CHUNK_US is up, then lets loop() run.
+static uint16_t adcSamples;
+static uint16_t adcTaken;
+static AdcBurst adcSums;                   // count and outliers are set by adcResult()
+static AdcOutliers adcOutliers;
+
+void adcStart(uint16_t count) {
+  adcSamples = count;
+  adcTaken = 0;
+  memset(&adcSums, 0, sizeof(adcSums));
+  adcOutliers.reset();
+}
+
+bool adcBusy() {
+  unsigned long chunkStart = micros();
+  while (adcTaken < adcSamples) {
+    if (micros() - chunkStart >= ADC_CHUNK_US) return true;
+    uint16_t value = analogRead(RES_SENSE);
+    if (adcTaken == 0) adcSums.min = adcSums.max = value;
+    if (value < adcSums.min) adcSums.min = value;
+    if (value > adcSums.max) adcSums.max = value;
+    adcOutliers.add(value);
+    adcSums.sum += value;
+    adcSums.sumSq += (uint32_t)value * value;
+    adcTaken++;
+    delayMicroseconds(ADC_SAMPLE_US);
+  }
+  return false;
+}
+
+void adcResult(AdcBurst &burst) {
+  burst = adcSums;
+  burst.count = adcSamples;
+  burst.outliers = adcOutliers.count();
+}
+
+void adcStop() {
+  adcSamples = 0;
+  adcTaken = 0;
+}
+
+// Bursts only run inside serviceTest(), never under READ/PINS
+int readResSense() {
+  return analogRead(RES_SENSE);
+}
+
+// analogRead() only reaches the header pins, not the internal reference,
+// so the supply can't be measured; baselines skip the supply correction
+uint16_t readSupplyMv() {
+  return 0;
+}
+
+// ===== FLEX SAMPLING =====
+// flexNext() does the sampling: snapshots FLEX_SAMPLE_US apart until one
+// differs from the last or FLEX_CHUNK_US is up. Ticks follow micros(), so
+// time between chunks still counts; nothing is queued, flexLost() is 0.
+static uint32_t flexTick;
+static unsigned long flexTickUs;           // micros() at flexTick
+static uint8_t flexLast;
+
+// Advance flexTick to now, carrying the part-tick over
+static uint32_t flexClock() {
+  unsigned long elapsed = micros() - flexTickUs;
+  flexTick += elapsed / FLEX_SAMPLE_US;
+  flexTickUs += elapsed - elapsed % FLEX_SAMPLE_US;
+  return flexTick;
+}
+
+void flexStart() {
+  flexTick = 0;
+  flexTickUs = micros();
+  flexLast = 0;
+}
+
+void flexStop() {
+}
+
+bool flexNext(FlexEdge &edge) {
+  unsigned long chunkStart = micros();
+  while (micros() - chunkStart < FLEX_CHUNK_US) {
+    uint8_t sense = readSense();
+    if (sense != flexLast) {
+      flexLast = sense;
+      edge.tick = flexClock();
+      edge.sense = sense;
+      return true;
+    }
+    delayMicroseconds(FLEX_SAMPLE_US);
+  }
+  return false;
+}
+
+uint32_t flexTicks() {
+  return flexClock();
+}
+
+uint16_t flexLost() {
+  return 0;
+}
+
+#endif // ARDUINO_ARCH_ZEPHYR
@@ -0,0 +1,72 @@
+/*
+ * UnoQ.h - Arduino UNO Q tester: pin map and hardware traits
+ *
+ * 3.3V logic, 14-bit ADC, resistance sense circuit on the 3.3V rail (A0 is
+ * not 5V tolerant). Wiring notes are in the sketch.ino header. Included
+ * through BoardTraits.h only.
+ */
+
+#ifndef CABLE_TESTER_BOARD_UNOQ_H
+#define CABLE_TESTER_BOARD_UNOQ_H
+
+// ===== PIN DEFINITIONS =====
+
+// --- TS Cable Testing ---
+constexpr uint8_t TS_CONT_OUT_SLEEVE = 2;
+constexpr uint8_t TS_CONT_OUT_TIP = 3;
+constexpr uint8_t TS_CONT_IN_SLEEVE = 4;
+constexpr uint8_t TS_CONT_IN_TIP = 5;
+
+// --- Resistance (shared TS/XLR via K3/K4 relay switching) ---
+constexpr uint8_t RES_TEST_OUT = 6;
+constexpr uint8_t RES_SENSE = A0;
+
+// --- Relay Drives (all via PN2222A, GPIO -> 1k -> base) ---
+constexpr uint8_t K1_K2_RELAY = 7;
+constexpr uint8_t K3_RELAY = 8;
+constexpr uint8_t K4_RELAY = 9;
+constexpr uint8_t K5_RELAY = 10;
+constexpr uint8_t K6_RELAY = 11;
+
+// --- XLR Cable Testing ---
+constexpr uint8_t XLR_CONT_OUT_PIN1 = 12;
+constexpr uint8_t XLR_CONT_IN_PIN1 = 17;    // A3
+constexpr uint8_t XLR_CONT_OUT_PIN2 = 13;
+constexpr uint8_t XLR_CONT_IN_PIN2 = 18;    // A4
+constexpr uint8_t XLR_CONT_OUT_PIN3 = 15;   // A1
+constexpr uint8_t XLR_CONT_IN_PIN3 = 19;    // A5
+constexpr uint8_t XLR_CONT_OUT_SHELL = 16;  // A2
+constexpr uint8_t XLR_CONT_IN_SHELL = 20;   // SDA
+
+// No pins are left for a head chain (TEST HEADS in BoardTraits.h)
+#if defined(CABLE_TESTER_HEADS) && CABLE_TESTER_HEADS != 1
+#error "CableTester: the UNO Q has one test head"
+#endif
+#define CABLE_TESTER_HEADS 1
+
+// ===== HARDWARE TRAITS =====
+constexpr const char* TESTER_ID = "UNOQ_TESTER_1";
+
+// Resistance test config (3.3V supply, 14-bit ADC)
+typedef AdcTraits<14, 3300> BoardAdc;
+constexpr int ADC_MAX = BoardAdc::MAX;
+constexpr float SUPPLY_VOLTAGE = BoardAdc::SUPPLY;
+constexpr int RES_PASS_THRESHOLD = BoardAdc::counts(0.12);    // 12% of full scale (1966)
+constexpr int CAL_REJECT_THRESHOLD = BoardAdc::counts(0.60);  // 60% of full scale (9830)
+constexpr int ADC_SETTLE_TOL = 32;                            // ADC counts that still "agree"
+constexpr int ADC_OUTLIER_TOL = 128;                          // Burst sample this far off is an outlier
+
+// Buffered resistance sampling: OP_ADC bursts back-to-back conversions
+// ADC_SAMPLE_US apart instead of one per 5-10 ms wait. A burst yields
+// to loop() after ADC_CHUNK_US so the display keeps scrolling. (The Zephyr
+// core gives sketches analogRead() only; no free-running mode or DMA.)
+constexpr unsigned int ADC_SAMPLE_US = 20;     // Gap between conversions
+constexpr unsigned long ADC_CHUNK_US = 2000;   // Longest burst per loop() pass
+
+// FLEX sampling: readSense() snapshots FLEX_SAMPLE_US apart, in chunks of
+// FLEX_CHUNK_US per loop() pass like the ADC burst (no timer interrupt is
+// exposed to sketches). Between chunks the inputs aren't watched.
+constexpr unsigned int FLEX_SAMPLE_US = 20;
+constexpr unsigned long FLEX_CHUNK_US = 2000;
+
+#endif // CABLE_TESTER_BOARD_UNOQ_H
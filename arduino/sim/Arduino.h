@@ -0,0 +1,147 @@
+/*
+ * Arduino.h - Host stand-in for the Arduino core, for the simulator
+ *
+ * Only the API the CableTester library uses. Every call is charged to a
+ * virtual clock (see SimBoard.h), so time moves by what the firmware does,
+ * not by how fast the host runs it. Built with -DARDUINO_AVR_MEGA2560 it
+ * also provides the port, SREG and ADC registers the Mega board layer
+ * writes directly, and runs its ADC_vect handler as conversions complete
+ * and its TIMER2_COMPA_vect handler on Timer2 compare matches.
+ */
+
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t byte;
+
+#define HIGH          1
+#define LOW           0
+#define INPUT         0
+#define OUTPUT        1
+#define INPUT_PULLUP  2
+
+#define _BV(bit)  (1 << (bit))
+
+#if defined(ARDUINO_AVR_MEGA2560)
+#define NUM_DIGITAL_PINS  70
+#define PIN_A0            54
+#elif defined(ARDUINO_ARCH_ZEPHYR)
+#define NUM_DIGITAL_PINS  22     // D0-D13, A0-A5, SDA, SCL
+#define PIN_A0            14
+#else
+#error "sim: build with -DARDUINO_AVR_MEGA2560 or -DARDUINO_ARCH_ZEPHYR"
+#endif
+
+static const uint8_t A0 = PIN_A0;
+static const uint8_t A1 = PIN_A0 + 1;
+static const uint8_t A2 = PIN_A0 + 2;
+static const uint8_t A3 = PIN_A0 + 3;
+static const uint8_t A4 = PIN_A0 + 4;
+static const uint8_t A5 = PIN_A0 + 5;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogReadResolution(int bits);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void noInterrupts();
+void interrupts();
+
+#if defined(ARDUINO_AVR_MEGA2560)
+// ===== MEGA REGISTERS =====
+// Port bits used by the board layer (avr/iom2560.h numbering)
+#define PE3  3
+#define PE4  4
+#define PE5  5
+#define PG5  5
+
+// One 8-bit port register; each bit maps to an Arduino pin (or none)
+class SimPortReg {
+public:
+  enum Kind { PIN, PORT, DDR };
+  SimPortReg(const int8_t *pins, Kind kind) : pins(pins), kind(kind) {}
+  operator uint8_t() const;
+  SimPortReg &operator=(uint8_t value);
+
+private:
+  const int8_t *pins;
+  Kind kind;
+};
+
+extern SimPortReg PINE, PING, PINF, PINK;
+extern SimPortReg PORTF, PORTK, DDRF, DDRK;
+
+// Status register: bit 7 is the global interrupt enable
+class SimSreg {
+public:
+  operator uint8_t() const;
+  SimSreg &operator=(uint8_t value);
+};
+
+extern SimSreg SREG;
+void cli();
+void sei();
+
+// ADC control (ADCSRA bits) and mux
+#define ADPS0  0
+#define ADPS1  1
+#define ADPS2  2
+#define ADIE   3
+#define ADIF   4
+#define ADATE  5
+#define ADSC   6
+#define ADEN   7
+#define REFS0  6
+
+// ADCSRA: starts single or free-running conversions when written
+class SimAdcsra {
+public:
+  operator uint8_t() const;
+  SimAdcsra &operator=(uint8_t value);
+};
+
+extern SimAdcsra ADCSRA;
+extern volatile uint8_t ADMUX;
+extern volatile uint8_t ADCSRB;
+extern volatile uint16_t ADC;
+
+// Timer2 (FLEX sampling): CTC mode only; TCCR2B starts and stops it
+#define WGM20   0
+#define WGM21   1
+#define CS20    0
+#define CS21    1
+#define CS22    2
+#define OCIE2A  1
+#define OCF2A   1
+
+class SimTccr2b {
+public:
+  operator uint8_t() const;
+  SimTccr2b &operator=(uint8_t value);
+};
+
+extern SimTccr2b TCCR2B;
+extern volatile uint8_t TCCR2A;
+extern volatile uint8_t TCNT2;
+extern volatile uint8_t OCR2A;
+extern volatile uint8_t TIFR2;
+extern volatile uint8_t TIMSK2;
+
+// ISR(ADC_vect) / ISR(TIMER2_COMPA_vect) define the handlers SimBoard.cpp
+// calls per conversion / compare match
+#define ISR(vector) extern "C" void vector##_handler()
+#endif // ARDUINO_AVR_MEGA2560
+
+#endif // SIM_ARDUINO_H
@@ -0,0 +1,245 @@
+/*
+ * Fixture.cpp - Simulated test fixture, see Fixture.h
+ */
+
+#include "Fixture.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "BoardTraits.h"
+#include "SimBoard.h"
+
+Fixture fixtures[HEAD_COUNT];
+
+// The head being evaluated; each entry point below selects it
+static Fixture *fx = fixtures;
+static uint8_t fxHead = 1;
+
+static void selectHead(uint8_t head) {
+  fxHead = head;
+  fx = &fixtures[head - 1];
+}
+
+static const SimPin &headPin(uint8_t pin) {
+  return simHeadPin(fxHead, pin);
+}
+
+const char *const CONTACT_NAMES[NUM_CONTACTS] = {"tip", "sleeve", "p1", "p2", "p3", "shell"};
+
+// The fixture's parts, not the firmware's estimates of them
+static const double SENSE_MOHM = 20000;   // High-side sense resistor
+static const double VCE_MV = 300;         // PN2222A collector-emitter when saturated
+
+// A good cable's conductors
+static const long CABLE_MOHM[NUM_CONTACTS] = {120, 120, 100, 150, 150, 0};
+
+void fixtureDefaults() {
+  memset(fixtures, 0, sizeof(fixtures));
+  for (uint8_t head = 1; head <= HEAD_COUNT; head++) {
+    selectHead(head);
+    fx->pathMohm = 50;
+    fx->supplyMv = BoardAdc::SUPPLY_MV;
+    fx->lagUs = 40;
+    fx->relayUs = 4000;
+    fx->tauUs = 200;
+    fx->noise = ADC_MAX / 1000;
+    fx->seed = 1;
+    fixtureCable(head, false, false);
+  }
+}
+
+void fixtureCable(uint8_t head, bool ts, bool xlr) {
+  selectHead(head);
+  fx->ts = ts;
+  fx->xlr = xlr;
+  for (uint8_t c = 0; c < NUM_CONTACTS; c++) {
+    fx->wire[c] = c == C_SHELL ? -1 : c;   // Shells only meet through the pin 1 bonds
+    fx->nearShorts[c] = 0;
+    fx->farShorts[c] = 0;
+    fx->mohm[c] = CABLE_MOHM[c];
+    fx->dropFromNs[c] = 0;
+    fx->dropToNs[c] = 0;
+  }
+  fx->nearBond = true;
+  fx->farBond = true;
+}
+
+bool fixtureContact(const char *name, uint8_t &contact) {
+  for (uint8_t c = 0; c < NUM_CONTACTS; c++) {
+    if (strcmp(name, CONTACT_NAMES[c]) == 0) {
+      contact = c;
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool plugged(uint8_t contact) {
+  return contact <= C_SLEEVE ? fx->ts : fx->xlr;
+}
+
+// Inside a .drop window
+static bool dropped(uint8_t contact) {
+  return simNow() >= fx->dropFromNs[contact] && simNow() < fx->dropToNs[contact];
+}
+
+// Drive state `delayUs` after its last change: relay contacts trail the
+// coil, sense lines trail the drive
+static bool driveAfter(uint8_t pin, uint32_t delayUs) {
+  const SimPin &p = headPin(pin);
+  return simNow() - p.changeNs >= (uint64_t)delayUs * 1000 ? p.drive : p.lastDrive;
+}
+
+static bool relay(uint8_t pin) {
+  return driveAfter(pin, fx->relayUs);
+}
+
+// ===== NETS =====
+// Node n < NUM_CONTACTS is a near contact, NUM_CONTACTS + c the far one
+#define FAR(c)  (NUM_CONTACTS + (c))
+
+struct Nets {
+  uint8_t parent[2 * NUM_CONTACTS];
+
+  uint8_t find(uint8_t n) {
+    while (parent[n] != n) n = parent[n] = parent[parent[n]];
+    return n;
+  }
+  void join(uint8_t a, uint8_t b) { parent[find(a)] = find(b); }
+};
+
+static void buildNets(Nets &nets) {
+  for (uint8_t n = 0; n < 2 * NUM_CONTACTS; n++) nets.parent[n] = n;
+  for (uint8_t c = 0; c < NUM_CONTACTS; c++) {
+    if (!plugged(c)) continue;
+    if (fx->wire[c] >= 0 && plugged(fx->wire[c]) && !dropped(c)) nets.join(c, FAR(fx->wire[c]));
+    for (uint8_t d = 0; d < NUM_CONTACTS; d++) {
+      if (!plugged(d)) continue;
+      if (fx->nearShorts[c] & (1 << d)) nets.join(c, d);
+      if (fx->farShorts[c] & (1 << d)) nets.join(FAR(c), FAR(d));
+    }
+  }
+  if (fx->xlr && fx->nearBond) nets.join(C_SHELL, C_P1);
+  if (fx->xlr && fx->farBond) nets.join(FAR(C_SHELL), FAR(C_P1));
+  // K1+K2 LOW shorts the far TS contacts to close the resistance loop
+  if (!relay(K1_K2_RELAY)) nets.join(FAR(C_TIP), FAR(C_SLEEVE));
+}
+
+// Node a continuity drive or sense pin reaches through the relays, -1 = none
+static int pinNode(uint8_t pin) {
+  bool tsCont = relay(K1_K2_RELAY);
+  if (pin == TS_CONT_OUT_TIP) return tsCont ? C_TIP : -1;
+  if (pin == TS_CONT_OUT_SLEEVE) return tsCont ? C_SLEEVE : -1;
+  if (pin == TS_CONT_IN_TIP) return tsCont ? FAR(C_TIP) : -1;
+  if (pin == TS_CONT_IN_SLEEVE) return tsCont ? FAR(C_SLEEVE) : -1;
+  if (pin == XLR_CONT_OUT_PIN1) return C_P1;
+  if (pin == XLR_CONT_IN_PIN1) return FAR(C_P1);
+  if (pin == XLR_CONT_OUT_PIN2) return relay(K5_RELAY) ? -1 : C_P2;
+  if (pin == XLR_CONT_IN_PIN2) return relay(K5_RELAY) ? -1 : FAR(C_P2);
+  if (pin == XLR_CONT_OUT_PIN3) return relay(K6_RELAY) ? -1 : C_P3;
+  if (pin == XLR_CONT_IN_PIN3) return relay(K6_RELAY) ? -1 : FAR(C_P3);
+  if (pin == XLR_CONT_OUT_SHELL) return C_SHELL;
+  if (pin == XLR_CONT_IN_SHELL) return FAR(C_SHELL);
+  return -1;
+}
+
+static const uint8_t DRIVE_PINS[] = {
+  TS_CONT_OUT_TIP, TS_CONT_OUT_SLEEVE,
+  XLR_CONT_OUT_PIN1, XLR_CONT_OUT_PIN2, XLR_CONT_OUT_PIN3, XLR_CONT_OUT_SHELL,
+};
+
+// HIGH once a drive on the same net has been HIGH for lagUs; an output
+// driving LOW onto the net wins
+bool fixtureSense(uint8_t head, uint8_t pin) {
+  selectHead(head);
+  for (uint8_t c = 0; c < NUM_CONTACTS; c++) {
+    if (SENSE_PINS[c] == pin && (fx->stuckSense & (1 << c))) return true;
+  }
+  int node = pinNode(pin);
+  if (node < 0) return false;
+  Nets nets;
+  buildNets(nets);
+  uint8_t net = nets.find(node);
+  bool high = false;
+  for (uint8_t drive : DRIVE_PINS) {
+    int n = pinNode(drive);
+    if (n < 0 || nets.find(n) != net) continue;
+    const SimPin &p = headPin(drive);
+    if (p.mode == OUTPUT && !p.level) return false;
+    if (driveAfter(drive, fx->lagUs)) high = true;
+  }
+  return high;
+}
+
+// Counts each fight once, from the drive change that starts it
+void fixtureDriveChanged(uint8_t head) {
+  selectHead(head);
+  Nets nets;
+  buildNets(nets);
+  bool fight = false;
+  for (uint8_t a : DRIVE_PINS) {
+    int na = pinNode(a);
+    if (na < 0 || !headPin(a).drive) continue;
+    for (uint8_t b : DRIVE_PINS) {
+      const SimPin &pb = headPin(b);
+      int nb = pinNode(b);
+      if (nb >= 0 && pb.mode == OUTPUT && !pb.level && nets.find(na) == nets.find(nb)) fight = true;
+    }
+  }
+  if (fight && !fx->fighting) fx->contention++;
+  fx->fighting = fight;
+}
+
+// ===== RESISTANCE =====
+// Cable resistance in the loop the relays close, milliohms; -1 = open
+static long loopMohm() {
+  if (!relay(K3_RELAY)) {
+    // TS: out on the near tip, back on the near sleeve through the far short
+    if (relay(K1_K2_RELAY) || !fx->ts) return -1;
+    if (fx->nearShorts[C_TIP] & (1 << C_SLEEVE)) return 0;
+    Nets nets;
+    buildNets(nets);
+    if (nets.find(C_TIP) != nets.find(C_SLEEVE)) return -1;
+    return fx->mohm[C_TIP] + fx->mohm[C_SLEEVE];
+  }
+  // XLR: K4 picks pin 2 or 3, whose K5/K6 must have moved it off continuity
+  uint8_t c = relay(K4_RELAY) ? C_P3 : C_P2;
+  if (!relay(c == C_P2 ? K5_RELAY : K6_RELAY)) return -1;
+  if (!fx->xlr || fx->wire[c] != c || dropped(c)) return -1;
+  return fx->mohm[c];
+}
+
+// A0 = Vce + (Vcc - Vce) * R / (Rsense + R): the sense resistor over the
+// cable, fixture path and saturated transistor. With the transistor off or
+// the loop open no current flows and A0 sits at the rail. After the drive
+// turns on, A0 falls to that level with time constant tauUs.
+double fixtureAnalog(uint8_t pin) {
+  if (pin != RES_SENSE) return 0;
+  selectHead(1);
+  const SimPin &drive = headPin(RES_TEST_OUT);
+  long cable = loopMohm();
+  if (!drive.drive || cable < 0) return 1.0;
+
+  double supply = fx->supplyMv;
+  double r = cable + fx->pathMohm;
+  double level = (VCE_MV + (supply - VCE_MV) * r / (SENSE_MOHM + r)) / supply;
+  if (fx->tauUs > 0) {
+    double t = (simNow() - drive.changeNs) / 1000.0;
+    level += (1.0 - level) * exp(-t / fx->tauUs);
+  }
+  return level;
+}
+
+// Uniform in [-noise, noise] counts, as a fraction of full scale;
+// xorshift32 so a seed replays exactly
+double fixtureNoise() {
+  selectHead(1);
+  if (fx->noise == 0) return 0;
+  uint32_t x = fx->seed ? fx->seed : 1;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  fx->seed = x;
+  return ((int)(x % (2u * fx->noise + 1)) - fx->noise) / (double)ADC_MAX;
+}
@@ -0,0 +1,64 @@
+/*
+ * Fixture.h - Simulated test fixture: relays, the cable under test and
+ * its faults
+ *
+ * Each cable contact has a near node (the connector the drives feed) and
+ * a far node (the one the senses read). Conductors join near to far,
+ * faults add or remove joints, and the relays route the drive/sense pins
+ * and the resistance loop the way the real fixture does (pin map from the
+ * board header, relay roles from its comments). A sense input reads HIGH
+ * when its node shares a net with a drive that has been HIGH for lagUs.
+ *
+ * Each test head has its own fixture and cable; only head 1 has the
+ * resistance circuit, so fixtureAnalog() and the ADC noise are head 1's.
+ */
+
+#ifndef SIM_FIXTURE_H
+#define SIM_FIXTURE_H
+
+#include <stdint.h>
+
+#include "BoardTraits.h"
+
+enum Contact { C_TIP, C_SLEEVE, C_P1, C_P2, C_P3, C_SHELL, NUM_CONTACTS };
+
+extern const char *const CONTACT_NAMES[NUM_CONTACTS];   // "tip", "sleeve", "p1", ...
+
+struct Fixture {
+  // --- Cable under test ---
+  bool ts;                            // TS cable plugged in (tip, sleeve)
+  bool xlr;                           // XLR cable plugged in (pins 1-3, shell)
+  int8_t wire[NUM_CONTACTS];          // Far contact each near contact is wired to, -1 = open
+  uint8_t nearShorts[NUM_CONTACTS];   // Contacts (bitmask) shorted to this one at the near end
+  uint8_t farShorts[NUM_CONTACTS];    // ... and at the far end
+  bool nearBond;                      // XLR shell to pin 1 in the near connector
+  bool farBond;                       // ... and in the far one
+  long mohm[NUM_CONTACTS];            // Conductor resistance
+  uint64_t dropFromNs[NUM_CONTACTS];  // Intermittent: conductor open over [from, to)
+  uint64_t dropToNs[NUM_CONTACTS];
+  // --- Fixture ---
+  uint8_t stuckSense;                 // Contacts (bitmask) whose sense input is shorted to the supply
+  long pathMohm;                      // Relay contacts and wiring in the resistance loop
+  uint16_t supplyMv;
+  uint32_t lagUs;                     // Sense rise/fall time through the cable
+  uint32_t relayUs;                   // Relay armature travel
+  uint32_t tauUs;                     // Resistance sense time constant
+  uint16_t noise;                     // ADC noise, +/- counts at full resolution
+  uint32_t seed;                      // Noise generator state
+  // --- Observed ---
+  unsigned long contention;           // Times a HIGH and a LOW output ended up on one net
+  bool fighting;                      // ... and one is now
+};
+
+extern Fixture fixtures[HEAD_COUNT];            // Head n's is fixtures[n - 1]
+
+void fixtureDefaults();                         // Nothing plugged in, nominal fixtures
+void fixtureCable(uint8_t head, bool ts, bool xlr);   // Good cables plugged in, faults cleared
+bool fixtureContact(const char *name, uint8_t &contact);
+
+bool fixtureSense(uint8_t head, uint8_t pin);   // Digital level at a sense input
+double fixtureAnalog(uint8_t pin);              // Analog input, fraction of the supply
+double fixtureNoise();                          // Next noise sample, fraction of full scale
+void fixtureDriveChanged(uint8_t head);         // Check the new drives for contention
+
+#endif // SIM_FIXTURE_H
@@ -0,0 +1,525 @@
+/*
+ * SimBoard.cpp - The simulator's Arduino core: virtual clock, pins, and the
+ * Mega registers, see SimBoard.h
+ */
+
+#include "SimBoard.h"
+
+#include <math.h>
+
+#include "BoardTraits.h"
+#include "Fixture.h"
+
+SimCosts simCosts;
+SimCounters simCounters;
+
+static uint64_t nowNs;
+static SimPin pinState[NUM_DIGITAL_PINS];
+static bool irqEnabled;
+static bool inIsr;
+static uint8_t adcBits;
+
+static const SimPin NO_PIN = {};
+
+const SimPin &simPin(uint8_t pin) {
+  return pin < NUM_DIGITAL_PINS ? pinState[pin] : NO_PIN;
+}
+
+uint64_t simNow() {
+  return nowNs;
+}
+
+// Core call costs come out of the code that made them, not out of an ISR
+// (SimCosts::isr covers the whole handler)
+static void charge(uint32_t ns) {
+  if (!inIsr) simAdvance(ns);
+}
+
+// False if nothing changed
+static bool updatePin(SimPin &p, uint8_t mode, uint8_t level) {
+  if (mode == INPUT_PULLUP) {
+    mode = INPUT;
+    level = HIGH;
+  }
+  if (p.mode == mode && p.level == level) return false;
+  bool drive = mode == OUTPUT && level;
+  p.mode = mode;
+  p.level = level;
+  if (drive != p.drive) {
+    p.lastDrive = p.drive;
+    p.drive = drive;
+    p.changeNs = nowNs;
+  }
+  return true;
+}
+
+#if CABLE_TESTER_HEADS > 1
+static void chainEdge(uint8_t pin, bool rising);
+static bool chainSenseOut();
+#endif
+
+static void setPin(uint8_t pin, uint8_t mode, uint8_t level) {
+  if (pin >= NUM_DIGITAL_PINS) return;
+  SimPin &p = pinState[pin];
+  bool wasLevel = p.level;
+  uint64_t resOnNs = pin == RES_TEST_OUT && p.drive ? nowNs - p.changeNs : 0;
+  if (!updatePin(p, mode, level)) return;
+  if (resOnNs && !p.drive) simCounters.resDriveNs += resOnNs;
+#if CABLE_TESTER_HEADS > 1
+  if (pin == HEAD_CLOCK || pin == HEAD_LATCH || pin == HEAD_LOAD) {
+    if (p.level != wasLevel) chainEdge(pin, p.level);
+    return;
+  }
+#else
+  (void)wasLevel;
+#endif
+  fixtureDriveChanged(1);
+}
+
+// Outputs read back their latch; inputs read the fixture
+static bool readPin(uint8_t pin) {
+  if (pin >= NUM_DIGITAL_PINS) return false;
+  if (pinState[pin].mode == OUTPUT) return pinState[pin].level;
+#if CABLE_TESTER_HEADS > 1
+  if (pin == HEAD_SENSE) return chainSenseOut();
+#endif
+  return fixtureSense(1, pin);
+}
+
+#if CABLE_TESTER_HEADS > 1
+// ===== HEAD CHAIN =====
+// The 74HC595s and 74HC165s of TEST HEADS in BoardTraits.h. Heads 2..n
+// have no pins of their own: the fixture sees their outputs as latched.
+constexpr uint8_t CHAIN_HEADS = HEAD_COUNT - 1;
+
+static uint16_t chainStages[CHAIN_HEADS];     // 595 shift stages, head n is [n - 2]
+static SimPin headPins[CHAIN_HEADS][NUM_DIGITAL_PINS];
+static uint8_t chainSense[CHAIN_HEADS];       // 165 parallel loads
+static uint16_t chainSenseBit;                // Bits clocked out of the 165s since the load
+
+const SimPin &simHeadPin(uint8_t head, uint8_t pin) {
+  if (head == 1) return simPin(pin);
+  return head <= HEAD_COUNT && pin < NUM_DIGITAL_PINS ? headPins[head - 2][pin] : NO_PIN;
+}
+
+// Head 2's 165 is nearest the board, so its D7 comes out first; past the
+// last head the chain's serial input is tied LOW
+static bool chainSenseOut() {
+  if (chainSenseBit >= 8 * CHAIN_HEADS) return false;
+  return (chainSense[chainSenseBit / 8] >> (7 - chainSenseBit % 8)) & 1;
+}
+
+// The latch moves every stage to its head's outputs: bits 0-11 are the
+// OUTPUT_PINS levels, bits 12-15 the XLR drive enables
+static void latchChain() {
+  for (uint8_t h = 0; h < CHAIN_HEADS; h++) {
+    bool changed = false;
+    for (uint8_t i = 0; i < sizeof(OUTPUT_PINS); i++) {
+      uint8_t pin = OUTPUT_PINS[i];
+      uint8_t mode = OUTPUT;
+      for (uint8_t d = 0; d < sizeof(XLR_DRIVE_PINS); d++) {
+        if (XLR_DRIVE_PINS[d] == pin && !((chainStages[h] >> (sizeof(OUTPUT_PINS) + d)) & 1)) mode = INPUT;
+      }
+      changed |= updatePin(headPins[h][pin], mode, (chainStages[h] >> i) & 1);
+    }
+    if (changed) fixtureDriveChanged(h + 2);
+  }
+}
+
+static void chainEdge(uint8_t pin, bool rising) {
+  if (pin == HEAD_LOAD) {
+    if (rising) return;
+    // SH/LD LOW: every 165 loads its head's senses
+    for (uint8_t h = 0; h < CHAIN_HEADS; h++) {
+      chainSense[h] = 0;
+      for (uint8_t b = 0; b < sizeof(SENSE_PINS); b++) {
+        if (fixtureSense(h + 2, SENSE_PINS[b])) chainSense[h] |= 1 << b;
+      }
+    }
+    chainSenseBit = 0;
+  } else if (pin == HEAD_LATCH) {
+    if (rising) latchChain();
+  } else if (rising) {
+    // The clock shifts both chains; a 595 stage takes the one before it
+    bool carry = pinState[HEAD_DATA].level;
+    for (uint16_t &stages : chainStages) {
+      bool out = stages >> 15;
+      stages = (stages << 1) | carry;
+      carry = out;
+    }
+    if (pinState[HEAD_LOAD].level) chainSenseBit++;
+  }
+}
+
+// 595s cleared at power-on: outputs LOW, XLR drives not enabled
+static void resetChain() {
+  memset(chainStages, 0, sizeof(chainStages));
+  memset(headPins, 0, sizeof(headPins));
+  latchChain();
+  chainSenseBit = 8 * CHAIN_HEADS;
+}
+#else
+const SimPin &simHeadPin(uint8_t head, uint8_t pin) {
+  return head == 1 ? simPin(pin) : NO_PIN;
+}
+
+static void resetChain() {
+}
+#endif
+
+uint16_t simAdcMax() {
+  return (1u << adcBits) - 1;
+}
+
+// One conversion of an analog pin at the current resolution
+static uint16_t convert(uint8_t pin) {
+  long max = simAdcMax();
+  long counts = lround((fixtureAnalog(pin) + fixtureNoise()) * max);
+  return counts < 0 ? 0 : counts > max ? max : counts;
+}
+
+// ===== ARDUINO API =====
+void pinMode(uint8_t pin, uint8_t mode) {
+  simCounters.pinMode++;
+  charge(simCosts.pinMode);
+  setPin(pin, mode, pin < NUM_DIGITAL_PINS ? pinState[pin].level : LOW);
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  simCounters.digitalWrite++;
+  charge(simCosts.digitalWrite);
+  if (pin < NUM_DIGITAL_PINS) setPin(pin, pinState[pin].mode, level ? HIGH : LOW);
+}
+
+int digitalRead(uint8_t pin) {
+  simCounters.digitalRead++;
+  charge(simCosts.digitalRead);
+  return readPin(pin) ? HIGH : LOW;
+}
+
+int analogRead(uint8_t pin) {
+  simCounters.analogRead++;
+  if (simAdcFreeRunning()) simCounters.analogReadInBurst++;
+  charge(simCosts.analogRead);
+  return convert(pin < A0 ? pin + A0 : pin);
+}
+
+void analogReadResolution(int bits) {
+#if defined(ARDUINO_ARCH_ZEPHYR)
+  if (bits >= 8 && bits <= 14) adcBits = bits;
+#else
+  (void)bits;
+#endif
+}
+
+unsigned long millis() {
+  charge(simCosts.clockRead);
+  return nowNs / 1000000;
+}
+
+unsigned long micros() {
+  charge(simCosts.clockRead);
+  return nowNs / 1000;
+}
+
+void delay(unsigned long ms) {
+  simAdvance((uint64_t)ms * 1000000);
+}
+
+void delayMicroseconds(unsigned int us) {
+  simAdvance((uint64_t)us * 1000);
+}
+
+#if defined(ARDUINO_AVR_MEGA2560)
+// ===== MEGA REGISTERS =====
+extern "C" void ADC_vect_handler();           // ISR(ADC_vect) in boards/Mega2560.cpp
+extern "C" void TIMER2_COMPA_vect_handler();  // ISR(TIMER2_COMPA_vect)
+
+// Arduino pin behind each port bit (-1: not a pin the fixture uses)
+static const int8_t PORT_E_PINS[8] = {-1, -1, -1, 5, 2, 3, -1, -1};
+static const int8_t PORT_G_PINS[8] = {-1, -1, -1, -1, -1, 4, -1, -1};
+static const int8_t PORT_F_PINS[8] = {54, 55, 56, 57, 58, 59, 60, 61};
+static const int8_t PORT_K_PINS[8] = {62, 63, 64, 65, 66, 67, 68, 69};
+
+SimPortReg PINE(PORT_E_PINS, SimPortReg::PIN);
+SimPortReg PING(PORT_G_PINS, SimPortReg::PIN);
+SimPortReg PINF(PORT_F_PINS, SimPortReg::PIN);
+SimPortReg PINK(PORT_K_PINS, SimPortReg::PIN);
+SimPortReg PORTF(PORT_F_PINS, SimPortReg::PORT);
+SimPortReg PORTK(PORT_K_PINS, SimPortReg::PORT);
+SimPortReg DDRF(PORT_F_PINS, SimPortReg::DDR);
+SimPortReg DDRK(PORT_K_PINS, SimPortReg::DDR);
+
+SimPortReg::operator uint8_t() const {
+  simCounters.portAccess++;
+  charge(simCosts.portAccess);
+  uint8_t value = 0;
+  for (uint8_t bit = 0; bit < 8; bit++) {
+    int8_t pin = pins[bit];
+    if (pin < 0) continue;
+    bool set = kind == PIN ? readPin(pin) : kind == PORT ? pinState[pin].level : pinState[pin].mode == OUTPUT;
+    if (set) value |= 1 << bit;
+  }
+  return value;
+}
+
+SimPortReg &SimPortReg::operator=(uint8_t value) {
+  simCounters.portAccess++;
+  charge(simCosts.portAccess);
+  for (uint8_t bit = 0; bit < 8; bit++) {
+    int8_t pin = pins[bit];
+    if (pin < 0) continue;
+    uint8_t set = (value >> bit) & 1;
+    if (kind == PORT) setPin(pin, pinState[pin].mode, set);
+    else if (kind == DDR) setPin(pin, set ? OUTPUT : INPUT, pinState[pin].level);
+  }
+  return *this;
+}
+
+// --- ADC ---
+SimSreg SREG;
+SimAdcsra ADCSRA;
+volatile uint8_t ADMUX;
+volatile uint8_t ADCSRB;
+volatile uint16_t ADC;
+
+static uint8_t adcsra;
+static bool adcFree;                 // Free-running (ADATE) conversions in progress
+static uint64_t adcNextNs;           // When the next free-running conversion completes
+static uint64_t adcPeriodNs;
+static bool adcSingle;               // Single conversion in progress
+static uint64_t adcSingleNs;         // ... completing then
+static uint16_t adcSingleValue;
+static bool adcIrqPending;           // Conversion done with interrupts off
+
+// 16 MHz / prescaler; ADPS 0 and 1 both divide by 2
+static uint64_t adcClockNs() {
+  uint8_t ps = adcsra & 7;
+  return (ps ? 1u << ps : 2u) * 125 / 2;
+}
+
+// Mux input now: ADC0-7 are A0-A7, 0x1E the 1.1 V bandgap
+static uint16_t adcInput() {
+  uint8_t mux = ADMUX & 0x1F;
+  if (mux == 0x1E) return lround(1100.0 * simAdcMax() / fixtures[0].supplyMv);
+  return mux < 8 ? convert(A0 + mux) : 0;
+}
+
+static void runIsr() {
+  adcIrqPending = false;
+  simCounters.isr++;
+  inIsr = true;
+  ADC_vect_handler();
+  inIsr = false;
+  nowNs += simCosts.isr;
+}
+
+// --- Timer2 ---
+SimTccr2b TCCR2B;
+volatile uint8_t TCCR2A;
+volatile uint8_t TCNT2;
+volatile uint8_t OCR2A;
+volatile uint8_t TIFR2;
+volatile uint8_t TIMSK2;
+
+static uint8_t tccr2b;
+static bool timerOn;                 // CTC compare matches are coming
+static uint64_t timerNextNs;
+static uint64_t timerPeriodNs;
+static bool timerIrqPending;         // Match with interrupts off
+
+static void runTimerIsr() {
+  timerIrqPending = false;
+  simCounters.timerIsr++;
+  inIsr = true;
+  TIMER2_COMPA_vect_handler();
+  inIsr = false;
+  nowNs += simCosts.timerIsr;
+}
+
+SimTccr2b::operator uint8_t() const {
+  return tccr2b;
+}
+
+// Clock select starts the count from TCNT2 = 0; matches every OCR2A + 1 ticks
+SimTccr2b &SimTccr2b::operator=(uint8_t value) {
+  static const uint16_t PRESCALE[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+  simCounters.portAccess++;
+  charge(simCosts.portAccess);
+  tccr2b = value;
+  uint16_t ps = PRESCALE[value & 7];
+  timerOn = ps && (TCCR2A & _BV(WGM21));
+  timerPeriodNs = (uint64_t)ps * (OCR2A + 1) * 125 / 2;
+  timerNextNs = nowNs + timerPeriodNs;
+  return *this;
+}
+
+bool simAdcFreeRunning() {
+  return adcFree;
+}
+
+SimAdcsra::operator uint8_t() const {
+  simCounters.portAccess++;
+  charge(simCosts.portAccess);
+  if (adcSingle && nowNs >= adcSingleNs) {
+    adcSingle = false;
+    ADC = adcSingleValue;
+  }
+  return adcsra | (adcFree || adcSingle ? _BV(ADSC) : 0);
+}
+
+SimAdcsra &SimAdcsra::operator=(uint8_t value) {
+  simCounters.portAccess++;
+  charge(simCosts.portAccess);
+  bool wasEnabled = adcsra & _BV(ADEN);
+  adcsra = value & ~(_BV(ADSC) | _BV(ADIF));   // ADSC reads back the conversion; ADIF is write-1-to-clear
+  if (!(value & _BV(ADEN)) || !(value & _BV(ADATE))) adcFree = false;
+  if (!(value & _BV(ADEN))) adcSingle = false;
+  if ((value & _BV(ADEN)) && (value & _BV(ADSC))) {
+    // The first conversion after enabling takes 25 ADC clocks, later ones 13
+    uint64_t first = (wasEnabled ? 13 : 25) * adcClockNs();
+    if (value & _BV(ADATE)) {
+      adcFree = true;
+      adcNextNs = nowNs + first;
+      adcPeriodNs = 13 * adcClockNs();
+    } else {
+      adcSingle = true;
+      adcSingleNs = nowNs + first;
+      adcSingleValue = adcInput();
+    }
+  }
+  return *this;
+}
+
+SimSreg::operator uint8_t() const {
+  return irqEnabled ? 0x80 : 0;
+}
+
+SimSreg &SimSreg::operator=(uint8_t value) {
+  irqEnabled = value & 0x80;
+  if (irqEnabled && adcIrqPending && !inIsr) runIsr();
+  if (irqEnabled && timerIrqPending && !inIsr) runTimerIsr();
+  return *this;
+}
+
+void cli() {
+  irqEnabled = false;
+}
+
+void sei() {
+  SREG = 0x80;
+}
+
+void noInterrupts() {
+  cli();
+}
+
+void interrupts() {
+  sei();
+}
+
+// Conversions and compare matches due by the target, in time order
+void simAdvance(uint64_t ns) {
+  uint64_t target = nowNs + ns;
+  for (;;) {
+    bool adcDue = adcFree && adcNextNs <= target;
+    bool timerDue = timerOn && timerNextNs <= target;
+    if (!adcDue && !timerDue) break;
+    if (adcDue && (!timerDue || adcNextNs <= timerNextNs)) {
+      nowNs = adcNextNs;
+      adcNextNs += adcPeriodNs;
+      ADC = adcInput();
+      if (!(adcsra & _BV(ADIE))) continue;
+      if (irqEnabled && !inIsr) {
+        runIsr();
+        target += simCosts.isr;
+      } else {
+        adcIrqPending = true;
+      }
+    } else {
+      nowNs = timerNextNs;
+      timerNextNs += timerPeriodNs;
+      if (!(TIMSK2 & _BV(OCIE2A))) continue;
+      if (irqEnabled && !inIsr) {
+        runTimerIsr();
+        target += simCosts.timerIsr;
+      } else {
+        timerIrqPending = true;
+      }
+    }
+  }
+  if (target > nowNs) nowNs = target;
+}
+
+static void resetRegisters() {
+  adcsra = _BV(ADEN) | 7;   // Core init(): enabled, /128
+  adcFree = false;
+  adcSingle = false;
+  adcIrqPending = false;
+  tccr2b = _BV(CS22);       // Core init(): phase-correct PWM, /64, no interrupt
+  TCCR2A = _BV(WGM20);
+  TIMSK2 = 0;
+  timerOn = false;
+  timerIrqPending = false;
+  ADMUX = 0;
+  ADCSRB = 0;
+  ADC = 0;
+}
+
+void simLoadCosts() {
+  simCosts.digitalRead = 3500;
+  simCosts.digitalWrite = 3800;
+  simCosts.pinMode = 4000;
+  simCosts.analogRead = 112000;   // One /128 conversion plus core overhead
+  simCosts.clockRead = 3000;
+  simCosts.portAccess = 125;
+  simCosts.isr = 4000;
+  simCosts.timerIsr = 5000;       // readSense() and the queue check
+  simCosts.loopPass = 20000;      // Serial polling and the LED
+}
+
+#else
+// ===== UNO Q =====
+// No registers and no interrupts the library uses; bursts are analogRead()
+void noInterrupts() {
+  irqEnabled = false;
+}
+
+void interrupts() {
+  irqEnabled = true;
+}
+
+bool simAdcFreeRunning() {
+  return false;
+}
+
+void simAdvance(uint64_t ns) {
+  nowNs += ns;
+}
+
+static void resetRegisters() {
+}
+
+void simLoadCosts() {
+  simCosts.digitalRead = 1000;
+  simCosts.digitalWrite = 1200;
+  simCosts.pinMode = 8000;        // gpio_pin_configure()
+  simCosts.analogRead = 25000;
+  simCosts.clockRead = 500;
+  simCosts.portAccess = 0;
+  simCosts.isr = 0;
+  simCosts.timerIsr = 0;
+  simCosts.loopPass = 100000;     // Bridge polling and the matrix scroll
+}
+#endif
+
+void simReset() {
+  nowNs = 0;
+  inIsr = false;
+  irqEnabled = true;
+  adcBits = 10;
+  memset(pinState, 0, sizeof(pinState));
+  memset(&simCounters, 0, sizeof(simCounters));
+  resetRegisters();
+  resetChain();
+}
@@ -0,0 +1,69 @@
+/*
+ * SimBoard.h - Virtual clock, pin state and cost model behind the
+ * simulator's Arduino.h
+ *
+ * Time is kept in nanoseconds and only advances when the firmware spends
+ * it: every core call is charged its SimCosts entry, delay() and
+ * delayMicroseconds() advance by their argument, and the shell charges
+ * one loop pass per loop(). On the Mega, free-running ADC conversions
+ * complete (and run ADC_vect) as the clock passes them, as do Timer2
+ * compare matches (TIMER2_COMPA_vect), and each ISR takes its cost out of
+ * the code it interrupted.
+ */
+
+#ifndef SIM_BOARD_H
+#define SIM_BOARD_H
+
+#include <Arduino.h>
+
+// Per-call cost in ns. Defaults are rough figures for each board's core
+// (Mega: 16 MHz AVR core; UNO Q: Zephyr GPIO/ADC API on the STM32U585);
+// the scenario .cost directive overrides them.
+struct SimCosts {
+  uint32_t digitalRead;
+  uint32_t digitalWrite;
+  uint32_t pinMode;
+  uint32_t analogRead;
+  uint32_t clockRead;     // millis() / micros()
+  uint32_t portAccess;    // One port or ADC register read/write (Mega)
+  uint32_t isr;           // ADC_vect entry to exit (Mega)
+  uint32_t timerIsr;      // TIMER2_COMPA_vect entry to exit (Mega, FLEX)
+  uint32_t loopPass;      // Shell work per loop() outside poll()
+};
+
+// Calls made, for .bench
+struct SimCounters {
+  unsigned long digitalRead;
+  unsigned long digitalWrite;
+  unsigned long pinMode;
+  unsigned long analogRead;
+  unsigned long portAccess;
+  unsigned long isr;                 // ADC_vect
+  unsigned long timerIsr;            // TIMER2_COMPA_vect
+  unsigned long analogReadInBurst;   // analogRead() while the ADC free-runs
+  uint64_t resDriveNs;               // RES_TEST_OUT driven (current through the sense resistor)
+};
+
+// A pin as the fixture sees it. `drive` is output-and-HIGH; the previous
+// drive state and when it changed let the fixture model rise/fall time.
+struct SimPin {
+  uint8_t mode;
+  uint8_t level;
+  bool drive;
+  bool lastDrive;
+  uint64_t changeNs;
+};
+
+extern SimCosts simCosts;
+extern SimCounters simCounters;
+
+void simReset();                          // Power-on: pins, clock, ADC, counters
+uint64_t simNow();                        // Virtual time, ns
+void simAdvance(uint64_t ns);             // Spend ns (ADC conversions and ISRs fire)
+const SimPin &simPin(uint8_t pin);
+const SimPin &simHeadPin(uint8_t head, uint8_t pin);   // A pin of a test head; head 1's is simPin()
+uint16_t simAdcMax();                     // Full scale at the current resolution
+bool simAdcFreeRunning();                 // Mega: an OP_ADC burst is running
+void simLoadCosts();                      // This board's default SimCosts
+
+#endif // SIM_BOARD_H
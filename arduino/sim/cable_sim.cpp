@@ -0,0 +1,683 @@
+/*
+ * cable_sim.cpp - Host simulator for the cable tester firmware
+ *
+ * Runs the CableTester library with the real board I/O layer for one
+ * board (built with -DARDUINO_AVR_MEGA2560 or -DARDUINO_ARCH_ZEPHYR)
+ * against a simulated fixture, on a virtual clock (SimBoard.h, Fixture.h).
+ * SimTester stands in for the sketch shell: replies go to stdout, the
+ * calibration slots, config and wear counters are in memory and survive
+ * .reboot, showResult() prints SHOW:<result>. Transport and display code in
+ * the .ino files is not part of the simulation.
+ *
+ *   cable_sim [--times] [--golden] [scenario.sim ...]   (stdin without files)
+ *   cable_sim --fuzz <steps> [--seed <n>]
+ *
+ * A scenario is one line per tester command, or a fixture directive:
+ *   .cable ts|xlr|both|none      Plug in good cables (clears faults)
+ *   .open <contact>              Break a conductor (tip sleeve p1 p2 p3)
+ *   .short <a> <b> [near|far]    Join two contacts at one end (default near)
+ *   .cross <a> <b>               Swap two conductors
+ *   .bond near|far on|off        XLR shell to pin 1 bond in one connector
+ *   .res <contact> <mohm>        Conductor resistance
+ *   .drop <contact> <us> <for>   Open a conductor <us> from now for <for> us
+ *   .set <param> <value>         lag/relay/tau (us), noise (counts),
+ *                                supply (mV; 0 = nominal, -N = N below it),
+ *                                path (mohm), seed
+ *   .cost <call> <ns>            Override a SimCosts entry
+ *   .wait <ms>                   Keep looping (AUTO, supply polls)
+ *   .stuck <contact> on|off      Short the contact's sense input to the supply
+ *                                (a fixture fault: .cable doesn't clear it)
+ *   .reboot                      Power cycle; calibration, config and counters are kept
+ *   .expect <text>               The last command's replies must contain text
+ *   .bench <n> <command>         Run a command n times, print BENCH:...
+ *   .head <n>                    Later fixture directives act on head n's
+ *                                fixture (multi-head builds; default 1)
+ *   .send <command>              Send a command and carry on without waiting
+ *   // comment
+ *
+ * The Mega build has three test heads on the head chain (TEST HEADS in
+ * BoardTraits.h); replies from heads 2 and 3 start with H2:/H3: as they do
+ * from the sketch.
+ *
+ * Each command runs until every head is idle again. --times prefixes every
+ * line with the virtual time in ms; --golden drops the timing that moves
+ * with firmware speed (:SETTLE: values, binary settle slots) so the output
+ * can be compared with golden/<board>/<scenario>.out. Exit status is 1 when an
+ * .expect fails, a command never finishes, or fuzzing finds a problem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "CableTester.h"
+#include "Fixture.h"
+#include "SimBoard.h"
+
+
+#define CMD_SIZE       64       // As the sketches: longer lines are truncated
+#define SIM_CAL_SLOTS  16
+#define SIM_STATS_SLOTS 24      // As the Mega sketch
+
+const unsigned long IDLE_TIMEOUT_MS = 30000;   // A command still running after this hung
+
+static bool showTimes = false;
+static bool golden = false;
+static bool quiet = false;                     // Replies collected but not printed
+static int failures = 0;
+
+// Replies to the command being run, for .expect, .bench and fuzzing
+static std::vector<std::string> replies;
+static unsigned long truncatedReplies = 0;
+
+// Calibration slots, session config and wear counters, kept across
+// .reboot like the Mega's EEPROM
+static CalRecord calStore[SIM_CAL_SLOTS];
+static bool calWritten[SIM_CAL_SLOTS];
+static ConfigRecord configStore;
+static bool configWritten;
+static StatsRecord statsStore[SIM_STATS_SLOTS];
+static bool statsWritten[SIM_STATS_SLOTS];
+
+static void emit(const std::string &line) {
+  replies.push_back(line);
+  if (quiet) return;
+  if (showTimes) printf("[%10.3f] ", simNow() / 1e6);
+  printf("%s\n", line.c_str());
+}
+
+// Golden output: ":SETTLE:<us>,<us>" moves with every timing change
+// (a combined reply's parts are separated by '|')
+static std::string stripSettle(std::string line) {
+  size_t at;
+  while ((at = line.find(":SETTLE:")) != std::string::npos) {
+    size_t end = line.find_first_of(":|", at + 8);
+    line.erase(at, end == std::string::npos ? std::string::npos : end - at);
+  }
+  return line;
+}
+
+static std::string headPrefix(uint8_t head) {
+  return head > 1 ? "H" + std::to_string(head) + ":" : "";
+}
+
+static std::string tagPrefix(uint16_t tag) {
+  if (tag == TAG_AUTO) return "EVENT:";
+  if (tag == 0) return "";
+  char prefix[8];
+  snprintf(prefix, sizeof(prefix), "#%u:", tag);
+  return prefix;
+}
+
+// ===== SHELL =====
+class SimTester final : public CableTester {
+protected:
+  void sendReply(uint16_t tag) override {
+    if (replyLen >= REPLY_SIZE - 1) truncatedReplies++;
+    std::string line = headPrefix(head()) + tagPrefix(tag) + replyBuf;
+    emit(golden ? stripSettle(line) : line);
+  }
+
+  // BIN:<hex>; golden keeps the settle count but not the settle times
+  void sendRecord(uint16_t tag, const uint8_t *record, uint8_t len) override {
+    const uint8_t header = 24;
+    uint8_t shown = golden && len >= header ? header : len;
+    std::string line = headPrefix(head()) + tagPrefix(tag) + "BIN:";
+    char hex[3];
+    for (uint8_t i = 0; i < shown; i++) {
+      snprintf(hex, sizeof(hex), "%02X", record[i]);
+      line += hex;
+    }
+    emit(line);
+  }
+
+  void showResult(uint8_t result) override {
+    static const char *const NAMES[] = {"OFF", "PASS", "FAIL", "ERROR"};
+    emit(headPrefix(head()) + "SHOW:" + (result <= SHOW_ERROR ? NAMES[result] : "?"));
+  }
+
+  // FORMAT as on the Mega, so the binary records can be simulated too
+  bool boardCommand(const char *cmd) override {
+    if (!cmdIs(cmd, "FORMAT") && !cmdIs(cmd, "FORMAT TEXT") && !cmdIs(cmd, "FORMAT BIN")) return false;
+    if (!cmdIs(cmd, "FORMAT")) binaryResults = cmdIs(cmd, "FORMAT BIN");
+    replyBegin("FORMAT:");
+    replyAdd(binaryResults ? "BIN" : "TEXT");
+    replySend();
+    return true;
+  }
+
+  uint8_t calSlots() override { return SIM_CAL_SLOTS; }
+
+  bool readCalSlot(uint8_t slot, CalRecord &rec) override {
+    if (!calWritten[slot]) return false;
+    rec = calStore[slot];
+    return true;
+  }
+
+  bool writeCalSlot(uint8_t slot, const CalRecord &rec) override {
+    calStore[slot] = rec;
+    calWritten[slot] = true;
+    return true;
+  }
+
+  const char *calStorage() override { return "SIM"; }
+
+  bool readConfig(ConfigRecord &rec) override {
+    if (!configWritten) return false;
+    rec = configStore;
+    return true;
+  }
+
+  bool writeConfig(const ConfigRecord &rec) override {
+    configStore = rec;
+    configWritten = true;
+    return true;
+  }
+
+  uint8_t statsSlots() override { return SIM_STATS_SLOTS; }
+
+  bool readStatsSlot(uint8_t slot, StatsRecord &rec) override {
+    if (!statsWritten[slot]) return false;
+    rec = statsStore[slot];
+    return true;
+  }
+
+  bool writeStatsSlot(uint8_t slot, const StatsRecord &rec) override {
+    statsStore[slot] = rec;
+    statsWritten[slot] = true;
+    return true;
+  }
+
+public:
+  bool autoOn() const { return autoTest != TEST_NONE; }
+};
+
+static SimTester *heads[HEAD_COUNT];           // Head n is heads[n - 1]
+static uint8_t fixtureHead = 1;                // .head
+
+// Power-on: fresh pins and clock, new testers, calibration slots kept
+static void boot() {
+  for (SimTester *&t : heads) {
+    delete t;
+    t = new SimTester();
+  }
+  simReset();
+  for (uint8_t h = 1; h < HEAD_COUNT; h++) heads[0]->attachHead(*heads[h]);
+  heads[0]->begin();
+}
+
+static bool anyTestRunning() {
+  for (SimTester *t : heads) {
+    if (t->isTestRunning()) return true;
+  }
+  return false;
+}
+
+// Head 1 polls the others
+static void loopOnce() {
+  heads[0]->poll();
+  simAdvance(simCosts.loopPass);
+}
+
+static bool runUntilIdle() {
+  uint64_t deadline = simNow() + (uint64_t)IDLE_TIMEOUT_MS * 1000000;
+  while (anyTestRunning()) {
+    if (simNow() >= deadline) {
+      emit("SIM:TIMEOUT");
+      failures++;
+      return false;
+    }
+    loopOnce();
+  }
+  loopOnce();   // Deferred work (calibration save) runs once idle
+  return true;
+}
+
+static void runFor(unsigned long ms) {
+  uint64_t end = simNow() + (uint64_t)ms * 1000000;
+  while (simNow() < end) loopOnce();
+}
+
+static void sendCommand(const char *line) {
+  char cmd[CMD_SIZE];
+  strncpy(cmd, line, CMD_SIZE - 1);
+  cmd[CMD_SIZE - 1] = '\0';
+  replies.clear();
+  if (!quiet) printf("> %s\n", cmd);
+  heads[0]->handleCommand(cmd);
+}
+
+// ===== SCENARIOS =====
+static bool parseContact(const char *name, uint8_t &contact, const char *where) {
+  if (name && fixtureContact(name, contact)) return true;
+  printf("SIM:ERROR:%s: unknown contact '%s'\n", where, name ? name : "");
+  failures++;
+  return false;
+}
+
+static bool setCost(const char *name, uint32_t ns) {
+  struct { const char *name; uint32_t *cost; } costs[] = {
+    {"digitalRead", &simCosts.digitalRead}, {"digitalWrite", &simCosts.digitalWrite},
+    {"pinMode", &simCosts.pinMode}, {"analogRead", &simCosts.analogRead},
+    {"clockRead", &simCosts.clockRead}, {"portAccess", &simCosts.portAccess},
+    {"isr", &simCosts.isr}, {"timerIsr", &simCosts.timerIsr}, {"loopPass", &simCosts.loopPass},
+  };
+  for (auto &c : costs) {
+    if (strcmp(name, c.name) == 0) {
+      *c.cost = ns;
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool setParam(const char *name, long value) {
+  Fixture &fixture = fixtures[fixtureHead - 1];
+  if (strcmp(name, "lag") == 0) fixture.lagUs = value;
+  else if (strcmp(name, "relay") == 0) fixture.relayUs = value;
+  else if (strcmp(name, "tau") == 0) fixture.tauUs = value;
+  else if (strcmp(name, "noise") == 0) fixture.noise = value;
+  else if (strcmp(name, "supply") == 0) fixture.supplyMv = value > 0 ? value : BoardAdc::SUPPLY_MV + value;
+  else if (strcmp(name, "path") == 0) fixture.pathMohm = value;
+  else if (strcmp(name, "seed") == 0) fixture.seed = value;
+  else return false;
+  return true;
+}
+
+// BENCH:<cmd>:N:<n>:US:<min>/<mean>/<max>:PER_MIN:<tests>:FAIL:<n>:RES_ON:<us>:DUTY:<%>
+// (RES_TEST_OUT on-time per test and its share of the test time) and the
+// core calls one test makes
+static void bench(unsigned long count, const char *cmd) {
+  uint64_t minNs = UINT64_MAX, maxNs = 0, totalNs = 0;
+  unsigned long failed = 0;
+  SimCounters before = simCounters;
+  bool wasQuiet = quiet;
+  quiet = true;
+  for (unsigned long i = 0; i < count; i++) {
+    uint64_t start = simNow();
+    sendCommand(cmd);
+    runUntilIdle();
+    uint64_t ns = simNow() - start;
+    if (ns < minNs) minNs = ns;
+    if (ns > maxNs) maxNs = ns;
+    totalNs += ns;
+    for (const std::string &r : replies) {
+      if (r.find("FAIL") != std::string::npos || r.find("ERROR") != std::string::npos) {
+        failed++;
+        break;
+      }
+    }
+  }
+  quiet = wasQuiet;
+  if (count == 0) return;
+  double mean = (double)totalNs / count;
+  double resOnNs = (double)(simCounters.resDriveNs - before.resDriveNs) / count;
+  printf("BENCH:%s:N:%lu:US:%llu/%.0f/%llu:PER_MIN:%.0f:FAIL:%lu:RES_ON:%.0f:DUTY:%.1f\n", cmd, count,
+         (unsigned long long)(minNs / 1000), mean / 1000, (unsigned long long)(maxNs / 1000),
+         60e9 / mean, failed, resOnNs / 1000, 100 * resOnNs / mean);
+  printf("BENCH:%s:CALLS:DREAD:%.1f:DWRITE:%.1f:PINMODE:%.1f:AREAD:%.1f:PORT:%.1f:ISR:%.1f\n", cmd,
+         (double)(simCounters.digitalRead - before.digitalRead) / count,
+         (double)(simCounters.digitalWrite - before.digitalWrite) / count,
+         (double)(simCounters.pinMode - before.pinMode) / count,
+         (double)(simCounters.analogRead - before.analogRead) / count,
+         (double)(simCounters.portAccess - before.portAccess) / count,
+         (double)(simCounters.isr - before.isr) / count);
+}
+
+// Text after the first `skip` words of a directive
+static std::string restOf(const std::string &line, int skip) {
+  size_t at = 0;
+  for (int i = 0; i < skip; i++) {
+    at = line.find_first_not_of(" \t", at);
+    at = at == std::string::npos ? at : line.find_first_of(" \t", at);
+  }
+  at = at == std::string::npos ? at : line.find_first_not_of(" \t", at);
+  return at == std::string::npos ? "" : line.substr(at);
+}
+
+static void directive(char *line, const char *where) {
+  std::string raw = line;
+  char *name = strtok(line, " \t");
+  char *a = strtok(NULL, " \t");
+  char *b = strtok(NULL, " \t");
+  char *c = strtok(NULL, " \t");
+  uint8_t x, y;
+  Fixture &fixture = fixtures[fixtureHead - 1];
+
+  if (strcmp(name, ".cable") == 0 && a) {
+    bool ts = strcmp(a, "ts") == 0 || strcmp(a, "both") == 0;
+    bool xlr = strcmp(a, "xlr") == 0 || strcmp(a, "both") == 0;
+    if (!ts && !xlr && strcmp(a, "none") != 0) goto bad;
+    fixtureCable(fixtureHead, ts, xlr);
+  } else if (strcmp(name, ".open") == 0) {
+    if (parseContact(a, x, where)) fixture.wire[x] = -1;
+  } else if (strcmp(name, ".short") == 0) {
+    if (!parseContact(a, x, where) || !parseContact(b, y, where)) return;
+    bool far = c && strcmp(c, "far") == 0;
+    uint8_t *shorts = far ? fixture.farShorts : fixture.nearShorts;
+    shorts[x] |= 1 << y;
+    shorts[y] |= 1 << x;
+  } else if (strcmp(name, ".cross") == 0) {
+    if (!parseContact(a, x, where) || !parseContact(b, y, where)) return;
+    int8_t wire = fixture.wire[x];
+    fixture.wire[x] = fixture.wire[y];
+    fixture.wire[y] = wire;
+  } else if (strcmp(name, ".bond") == 0 && a && b) {
+    bool on = strcmp(b, "on") == 0;
+    if (strcmp(a, "near") == 0) fixture.nearBond = on;
+    else if (strcmp(a, "far") == 0) fixture.farBond = on;
+    else goto bad;
+  } else if (strcmp(name, ".stuck") == 0 && b) {
+    if (!parseContact(a, x, where)) return;
+    if (strcmp(b, "on") == 0) fixture.stuckSense |= 1 << x;
+    else fixture.stuckSense &= ~(1 << x);
+  } else if (strcmp(name, ".res") == 0 && b) {
+    if (parseContact(a, x, where)) fixture.mohm[x] = atol(b);
+  } else if (strcmp(name, ".drop") == 0 && c) {
+    if (!parseContact(a, x, where)) return;
+    fixture.dropFromNs[x] = simNow() + strtoull(b, NULL, 10) * 1000;
+    fixture.dropToNs[x] = fixture.dropFromNs[x] + strtoull(c, NULL, 10) * 1000;
+  } else if (strcmp(name, ".set") == 0 && b) {
+    if (!setParam(a, atol(b))) goto bad;
+  } else if (strcmp(name, ".cost") == 0 && b) {
+    if (!setCost(a, strtoul(b, NULL, 10))) goto bad;
+  } else if (strcmp(name, ".wait") == 0 && a) {
+    replies.clear();
+    runFor(strtoul(a, NULL, 10));
+  } else if (strcmp(name, ".reboot") == 0) {
+    replies.clear();
+    boot();
+  } else if (strcmp(name, ".expect") == 0 && a) {
+    std::string text = restOf(raw, 1);
+    for (const std::string &r : replies) {
+      if (r.find(text) != std::string::npos) return;
+    }
+    printf("SIM:EXPECT:%s: no reply contains '%s'\n", where, text.c_str());
+    failures++;
+  } else if (strcmp(name, ".bench") == 0 && b) {
+    bench(strtoul(a, NULL, 10), restOf(raw, 2).c_str());
+  } else if (strcmp(name, ".head") == 0 && a) {
+    unsigned long head = strtoul(a, NULL, 10);
+    if (head < 1 || head > HEAD_COUNT) goto bad;
+    fixtureHead = head;
+  } else if (strcmp(name, ".send") == 0 && a) {
+    sendCommand(restOf(raw, 1).c_str());
+  } else {
+    goto bad;
+  }
+  return;
+
+bad:
+  printf("SIM:ERROR:%s: bad directive\n", where);
+  failures++;
+}
+
+static void runScenario(FILE *f, const char *name) {
+  char line[256];
+  int lineNo = 0;
+  while (fgets(line, sizeof(line), f)) {
+    lineNo++;
+    line[strcspn(line, "\r\n")] = '\0';
+    char *p = line;
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p == '\0' || strncmp(p, "//", 2) == 0) continue;
+
+    char where[160];
+    snprintf(where, sizeof(where), "%s:%d", name, lineNo);
+    if (*p == '.') {
+      directive(p, where);
+    } else {
+      sendCommand(p);
+      runUntilIdle();
+    }
+  }
+}
+
+// ===== FUZZING =====
+// Random command lines (real commands, mangled ones, batches, garbage)
+// sent at random points in running tests, with the cable, faults and
+// power changing underneath. Checked after every step:
+//   - no reply filled replyBuf (it would have been cut off)
+//   - replies are printable text, apart from bytes echoed from the command
+//   - no analogRead() during a free-running burst (Mega)
+//   - nothing hangs: every test finishes within IDLE_TIMEOUT_MS
+//   - idle with no debug toggle since the last test: RES_TEST_OUT is off,
+//     and with AUTO and FLEX off too every output is LOW
+// Build with `make fuzz` to run this under ASan/UBSan.
+static const char *const FUZZ_WORDS[] = {
+  "CONT", "XCONT", "XSHELL", "RES", "XRES", "CAL", "XCAL", "FULL", "XFULL", "XFULL SHELL",
+  "XC", "XS", "XR", "STATUS", "ID", "CALINFO", "CANCEL", "RESET", "SETTLE", "SETTLE FIXED",
+  "SETTLE ADAPTIVE", "PROFILE", "PROFILE XRES", "PROFILE RESET", "PROFILE NOPE", "AUTO",
+  "AUTO XFULL", "AUTO CONT", "AUTO CAL", "AUTO OFF", "AUTO XFULL FAST", "FAST", "FAST ON",
+  "FAST OFF", "XFULL FAST", "XFULL SHELL FAST", "CONT FAST", "CAL FAST", "FAST FAST",
+  "BURST", "BURST ON", "BURST OFF", "RESSTAT", "RESSTAT ON", "RESSTAT OFF",
+  "OVERSAMPLE", "OVERSAMPLE 2", "OVERSAMPLE 4", "OVERSAMPLE 5", "OVERSAMPLE OFF",
+  "BOOT", "BOOT FAST", "BOOT FULL", "STATS", "STATS SAVE", "STATS RESET", "STATS NOPE",
+  "BOTH", "BOTH FAST", "AUTO BOTH",
+  "FLEX", "FLEX TS", "FLEX XLR", "FLEX OFF", "FLEX ON",
+  "FORMAT", "FORMAT BIN", "FORMAT TEXT",
+  "K12", "K3", "K4", "K5", "K6", "TSTIP", "TSSLV", "TSRES", "XLR1", "XLR2", "XLR3", "XLRS",
+  "PINS", "READ", "MEM", "HELP", "", " ", "#", "#0 CONT", "#65535 CONT", "#1", ";", "#7 ;;",
+  "H1:CONT", "H2:XCONT", "H2:CONT", "H3:XSHELL", "H2:XRES", "H3:FULL", "H2:AUTO XCONT",
+  "H3:AUTO CONT", "H2:AUTO OFF", "H2:FLEX XLR", "H3:K5", "H2:TSTIP", "H2:RESET", "H3:CANCEL",
+  "H2:STATUS", "H9:CONT", "H0:ID", "H2:H3:CONT", "#3 H2:CONT", "H2:STATS", "H3:STATS SAVE",
+  "H2:BOTH", "H3:AUTO BOTH",
+};
+static const size_t NUM_FUZZ_WORDS = sizeof(FUZZ_WORDS) / sizeof(FUZZ_WORDS[0]);
+
+static uint32_t fuzzState;
+
+static uint32_t fuzzRand(uint32_t n) {
+  fuzzState ^= fuzzState << 13;
+  fuzzState ^= fuzzState >> 17;
+  fuzzState ^= fuzzState << 5;
+  return n ? fuzzState % n : 0;
+}
+
+static std::string fuzzWord() {
+  std::string w = FUZZ_WORDS[fuzzRand(NUM_FUZZ_WORDS)];
+  switch (fuzzRand(8)) {
+    case 0:   // Mixed case and padding
+      for (char &ch : w) {
+        if (fuzzRand(2)) ch = tolower(ch);
+      }
+      w = std::string(fuzzRand(3), ' ') + w + std::string(fuzzRand(3), '\t');
+      break;
+    case 1:   // Trailing junk
+      w += fuzzRand(2) ? " X" : "?";
+      break;
+    case 2: { // Cut short
+      if (!w.empty()) w.resize(fuzzRand(w.size()));
+      break;
+    }
+    default:
+      break;
+  }
+  return w;
+}
+
+static std::string fuzzLine() {
+  uint32_t kind = fuzzRand(10);
+  if (kind < 6) return fuzzWord();
+  if (kind < 9) {
+    // Batch; tags around the edges of 1-65534
+    static const long TAGS[] = {0, 1, 2, 42, 65534, 65535, 65536, 99999};
+    std::string line = "#" + std::to_string(TAGS[fuzzRand(8)]);
+    if (fuzzRand(4)) line += " ";
+    uint32_t n = fuzzRand(12);
+    for (uint32_t i = 0; i < n; i++) line += (i ? ";" : "") + fuzzWord();
+    return line;
+  }
+  // Garbage up to past CMD_SIZE: any byte but NUL and line ends
+  std::string line;
+  uint32_t n = 1 + fuzzRand(100);
+  for (uint32_t i = 0; i < n; i++) {
+    char ch = 1 + fuzzRand(255);
+    line += ch == '\n' || ch == '\r' ? ' ' : ch;
+  }
+  return line;
+}
+
+static void fuzzFixture() {
+  static const char *const CABLES[] = {"none", "ts", "xlr", "both"};
+  char d[64];
+  snprintf(d, sizeof(d), ".head %u", 1 + fuzzRand(HEAD_COUNT));
+  directive(d, "fuzz");
+  switch (fuzzRand(7)) {
+    case 0: snprintf(d, sizeof(d), ".cable %s", CABLES[fuzzRand(4)]); break;
+    case 1: snprintf(d, sizeof(d), ".open %s", CONTACT_NAMES[fuzzRand(C_SHELL)]); break;
+    case 2:
+      snprintf(d, sizeof(d), ".short %s %s %s", CONTACT_NAMES[fuzzRand(NUM_CONTACTS)],
+               CONTACT_NAMES[fuzzRand(NUM_CONTACTS)], fuzzRand(2) ? "near" : "far");
+      break;
+    case 3: snprintf(d, sizeof(d), ".bond %s off", fuzzRand(2) ? "near" : "far"); break;
+    case 4: snprintf(d, sizeof(d), ".res %s %u", CONTACT_NAMES[fuzzRand(C_SHELL)], fuzzRand(3000)); break;
+    case 5:
+      snprintf(d, sizeof(d), ".drop %s %u %u", CONTACT_NAMES[fuzzRand(C_SHELL)], fuzzRand(20000),
+               fuzzRand(5000));
+      break;
+    default: snprintf(d, sizeof(d), ".set supply -%u", fuzzRand(500)); break;
+  }
+  directive(d, "fuzz");
+}
+
+static unsigned long totalContention() {
+  unsigned long n = 0;
+  for (const Fixture &f : fixtures) n += f.contention;
+  return n;
+}
+
+static int fuzz(unsigned long steps, uint32_t seed) {
+  fuzzState = seed ? seed : 1;
+  std::vector<std::string> history;
+  // Per head
+  bool toggled[HEAD_COUNT] = {};     // A debug toggle drove a pin since the last test or RESET
+  bool autoOn[HEAD_COUNT] = {};
+  bool wasRunning[HEAD_COUNT] = {};
+  unsigned long commands = 0, replyCount = 0;
+
+  for (unsigned long step = 1; step <= steps; step++) {
+    std::string what;
+    uint32_t action = fuzzRand(20);
+    if (action < 14) {
+      what = fuzzLine();
+      commands++;
+      sendCommand(what.c_str());
+      // Leave it running, or let it finish
+      if (fuzzRand(3)) {
+        for (uint32_t n = fuzzRand(200); n > 0 && anyTestRunning(); n--) loopOnce();
+      } else {
+        runUntilIdle();
+      }
+    } else if (action < 17) {
+      replies.clear();
+      fuzzFixture();
+      what = "(fixture change)";
+    } else if (action < 19) {
+      uint32_t ms = fuzzRand(300);
+      what = "(wait " + std::to_string(ms) + " ms)";
+      replies.clear();
+      runFor(ms);
+    } else {
+      what = "(reboot)";
+      replies.clear();
+      boot();
+      memset(toggled, 0, sizeof(toggled));
+      for (uint8_t h = 0; h < HEAD_COUNT; h++) autoOn[h] = heads[h]->autoOn();   // Restored config
+    }
+    history.push_back(what);
+    if (history.size() > 16) history.erase(history.begin());
+
+    // A test that ended this step put the pins back; toggles in its replies came later
+    for (uint8_t h = 0; h < HEAD_COUNT; h++) {
+      if (wasRunning[h] && !heads[h]->isTestRunning()) toggled[h] = false;
+      wasRunning[h] = heads[h]->isTestRunning();
+    }
+
+    std::string problem;
+    for (const std::string &r : replies) {
+      replyCount++;
+      for (char ch : r) {
+        bool echoed = what.find(ch) != std::string::npos;
+        if ((ch < 0x20 || ch > 0x7E) && !echoed) problem = "unprintable reply: " + r;
+      }
+      // Heads 2.. carry an "H<n>:" prefix, batch replies a "#<tag>:" one
+      std::string body = r;
+      uint8_t h = 0;
+      if (body.size() > 2 && body[0] == 'H' && body[1] >= '2' && body[1] < '1' + HEAD_COUNT && body[2] == ':') {
+        h = body[1] - '1';
+        body.erase(0, 3);
+      }
+      if (body[0] == '#' && body.find(':') != std::string::npos) body.erase(0, body.find(':') + 1);
+      if (body.compare(0, 6, "DEBUG:") == 0) toggled[h] = true;
+      if (body.compare(0, 8, "OK:RESET") == 0) toggled[h] = false;
+      if (body.compare(0, 5, "AUTO:") == 0) autoOn[h] = body != "AUTO:OFF";
+    }
+
+    if (truncatedReplies) problem = "reply filled replyBuf";
+    if (simCounters.analogReadInBurst) problem = "analogRead() during an ADC burst";
+    if (failures) problem = "command never finished";
+    for (uint8_t h = 0; h < HEAD_COUNT; h++) {
+      if (heads[h]->isTestRunning() || toggled[h]) continue;
+      if (simHeadPin(h + 1, RES_TEST_OUT).drive) problem = "RES_TEST_OUT left on while idle";
+      for (uint8_t pin : OUTPUT_PINS) {
+        if (!autoOn[h] && !heads[h]->isFlexRunning() && simHeadPin(h + 1, pin).drive) {
+          problem = headPrefix(h + 1) + "output " + std::to_string(pin) + " left HIGH while idle";
+        }
+      }
+    }
+    if (!problem.empty()) {
+      printf("FUZZ:FAIL:STEP:%lu:SEED:%u: %s\n", step, seed, problem.c_str());
+      printf("Last steps:\n");
+      for (const std::string &h : history) printf("  %s\n", h.c_str());
+      return 1;
+    }
+  }
+  printf("FUZZ:OK:STEPS:%lu:COMMANDS:%lu:REPLIES:%lu:CONTENTION:%lu\n", steps, commands, replyCount,
+         totalContention());
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  unsigned long fuzzSteps = 0;
+  uint32_t seed = 1;
+  std::vector<const char *> files;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--times") == 0) showTimes = true;
+    else if (strcmp(argv[i], "--golden") == 0) golden = true;
+    else if (strcmp(argv[i], "--fuzz") == 0 && i + 1 < argc) fuzzSteps = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoul(argv[++i], NULL, 10);
+    else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+      fprintf(stderr, "usage: %s [--times] [--golden] [scenario.sim ...] | --fuzz <steps> [--seed <n>]\n",
+              argv[0]);
+      return 2;
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+
+  quiet = fuzzSteps != 0;
+  simLoadCosts();
+  fixtureDefaults();
+  boot();
+
+  if (fuzzSteps) return fuzz(fuzzSteps, seed);
+
+  if (files.empty()) {
+    runScenario(stdin, "stdin");
+  }
+  for (const char *path : files) {
+    FILE *f = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!f) {
+      fprintf(stderr, "%s: can't open\n", path);
+      return 2;
+    }
+    runScenario(f, path);
+    if (f != stdin) fclose(f);
+  }
+  if (totalContention()) printf("SIM:CONTENTION:%lu\n", totalContention());
+  return failures ? 1 : 0;
+}
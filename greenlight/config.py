@@ -41,7 +41,7 @@ REGISTRATION_BASE_URL = os.getenv("GREENLIGHT_REGISTRATION_URL", "https://sundia
 
 # Arduino configuration
 ARDUINO_PORT = os.getenv("GREENLIGHT_ARDUINO_PORT")  # e.g., "/dev/ttyUSB0"
-ARDUINO_BAUDRATE = int(os.getenv("GREENLIGHT_ARDUINO_BAUDRATE", "9600"))
+ARDUINO_BAUDRATE = int(os.getenv("GREENLIGHT_ARDUINO_BAUDRATE", "1000000"))  # negotiated up from 9600
 
 # Platform detection: UNO Q vs Pi + Mega 2560
 # UNO Q has the arduino-router service exposing a unix socket for Bridge RPC.
@@ -6,7 +6,23 @@ Supports two communication backends:
   - BridgeCableTester: Router Bridge msgpack-rpc (UNO Q)
 
 Both use the same text-based command/response protocol from the MCU.
-Commands: CONT, RES, CAL, XCONT, XSHELL, XRES, XCAL, STATUS, ID, RESET
+Commands: CONT, RES, CAL, XCONT, XSHELL, XRES, XCAL, FULL, XFULL, STATUS, ID, RESET, CANCEL
+
+With binary=True, test results come back as packed binary records instead
+(FORMAT BIN frames on serial, run_command_bin over the Bridge) and are
+decoded into the same dataclasses.
+
+start_batch()/collect_batch() pipeline several tests as one tagged batch
+("#17 CONT;RES"): the tester runs them while the caller gets on with other
+work, and the results are collected afterwards.
+
+set_auto(command) has the tester run `command` by itself whenever a cable
+is inserted; read_auto_result() returns the next such result.
+
+Any test command may carry a " FAST" suffix ("XFULL FAST"; set_fast() turns
+it on for every test): the tester stops at the first conclusive failure and
+lists the checks it never made in each result's `skipped`. A sub-test of
+FULL/XFULL that was skipped whole comes back as None.
 """
 
 import serial
@@ -14,9 +30,10 @@ import serial.tools.list_ports
 import logging
 import time
 import socket
+import struct
 import threading
-from typing import Dict, Any, Optional
-from dataclasses import dataclass
+from typing import Dict, Any, List, Optional, Tuple
+from dataclasses import dataclass, field
 from abc import ABC, abstractmethod
 
 logger = logging.getLogger(__name__)
@@ -33,6 +50,18 @@ class ContinuityResult:
     sleeve_to_sleeve: bool
     sleeve_to_tip: bool
     reason: Optional[str] = None  # REVERSED, CROSSED, NO_CABLE, TIP_OPEN, SLEEVE_OPEN
+    settle_us: Optional[List[int]] = None  # Measured settle per drive step (:SETTLE:)
+    skipped: Optional[List[str]] = None  # Checks FAST never made (:SKIP:)
+
+
+@dataclass
+class SampleStats:
+    """Spread of one resistance reading's ADC samples (RESSTAT ON)"""
+    samples: int        # More than one burst = borderline reading, resampled
+    sd_counts: float
+    min_adc: int
+    max_adc: int
+    outliers: int       # Samples past the board's outlier tolerance
 
 
 @dataclass
@@ -44,6 +73,10 @@ class ResistanceResult:
     calibration_adc: Optional[int] = None
     milliohms: Optional[int] = None
     ohms: Optional[float] = None
+    settle_us: Optional[List[int]] = None  # Measured settle per drive step (:SETTLE:)
+    skipped: Optional[List[str]] = None  # Checks FAST never made (:SKIP:)
+    stats: Optional[SampleStats] = None
+    bits: Optional[int] = None  # Effective resolution (OVERSAMPLE, :BITS:)
 
 
 @dataclass
@@ -60,6 +93,8 @@ class XlrContinuityResult:
     passed: bool
     matrix: Dict[str, bool]  # P11..P33 → bool
     reason: Optional[str] = None
+    settle_us: Optional[List[int]] = None  # Measured settle per drive step (:SETTLE:)
+    skipped: Optional[List[str]] = None  # Checks FAST never made (:SKIP:)
 
 
 @dataclass
@@ -70,6 +105,8 @@ class XlrShellResult:
     far_shell_bond: bool
     shell_to_shell: bool
     reason: Optional[str] = None
+    settle_us: Optional[List[int]] = None  # Measured settle per drive step (:SETTLE:)
+    skipped: Optional[List[str]] = None  # Checks FAST never made (:SKIP:)
 
 
 @dataclass
@@ -85,6 +122,12 @@ class XlrResistanceResult:
     pin2_ohms: Optional[float] = None
     pin3_milliohms: Optional[int] = None
     pin3_ohms: Optional[float] = None
+    settle_us: Optional[List[int]] = None  # Measured settle per drive step (:SETTLE:)
+    skipped: Optional[List[str]] = None  # Checks FAST never made (:SKIP:)
+    pin2_stats: Optional[SampleStats] = None
+    pin3_stats: Optional[SampleStats] = None
+    pin2_bits: Optional[int] = None  # Effective resolution (OVERSAMPLE, :P2BITS:)
+    pin3_bits: Optional[int] = None
 
 
 @dataclass
@@ -96,12 +139,105 @@ class XlrCalibrationResult:
     error: Optional[str] = None
 
 
+@dataclass
+class FullTestResult:
+    """Result from combined TS test (FULL = CONT + RES in one pass)"""
+    passed: bool
+    continuity: Optional[ContinuityResult]  # None = skipped whole by FAST
+    resistance: ResistanceResult
+
+
+@dataclass
+class XlrFullTestResult:
+    """Result from combined XLR test (XFULL = XCONT [+ XSHELL] + XRES in one pass)"""
+    passed: bool
+    continuity: XlrContinuityResult
+    resistance: Optional[XlrResistanceResult]  # None = skipped whole by FAST
+    shell: Optional[XlrShellResult] = None  # Only when run as XFULL SHELL
+
+
+@dataclass
+class BothTestResult:
+    """Result from TS + XLR continuity in one scan (BOTH), a cable in each jack"""
+    passed: bool
+    continuity: ContinuityResult
+    xlr_continuity: XlrContinuityResult
+
+
+@dataclass
+class FlexDropout:
+    """One FLEX dropout: a sense line went LOW and came back (EVENT:FLEX:DROP:)"""
+    line: str           # TIP, SLEEVE, P1, P2, P3 or SHELL
+    at_ms: int          # Since FLEX started
+    duration_us: int    # In steps of the board's FLEX_SAMPLE_US
+
+
+@dataclass
+class CalDrift:
+    """A resistance baseline moved past the warning since CAL/XCAL (EVENT:DRIFT:)"""
+    path: str           # TS, P2 or P3
+    milliohms: int      # Signed; negative = readings below the baseline
+
+
+@dataclass
+class FlexStatus:
+    """FLEX mode and its totals (FLEX, or the final ones from FLEX OFF)"""
+    mode: str                          # "OFF", "TS" or "XLR"
+    elapsed_ms: Optional[int] = None   # None = no session reported
+    drops: Dict[str, int] = field(default_factory=dict)   # Dropouts per watched line
+    longest_us: int = 0
+    lost: int = 0                      # Changes the Mega's queue had no room for
+    open_lines: List[str] = field(default_factory=list)   # Watched lines LOW now
+
+
+@dataclass
+class WearStats:
+    """A test head's wear counters (STATS); kept across power cycles"""
+    saved: bool                        # False = counts not stored yet
+    resets: int = 0                    # STATS RESETs (fixture parts replaced)
+    relays: Dict[str, int] = field(default_factory=dict)   # Pull-ins: K12, K3, K4, K5, K6
+    inserts: int = 0                   # Cables AUTO saw go in
+    tests: Dict[str, Tuple[int, int]] = field(default_factory=dict)   # Command -> (passes, fails)
+
+
 # ===== Shared response parsers =====
 # Both ArduinoCableTester (serial) and BridgeCableTester (rpc) get the same
 # colon-delimited response strings from the MCU. These functions parse them.
 
+
+def parse_settle(parts: List[str]) -> Optional[List[int]]:
+    """Parse the optional :SETTLE:<us>,<us>... field (one value per drive step)"""
+    if "SETTLE" not in parts:
+        return None
+    return [int(v) for v in parts[parts.index("SETTLE") + 1].split(",")]
+
+
+def parse_skipped(parts: List[str]) -> Optional[List[str]]:
+    """Parse the optional :SKIP:<check>,<check>... field (FAST mode)"""
+    if "SKIP" not in parts[2:]:
+        return None
+    return parts[parts.index("SKIP", 2) + 1].split(",")
+
+
+def parse_sample_stats(parts: List[str], pin: str = "") -> Optional[SampleStats]:
+    """Parse the optional :<pin>N:..:<pin>SD:..:<pin>MIN:..:<pin>MAX:..:<pin>OUT: fields"""
+    if f"{pin}N" not in parts:
+        return None
+    field = lambda key: parts[parts.index(f"{pin}{key}") + 1]
+    return SampleStats(samples=int(field("N")), sd_counts=float(field("SD")),
+                       min_adc=int(field("MIN")), max_adc=int(field("MAX")),
+                       outliers=int(field("OUT")))
+
+
+def parse_bits(parts: List[str], pin: str = "") -> Optional[int]:
+    """Parse the optional :<pin>BITS: field (OVERSAMPLE)"""
+    if f"{pin}BITS" not in parts:
+        return None
+    return int(parts[parts.index(f"{pin}BITS") + 1])
+
+
 def parse_continuity_response(response: str) -> ContinuityResult:
-    """Parse: RESULT:PASS/FAIL:TT:x:TS:x:SS:x:ST:x[:REASON:xxx]"""
+    """Parse: RESULT:PASS/FAIL:TT:x:TS:x:SS:x:ST:x[:REASON:xxx][:SKIP:xxx]"""
     parts = response.split(":")
 
     passed = parts[1] == "PASS"
@@ -116,12 +252,13 @@ def parse_continuity_response(response: str) -> ContinuityResult:
 
     return ContinuityResult(
         passed=passed, tip_to_tip=tt, tip_to_sleeve=ts,
-        sleeve_to_sleeve=ss, sleeve_to_tip=st, reason=reason
+        sleeve_to_sleeve=ss, sleeve_to_tip=st, reason=reason,
+        settle_us=parse_settle(parts), skipped=parse_skipped(parts)
     )
 
 
 def parse_resistance_response(response: str) -> ResistanceResult:
-    """Parse: RES:PASS/FAIL:ADC:xxx[:CAL:xxx:MOHM:xxx:OHM:xxx]"""
+    """Parse: RES:PASS/FAIL:ADC:xxx[:CAL:xxx:MOHM:xxx:OHM:xxx][:BITS:x][:N:..:OUT:x]"""
     parts = response.split(":")
 
     passed = parts[1] == "PASS"
@@ -143,7 +280,9 @@ def parse_resistance_response(response: str) -> ResistanceResult:
 
     return ResistanceResult(
         passed=passed, adc_value=adc_value, calibrated=calibrated,
-        calibration_adc=cal_adc, milliohms=milliohms, ohms=ohms
+        calibration_adc=cal_adc, milliohms=milliohms, ohms=ohms,
+        settle_us=parse_settle(parts), stats=parse_sample_stats(parts),
+        bits=parse_bits(parts)
     )
 
 
@@ -158,7 +297,7 @@ def parse_calibration_response(response: str) -> CalibrationResult:
 
 
 def parse_xlr_continuity_response(response: str) -> XlrContinuityResult:
-    """Parse: XCONT:PASS/FAIL:P11:x:P12:x:...:P33:x[:REASON:xxx]"""
+    """Parse: XCONT:PASS/FAIL/SKIP:P11:x:P12:x:...:P33:x[:REASON:xxx][:SKIP:xxx]"""
     parts = response.split(":")
     passed = parts[1] == "PASS"
 
@@ -172,11 +311,12 @@ def parse_xlr_continuity_response(response: str) -> XlrContinuityResult:
     if "REASON" in parts:
         reason = parts[parts.index("REASON") + 1]
 
-    return XlrContinuityResult(passed=passed, matrix=matrix, reason=reason)
+    return XlrContinuityResult(passed=passed, matrix=matrix, reason=reason,
+                               settle_us=parse_settle(parts), skipped=parse_skipped(parts))
 
 
 def parse_xlr_shell_response(response: str) -> XlrShellResult:
-    """Parse: XSHELL:PASS/FAIL:NEAR:x:FAR:x:SS:x[:REASON:xxx]"""
+    """Parse: XSHELL:PASS/FAIL/SKIP:NEAR:x:FAR:x:SS:x[:REASON:xxx][:SKIP:xxx]"""
     parts = response.split(":")
     passed = parts[1] == "PASS"
 
@@ -190,12 +330,13 @@ def parse_xlr_shell_response(response: str) -> XlrShellResult:
 
     return XlrShellResult(
         passed=passed, near_shell_bond=near, far_shell_bond=far,
-        shell_to_shell=ss, reason=reason
+        shell_to_shell=ss, reason=reason, settle_us=parse_settle(parts),
+        skipped=parse_skipped(parts)
     )
 
 
 def parse_xlr_resistance_response(response: str) -> XlrResistanceResult:
-    """Parse: XRES:PASS/FAIL:P2ADC:x:P3ADC:x[:P2CAL:x:P3CAL:x:P2MOHM:x:P2OHM:x:P3MOHM:x:P3OHM:x]"""
+    """Parse: XRES:PASS/FAIL:P2ADC:x:P3ADC:x[:P2CAL:x:P3CAL:x:P2MOHM:x:P2OHM:x:P3MOHM:x:P3OHM:x][:P2N:..]"""
     parts = response.split(":")
     passed = parts[1] == "PASS"
 
@@ -221,7 +362,10 @@ def parse_xlr_resistance_response(response: str) -> XlrResistanceResult:
         passed=passed, pin2_adc=pin2_adc, pin3_adc=pin3_adc,
         calibrated=calibrated, pin2_cal_adc=pin2_cal, pin3_cal_adc=pin3_cal,
         pin2_milliohms=pin2_mohm, pin2_ohms=pin2_ohm,
-        pin3_milliohms=pin3_mohm, pin3_ohms=pin3_ohm
+        pin3_milliohms=pin3_mohm, pin3_ohms=pin3_ohm,
+        settle_us=parse_settle(parts), skipped=parse_skipped(parts),
+        pin2_stats=parse_sample_stats(parts, "P2"), pin3_stats=parse_sample_stats(parts, "P3"),
+        pin2_bits=parse_bits(parts, "P2"), pin3_bits=parse_bits(parts, "P3")
     )
 
 
@@ -242,6 +386,418 @@ def parse_xlr_calibration_response(response: str) -> XlrCalibrationResult:
     return XlrCalibrationResult(success=True, pin2_adc=pin2_adc, pin3_adc=pin3_adc)
 
 
+def parse_full_response(response: str) -> FullTestResult:
+    """Parse: FULL:PASS/FAIL|RESULT:...|RES:... (RESULT:SKIP = continuity None)"""
+    sections = response.split("|")
+    passed = sections[0] == "FULL:PASS"
+
+    continuity = resistance = None
+    seen = set()
+    for section in sections[1:]:
+        if section.startswith("RESULT:"):
+            seen.add("RESULT")
+            if section != "RESULT:SKIP":
+                continuity = parse_continuity_response(section)
+        elif section.startswith("RES:"):
+            resistance = parse_resistance_response(section)
+
+    if "RESULT" not in seen or resistance is None:
+        raise ValueError(f"Incomplete FULL response: {response}")
+
+    return FullTestResult(passed=passed, continuity=continuity, resistance=resistance)
+
+
+def parse_xlr_full_response(response: str) -> XlrFullTestResult:
+    """Parse: XFULL:PASS/FAIL|XCONT:...[|XSHELL:...]|XRES:... (XRES:SKIP = resistance None)"""
+    sections = response.split("|")
+    passed = sections[0] == "XFULL:PASS"
+
+    continuity = shell = resistance = None
+    seen = set()
+    for section in sections[1:]:
+        if section.startswith("XCONT:"):
+            continuity = parse_xlr_continuity_response(section)
+        elif section.startswith("XSHELL:"):
+            shell = parse_xlr_shell_response(section)
+        elif section.startswith("XRES:"):
+            seen.add("XRES")
+            if section != "XRES:SKIP":
+                resistance = parse_xlr_resistance_response(section)
+
+    if continuity is None or "XRES" not in seen:
+        raise ValueError(f"Incomplete XFULL response: {response}")
+
+    return XlrFullTestResult(passed=passed, continuity=continuity,
+                             resistance=resistance, shell=shell)
+
+
+def parse_both_response(response: str) -> BothTestResult:
+    """Parse: BOTH:PASS/FAIL|RESULT:...|XCONT:..."""
+    sections = response.split("|")
+    passed = sections[0] == "BOTH:PASS"
+
+    continuity = xlr_continuity = None
+    for section in sections[1:]:
+        if section.startswith("RESULT:"):
+            continuity = parse_continuity_response(section)
+        elif section.startswith("XCONT:"):
+            xlr_continuity = parse_xlr_continuity_response(section)
+
+    if continuity is None or xlr_continuity is None:
+        raise ValueError(f"Incomplete BOTH response: {response}")
+
+    return BothTestResult(passed=passed, continuity=continuity, xlr_continuity=xlr_continuity)
+
+
+# ===== Tagged batches =====
+# "#<tag> <cmd>;<cmd>..." runs the commands in order; each response line
+# comes back as "#<tag>:<response>", then "#<tag>:END". In binary mode a
+# "#<tag>:BIN" line precedes each result frame.
+
+# Test commands a batch (or AUTO mode) may run: response prefix, text parser
+BATCH_TESTS = {
+    "CONT": ("RESULT:", parse_continuity_response),
+    "RES": ("RES:", parse_resistance_response),
+    "XCONT": ("XCONT:", parse_xlr_continuity_response),
+    "XSHELL": ("XSHELL:", parse_xlr_shell_response),
+    "XRES": ("XRES:", parse_xlr_resistance_response),
+    "FULL": ("FULL:", parse_full_response),
+    "XFULL": ("XFULL:", parse_xlr_full_response),
+    "XFULL SHELL": ("XFULL:", parse_xlr_full_response),
+    "BOTH": ("BOTH:", parse_both_response),
+}
+
+
+def test_command(command: str) -> str:
+    """The BATCH_TESTS key of a test command: 'XFULL FAST' -> 'XFULL'"""
+    return command[:-len(" FAST")] if command.endswith(" FAST") else command
+
+
+def batch_line(tag: int, commands: List[str]) -> str:
+    for command in commands:
+        if test_command(command) not in BATCH_TESTS:
+            raise ValueError(f"Not a batch test command: {command}")
+    return f"#{tag} {';'.join(commands)}"
+
+
+def split_tag(line: str) -> Optional[tuple]:
+    """'#17:RES:...' -> (17, 'RES:...'), None for untagged lines"""
+    head, sep, payload = line.partition(":")
+    if not line.startswith("#") or not sep or not head[1:].isdigit():
+        return None
+    return int(head[1:]), payload
+
+
+def parse_batch_results(commands: List[str], messages: List[Any]) -> List[Any]:
+    """Parse a batch's tagged payloads (str, or bytes records) in command order"""
+    results = []
+    for message in messages:
+        if isinstance(message, bytes):
+            results.append(parse_binary_result(message))
+            continue
+        if message.startswith("ERROR:"):
+            raise RuntimeError(f"Tester error: {message}")
+        if len(results) < len(commands):
+            prefix, parser = BATCH_TESTS[test_command(commands[len(results)])]
+            if message.startswith(prefix):
+                results.append(parser(message))
+                continue
+        logger.debug(f"Skipping batch line: {message}")
+    if len(results) != len(commands):
+        raise RuntimeError(f"Batch answered {len(results)} of {len(commands)} tests")
+    return results
+
+
+def parse_mem_response(response: str) -> Dict[str, int]:
+    """MEM:FREE:<n>:MIN:<n>:REPLY:<n> -> {'free': n, 'min': n, 'reply': n}"""
+    parts = response.split(":")
+    return {key.lower(): int(value) for key, value in zip(parts[1::2], parts[2::2])}
+
+
+FLEX_LINES = ("TIP", "SLEEVE", "P1", "P2", "P3", "SHELL")
+
+
+def parse_flex_response(response: str) -> FlexStatus:
+    """Parse: FLEX:OFF|TS|XLR[:MS:x:<line>:n...:LONGEST:us:LOST:n[:OPEN:<line>,...]]"""
+    parts = response.split(":")
+    if len(parts) < 2 or parts[0] != "FLEX":
+        raise ValueError(f"Not a FLEX response: {response}")
+    fields = dict(zip(parts[2::2], parts[3::2]))
+    return FlexStatus(
+        mode=parts[1], elapsed_ms=int(fields["MS"]) if "MS" in fields else None,
+        drops={line: int(fields[line]) for line in FLEX_LINES if line in fields},
+        longest_us=int(fields.get("LONGEST", 0)), lost=int(fields.get("LOST", 0)),
+        open_lines=fields["OPEN"].split(",") if "OPEN" in fields else []
+    )
+
+
+STATS_RELAYS = ("K12", "K3", "K4", "K5", "K6")
+
+
+def parse_stats_response(response: str) -> WearStats:
+    """Parse: STATS:SAVED:<0|1>:RESETS:n:K12:n:K3:n:K4:n:K5:n:K6:n:INS:n[:<test>:<pass>:<fail>...]"""
+    parts = response.split(":")
+    if len(parts) < 17 or parts[0] != "STATS":
+        raise ValueError(f"Not a STATS response: {response}")
+    fields = dict(zip(parts[1:17:2], parts[2:17:2]))
+    return WearStats(
+        saved=fields["SAVED"] == "1", resets=int(fields["RESETS"]),
+        relays={relay: int(fields[relay]) for relay in STATS_RELAYS},
+        inserts=int(fields["INS"]),
+        tests={parts[i]: (int(parts[i + 1]), int(parts[i + 2])) for i in range(17, len(parts) - 2, 3)}
+    )
+
+
+def parse_flex_event(payload: str) -> FlexDropout:
+    """Parse: FLEX:DROP:<line>:AT:<ms>:US:<us>"""
+    parts = payload.split(":")
+    return FlexDropout(line=parts[2], at_ms=int(parts[4]), duration_us=int(parts[6]))
+
+
+def parse_drift_event(payload: str) -> CalDrift:
+    """Parse: DRIFT:<path>:<mohm>"""
+    parts = payload.split(":")
+    return CalDrift(path=parts[1], milliohms=int(parts[2]))
+
+
+def parse_auto_event(command: Optional[str], payload: Any) -> Any:
+    """Parse an EVENT: payload (a test result, FlexDropout or CalDrift);
+    None for INSERTED/REMOVED, raises on ERROR:"""
+    if isinstance(payload, bytes):
+        return parse_binary_result(payload)
+    if payload in ("INSERTED", "REMOVED"):
+        logger.info(f"Cable {payload.lower()}")
+        return None
+    if payload.startswith("ERROR:"):
+        raise RuntimeError(f"Tester error: {payload}")
+    if payload.startswith("FLEX:DROP:"):
+        return parse_flex_event(payload)
+    if payload.startswith("DRIFT:"):
+        logger.warning(f"Calibration drift: {payload}; run CAL/XCAL again")
+        return parse_drift_event(payload)
+    if command is None:
+        logger.debug(f"Skipping event: {payload}")
+        return None
+    prefix, parser = BATCH_TESTS[test_command(command)]
+    return parser(payload) if payload.startswith(prefix) else None
+
+
+# ===== Binary result records =====
+# Packed record sent instead of the text response in binary mode (see the
+# BINARY RESULTS section of the sketches). Little-endian:
+#   magic, kind, flags, bits u32, adc u16 x2, cal u16 x2, milliohms u32 x2,
+#   settle count, settle us u16 x count
+# Bits 20-29 of `bits` are the CK_* checks a FAST stop skipped.
+# On serial it is framed as STX, length, record, CRC-8.
+
+BIN_MAGIC = 0xB1
+BIN_STX = 0x02
+BIN_HEADER = struct.Struct("<BBBIHHHHIIB")
+
+# TestKind order in the sketches
+BIN_KINDS = ["CONT", "XCONT", "XSHELL", "RES", "XRES", "CAL", "XCAL",
+             "FULL", "XFULL", "XFULL SHELL", "BOTH"]
+
+RF_PASS = 0x01
+RF_CONT_PASS = 0x02
+RF_SHELL_PASS = 0x04
+RF_RES_PASS = 0x08
+RF_CALIBRATED = 0x10
+
+# Sense matrix bits (BIT_* in the sketches)
+BIT_TT, BIT_TS, BIT_SS, BIT_ST = 0, 1, 2, 3
+BIT_FAR, BIT_NEAR, BIT_SH_P2, BIT_SH_P3, BIT_SH_SH = 13, 14, 15, 16, 17
+BIT_SKIP = 20
+
+# FAST checks (CK_* in the sketches), named as in :SKIP:
+CK_NAMES = ["TIP", "SLEEVE", "RES", "P1", "P2", "P3", "FAR", "NEAR", "P2", "P3"]
+CK_CONT_ALL, CK_XCONT_ALL, CK_XSHELL_ALL, CK_XRES_ALL = 0x003, 0x038, 0x0C0, 0x300
+CK_P1, CK_FAR, CK_NEAR = 0x008, 0x040, 0x080
+
+
+def crc8(data: bytes) -> int:
+    """CRC-8, polynomial 0x07 (serial frame check)"""
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def _bit(bits: int, n: int) -> bool:
+    return bool((bits >> n) & 1)
+
+
+def _skipped(bits: int, checks: int) -> Optional[List[str]]:
+    """Names of the `checks` a FAST stop skipped, None if it skipped none"""
+    skipped = (bits >> BIT_SKIP) & checks
+    return [CK_NAMES[i] for i in range(len(CK_NAMES)) if skipped >> i & 1] or None
+
+
+def _continuity_from_bits(bits: int, settle: List[int]) -> ContinuityResult:
+    tt, ts = _bit(bits, BIT_TT), _bit(bits, BIT_TS)
+    ss, st = _bit(bits, BIT_SS), _bit(bits, BIT_ST)
+    passed = tt and not ts and ss and not st
+    reason = None
+    if not passed:
+        open_tip, open_sleeve = not tt and not ts, not ss and not st
+        if not tt and ts and not ss and st:
+            reason = "REVERSED"
+        elif ts or st:
+            reason = "SHORT"
+        elif open_tip and open_sleeve:
+            reason = "NO_CABLE"
+        elif open_tip:
+            reason = "TIP_OPEN"
+        elif open_sleeve:
+            reason = "SLEEVE_OPEN"
+        else:
+            reason = "UNKNOWN"
+    return ContinuityResult(
+        passed=passed, tip_to_tip=tt, tip_to_sleeve=ts,
+        sleeve_to_sleeve=ss, sleeve_to_tip=st, reason=reason, settle_us=settle,
+        skipped=_skipped(bits, CK_CONT_ALL)
+    )
+
+
+def _xlr_continuity_from_bits(bits: int, settle: List[int]) -> XlrContinuityResult:
+    p = [[_bit(bits, 4 + d * 3 + s) for s in range(3)] for d in range(3)]
+    matrix = {f"P{d + 1}{s + 1}": p[d][s] for d in range(3) for s in range(3)}
+    passed = all(p[d][s] == (d == s) for d in range(3) for s in range(3))
+    skipped = bits >> BIT_SKIP
+    reason = None
+    if not passed:
+        # Rows FAST never drove are not opens; with no fault among the
+        # driven rows the result is undecided (XCONT:SKIP), so no reason
+        issues = [f"P{i + 1}_OPEN" for i in range(3)
+                  if not p[i][i] and not skipped & (CK_P1 << i)]
+        issues += [f"P{d + 1}_P{s + 1}_SHORT" for d in range(3) for s in range(3)
+                   if d != s and p[d][s]]
+        if not any(matrix.values()):
+            reason = "NO_CABLE"
+        elif issues or not skipped & CK_XCONT_ALL:
+            reason = ",".join(issues) or "UNKNOWN"
+    return XlrContinuityResult(passed=passed, matrix=matrix, reason=reason, settle_us=settle,
+                               skipped=_skipped(bits, CK_XCONT_ALL))
+
+
+def _xlr_shell_from_bits(bits: int, settle: List[int]) -> XlrShellResult:
+    near, far = _bit(bits, BIT_NEAR), _bit(bits, BIT_FAR)
+    sh_p2, sh_p3 = _bit(bits, BIT_SH_P2), _bit(bits, BIT_SH_P3)
+    passed = near and far and not sh_p2 and not sh_p3
+    skipped = bits >> BIT_SKIP
+    reason = None
+    if not passed:
+        issues = []
+        if not near and not skipped & CK_NEAR:
+            issues.append("NEAR_SHELL_OPEN")
+        if not far and not skipped & CK_FAR:
+            issues.append("FAR_SHELL_OPEN")
+        if sh_p2:
+            issues.append("SHELL_P2_SHORT")
+        if sh_p3:
+            issues.append("SHELL_P3_SHORT")
+        if issues or not skipped & CK_XSHELL_ALL:
+            reason = ",".join(issues) or "UNKNOWN"
+    return XlrShellResult(
+        passed=passed, near_shell_bond=near, far_shell_bond=far,
+        shell_to_shell=_bit(bits, BIT_SH_SH), reason=reason, settle_us=settle,
+        skipped=_skipped(bits, CK_XSHELL_ALL)
+    )
+
+
+def _resistance_from_record(flags, adc, cal, mohm, settle) -> ResistanceResult:
+    calibrated = bool(flags & RF_CALIBRATED)
+    return ResistanceResult(
+        passed=bool(flags & RF_RES_PASS), adc_value=adc[0], calibrated=calibrated,
+        calibration_adc=cal[0] if calibrated else None,
+        milliohms=mohm[0] if calibrated else None,
+        ohms=mohm[0] / 1000.0 if calibrated else None,
+        settle_us=settle
+    )
+
+
+def _xlr_resistance_from_record(flags, adc, cal, mohm, settle,
+                                skipped=None) -> XlrResistanceResult:
+    calibrated = bool(flags & RF_CALIBRATED)
+    return XlrResistanceResult(
+        passed=bool(flags & RF_RES_PASS), pin2_adc=adc[0], pin3_adc=adc[1],
+        calibrated=calibrated,
+        pin2_cal_adc=cal[0] if calibrated else None,
+        pin3_cal_adc=cal[1] if calibrated else None,
+        pin2_milliohms=mohm[0] if calibrated else None,
+        pin2_ohms=mohm[0] / 1000.0 if calibrated else None,
+        pin3_milliohms=mohm[1] if calibrated else None,
+        pin3_ohms=mohm[1] / 1000.0 if calibrated else None,
+        settle_us=settle, skipped=skipped
+    )
+
+
+def parse_binary_result(record: bytes) -> Any:
+    """Decode a binary result record into the dataclass the text parser for
+    the same test returns (ohms are milliohms / 1000)"""
+    if len(record) < BIN_HEADER.size or record[0] != BIN_MAGIC:
+        raise ValueError(f"Not a binary result record: {record!r}")
+    (_, kind, flags, bits, adc0, adc1, cal0, cal1,
+     mohm0, mohm1, count) = BIN_HEADER.unpack_from(record)
+    settle = list(struct.unpack_from(f"<{count}H", record, BIN_HEADER.size))
+    adc, cal, mohm = (adc0, adc1), (cal0, cal1), (mohm0, mohm1)
+    name = BIN_KINDS[kind] if kind < len(BIN_KINDS) else None
+    passed = bool(flags & RF_PASS)
+
+    if name == "CONT":
+        return _continuity_from_bits(bits, settle)
+    if name == "XCONT":
+        return _xlr_continuity_from_bits(bits, settle)
+    if name == "XSHELL":
+        return _xlr_shell_from_bits(bits, settle)
+    if name == "RES":
+        return _resistance_from_record(flags, adc, cal, mohm, settle)
+    if name == "XRES":
+        return _xlr_resistance_from_record(flags, adc, cal, mohm, settle,
+                                           _skipped(bits, CK_XRES_ALL))
+    if name == "CAL":
+        if passed:
+            return CalibrationResult(success=True, adc_value=adc[0])
+        return CalibrationResult(success=False, error=f"CAL:FAIL:ADC:{adc[0]}:NO_CABLE")
+    if name == "XCAL":
+        if passed:
+            return XlrCalibrationResult(success=True, pin2_adc=adc[0], pin3_adc=adc[1])
+        return XlrCalibrationResult(success=False, pin2_adc=adc[0], pin3_adc=adc[1],
+                                    error="No cable detected")
+    if name == "FULL":
+        # Settle slots: resistance first (rest state), then continuity
+        cont_skipped = (bits >> BIT_SKIP) & CK_CONT_ALL == CK_CONT_ALL
+        return FullTestResult(
+            passed=passed,
+            continuity=None if cont_skipped else _continuity_from_bits(bits, settle[1:3]),
+            resistance=_resistance_from_record(flags, adc, cal, mohm, settle[0:1]))
+    if name in ("XFULL", "XFULL SHELL"):
+        shell = None
+        res_slot = 3
+        if name == "XFULL SHELL":
+            # One combined scan: drives pin 1, 2, 3, shell; the shell result uses 1 and shell
+            shell = _xlr_shell_from_bits(bits, [settle[i] for i in (0, 3) if i < len(settle)])
+            res_slot = 4
+        resistance = None
+        if (bits >> BIT_SKIP) & CK_XRES_ALL != CK_XRES_ALL:
+            resistance = _xlr_resistance_from_record(flags, adc, cal, mohm,
+                                                     settle[res_slot:res_slot + 2],
+                                                     _skipped(bits, CK_XRES_ALL))
+        return XlrFullTestResult(
+            passed=passed,
+            continuity=_xlr_continuity_from_bits(bits, settle[0:3]),
+            resistance=resistance, shell=shell)
+    if name == "BOTH":
+        # Settle slots: tip + pin 1, sleeve + pin 2, pin 3
+        return BothTestResult(
+            passed=passed,
+            continuity=_continuity_from_bits(bits, settle[0:2]),
+            xlr_continuity=_xlr_continuity_from_bits(bits, settle[0:3]))
+    raise ValueError(f"Unknown test kind {kind} in binary result")
+
+
 # ===== Abstract interface =====
 
 class CableTesterInterface(ABC):
@@ -279,15 +835,28 @@ class CableTesterInterface(ABC):
 # ===== Serial implementation (Pi + Mega 2560) =====
 
 class ArduinoCableTester(CableTesterInterface):
-    """Arduino Mega 2560 cable tester via USB serial"""
+    """Arduino Mega 2560 cable tester via USB serial
+
+    The tester boots at BOOT_BAUDRATE; a higher `baudrate` is negotiated with
+    BAUD after the ID handshake (falls back to the boot rate if refused).
+    """
+
+    BOOT_BAUDRATE = 9600
 
-    def __init__(self, port: Optional[str] = None, baudrate: int = 9600, timeout: float = 5.0):
+    def __init__(self, port: Optional[str] = None, baudrate: int = 9600, timeout: float = 5.0,
+                 binary: bool = False):
         self.port = port
-        self.baudrate = baudrate
+        self.baudrate = baudrate  # Rate in use once initialized
         self.timeout = timeout
         self.serial: Optional[serial.Serial] = None
         self.connected = False
         self.tester_id: Optional[str] = None
+        self.binary = binary  # Request FORMAT BIN; cleared if the firmware lacks it
+        self._batch_tag = 0
+        self._batches: Dict[int, List[str]] = {}       # Tag -> commands, until collected
+        self._batch_messages: Dict[int, List[Any]] = {}  # Tagged payloads read so far
+        self.auto_command: Optional[str] = None            # Test AUTO mode runs, None = off
+        self._auto_messages: List[Any] = []                # EVENT: payloads not yet read
 
     def _find_arduino_port(self) -> Optional[str]:
         """Auto-detect Arduino serial port"""
@@ -312,7 +881,7 @@ class ArduinoCableTester(CableTesterInterface):
 
             self.serial = serial.Serial(
                 port=self.port,
-                baudrate=self.baudrate,
+                baudrate=self.BOOT_BAUDRATE,
                 timeout=self.timeout
             )
 
@@ -325,7 +894,13 @@ class ArduinoCableTester(CableTesterInterface):
             if response and response.startswith("ID:"):
                 self.tester_id = response.split(":")[1]
                 self.connected = True
-                logger.info(f"Arduino cable tester initialized: {self.tester_id} on {self.port}")
+                if self.baudrate != self.BOOT_BAUDRATE and not self._negotiate_baud(self.baudrate):
+                    self.baudrate = self.BOOT_BAUDRATE
+                if self.binary:
+                    self._send_command("FORMAT BIN")
+                    self.binary = self._read_until_response("FORMAT:") == "FORMAT:BIN"
+                logger.info(f"Arduino cable tester initialized: {self.tester_id} on {self.port}"
+                            f" at {self.baudrate} baud{' (binary results)' if self.binary else ''}")
                 return True
             else:
                 logger.error(f"Unexpected response from cable tester: {response}")
@@ -337,6 +912,30 @@ class ArduinoCableTester(CableTesterInterface):
             self.connected = False
             return False
 
+    def _negotiate_baud(self, rate: int) -> bool:
+        """Switch tester and port to `rate`; the tester keeps it once ID answers there"""
+        self._send_command(f"BAUD {rate}")
+        response = self._read_until_response("OK:BAUD:", timeout=2.0)
+        if response != f"OK:BAUD:{rate}":
+            logger.info(f"Tester didn't switch to {rate} baud ({response}), "
+                        f"staying at {self.BOOT_BAUDRATE}")
+            return False
+
+        self.serial.baudrate = rate
+        self.serial.reset_input_buffer()
+        for _ in range(2):
+            self._send_command("ID")
+            confirm = self._read_until_response("ID:", timeout=0.5)
+            if confirm and confirm.startswith("ID:"):
+                return True
+
+        # Unconfirmed, the tester drops back to its boot rate by itself
+        logger.warning(f"No answer at {rate} baud, reverting to {self.BOOT_BAUDRATE}")
+        self.serial.baudrate = self.BOOT_BAUDRATE
+        time.sleep(2.5)
+        self.serial.reset_input_buffer()
+        return False
+
     def _send_command(self, command: str) -> None:
         if not self.serial or not self.serial.is_open:
             raise RuntimeError("Serial connection not open")
@@ -353,6 +952,9 @@ class ArduinoCableTester(CableTesterInterface):
         try:
             line = self.serial.readline().decode('utf-8').strip()
             logger.debug(f"Received: {line}")
+            if line.startswith("#") or line.startswith("EVENT:"):
+                self._stash_unprompted(line, self.serial.timeout)
+                return None
             return line if line else None
         except serial.SerialException as e:
             logger.error(f"Serial read error: {e}")
@@ -375,6 +977,134 @@ class ArduinoCableTester(CableTesterInterface):
                     logger.debug(f"Skipping: {response}")
         return None
 
+    def _read_message(self, timeout: float = 0.5) -> Any:
+        """Read one text line (str) or one binary result frame (bytes)"""
+        if not self.serial:
+            return None
+        old_timeout = self.serial.timeout
+        self.serial.timeout = timeout
+        try:
+            first = self.serial.read(1)
+            if not first:
+                return None
+            if first[0] != BIN_STX:
+                line = (first + self.serial.readline()).decode('utf-8').strip()
+                logger.debug(f"Received: {line}")
+                if line.startswith("#") or line.startswith("EVENT:"):
+                    self._stash_unprompted(line, timeout)
+                    return None
+                return line if line else None
+            length = self.serial.read(1)
+            record = self.serial.read(length[0]) if length else b""
+            check = self.serial.read(1)
+            if not length or len(record) != length[0] or not check or check[0] != crc8(record):
+                logger.error("Corrupt binary result frame")
+                return None
+            logger.debug(f"Received record: {record.hex()}")
+            return record
+        except serial.SerialException as e:
+            logger.error(f"Serial read error: {e}")
+            return None
+        finally:
+            self.serial.timeout = old_timeout
+
+    def _stash_unprompted(self, line: str, timeout: float) -> None:
+        """Keep a batch line for collect_batch() or an AUTO event for
+        read_auto_result(); a <prefix>BIN line is replaced by the frame it announces"""
+        if line.startswith("EVENT:"):
+            key, payload = None, line[len("EVENT:"):]
+        else:
+            tagged = split_tag(line)
+            if tagged is None:
+                logger.debug(f"Skipping: {line}")
+                return
+            key, payload = tagged
+        if payload == "BIN":
+            payload = self._read_message(timeout=max(timeout, 0.5))
+            if not isinstance(payload, bytes):
+                logger.error(f"Expected a result frame after {line}, got {payload}")
+                return
+        if key is None:
+            self._auto_messages.append(payload)
+        else:
+            self._batch_messages.setdefault(key, []).append(payload)
+
+    def set_auto(self, command: Optional[str]) -> bool:
+        """Run `command` on every cable insertion (None = stop); True once the tester agrees"""
+        if not self.connected:
+            raise RuntimeError("Cable tester not connected")
+        if command is not None and test_command(command) not in BATCH_TESTS:
+            raise ValueError(f"Not an auto test command: {command}")
+        self._send_command(f"AUTO {command or 'OFF'}")
+        response = self._read_until_response("AUTO:", timeout=5.0)
+        self.auto_command = command if response == f"AUTO:{command or 'OFF'}" else None
+        return response == f"AUTO:{command or 'OFF'}"
+
+    def read_auto_result(self, timeout: float = 0.5) -> Any:
+        """Next unprompted AUTO result or FlexDropout (parsed), or None if none arrives within timeout"""
+        start_time = time.time()
+        while True:
+            while self._auto_messages:
+                result = parse_auto_event(self.auto_command, self._auto_messages.pop(0))
+                if result is not None:
+                    return result
+            if time.time() - start_time >= timeout:
+                return None
+            message = self._read_message(timeout=min(0.5, timeout))
+            if message:
+                logger.debug(f"Skipping: {message}")
+
+    def start_batch(self, commands: List[str]) -> int:
+        """Send test commands as one tagged batch; returns the tag without waiting"""
+        if not self.connected:
+            raise RuntimeError("Cable tester not connected")
+        self._batch_tag = self._batch_tag % 65535 + 1
+        tag = self._batch_tag
+        self._send_command(batch_line(tag, commands))
+        self._batches[tag] = list(commands)
+        self._batch_messages[tag] = []
+        return tag
+
+    def collect_batch(self, tag: int, timeout: float = 30.0) -> List[Any]:
+        """Wait for a batch to finish; returns its parsed results in command order"""
+        commands = self._batches.pop(tag)
+        start_time = time.time()
+        try:
+            while time.time() - start_time < timeout:
+                messages = self._batch_messages.get(tag, [])
+                if messages and messages[-1] == "END":
+                    return parse_batch_results(commands, messages[:-1])
+                message = self._read_message()
+                if message and message.startswith("ERROR:") and f"#{tag} " in message:
+                    # Rejected whole (ERROR:BAD_BATCH, or firmware without batches)
+                    raise RuntimeError(f"Tester error: {message}")
+                if message:
+                    logger.debug(f"Skipping: {message}")
+            raise RuntimeError(f"No END from batch #{tag}")
+        finally:
+            self._batch_messages.pop(tag, None)
+
+    def _command_binary(self, command: str, timeout: float = 10.0) -> bytes:
+        """Send a test command, wait for its binary result, raise on error/timeout"""
+        if not self.connected:
+            raise RuntimeError("Cable tester not connected")
+        self._send_command(command)
+        start_time = time.time()
+        while time.time() - start_time < timeout:
+            message = self._read_message()
+            if isinstance(message, bytes):
+                return message
+            if message and message.startswith("ERROR:"):
+                raise RuntimeError(f"Tester error: {message}")
+            if message:
+                logger.debug(f"Skipping: {message}")
+        raise RuntimeError(f"No response from {command}")
+
+    def _run_test(self, command: str, prefix: str, parser, timeout: float = 10.0) -> Any:
+        if self.binary:
+            return parse_binary_result(self._command_binary(command, timeout))
+        return parser(self._command_and_parse(command, prefix, timeout))
+
     def _command_and_parse(self, command: str, prefix: str, timeout: float = 10.0) -> str:
         """Send command, wait for response with prefix, raise on error/timeout"""
         if not self.connected:
@@ -388,16 +1118,19 @@ class ArduinoCableTester(CableTesterInterface):
         return response
 
     def run_continuity_test(self) -> ContinuityResult:
-        return parse_continuity_response(
-            self._command_and_parse("CONT", "RESULT:"))
+        return self._run_test("CONT", "RESULT:", parse_continuity_response)
 
     def run_resistance_test(self) -> ResistanceResult:
-        return parse_resistance_response(
-            self._command_and_parse("RES", "RES:"))
+        return self._run_test("RES", "RES:", parse_resistance_response)
 
     def calibrate(self) -> CalibrationResult:
         if not self.connected:
             raise RuntimeError("Cable tester not connected")
+        if self.binary:
+            try:
+                return parse_binary_result(self._command_binary("CAL", timeout=15.0))
+            except RuntimeError as e:
+                return CalibrationResult(success=False, error=str(e))
         self._send_command("CAL")
         response = self._read_until_response("CAL:OK", timeout=15.0)
         if not response:
@@ -407,20 +1140,32 @@ class ArduinoCableTester(CableTesterInterface):
         return parse_calibration_response(response)
 
     def run_xlr_continuity_test(self) -> XlrContinuityResult:
-        return parse_xlr_continuity_response(
-            self._command_and_parse("XCONT", "XCONT:"))
+        return self._run_test("XCONT", "XCONT:", parse_xlr_continuity_response)
 
     def run_xlr_shell_test(self) -> XlrShellResult:
-        return parse_xlr_shell_response(
-            self._command_and_parse("XSHELL", "XSHELL:"))
+        return self._run_test("XSHELL", "XSHELL:", parse_xlr_shell_response)
 
     def run_xlr_resistance_test(self) -> XlrResistanceResult:
-        return parse_xlr_resistance_response(
-            self._command_and_parse("XRES", "XRES:"))
+        return self._run_test("XRES", "XRES:", parse_xlr_resistance_response)
+
+    def run_full_test(self) -> FullTestResult:
+        return self._run_test("FULL", "FULL:", parse_full_response)
+
+    def run_xlr_full_test(self, shell: bool = False) -> XlrFullTestResult:
+        command = "XFULL SHELL" if shell else "XFULL"
+        return self._run_test(command, "XFULL:", parse_xlr_full_response)
+
+    def run_both_test(self) -> BothTestResult:
+        return self._run_test("BOTH", "BOTH:", parse_both_response)
 
     def xlr_calibrate(self) -> XlrCalibrationResult:
         if not self.connected:
             raise RuntimeError("Cable tester not connected")
+        if self.binary:
+            try:
+                return parse_binary_result(self._command_binary("XCAL", timeout=15.0))
+            except RuntimeError as e:
+                return XlrCalibrationResult(success=False, error=str(e))
         self._send_command("XCAL")
         start_time = time.time()
         response = None
@@ -445,6 +1190,77 @@ class ArduinoCableTester(CableTesterInterface):
         response = self._read_until_response("OK:", timeout=5.0)
         return response == "OK:RESET"
 
+    def cancel(self) -> bool:
+        """Abort the running test and drop any queued ones"""
+        if not self.connected:
+            return False
+        self._send_command("CANCEL")
+        # The aborted test answers ERROR:CANCELLED:<cmd> before OK:CANCEL
+        start_time = time.time()
+        while time.time() - start_time < 5.0:
+            line = self._read_response(timeout=0.5)
+            if line == "OK:CANCEL":
+                return True
+            if line:
+                logger.debug(f"Skipping: {line}")
+        return False
+
+    def get_memory(self) -> Dict[str, int]:
+        """MCU free memory: 'free' now, 'min' since boot, 'reply' longest response"""
+        return parse_mem_response(self._command_and_parse("MEM", "MEM:"))
+
+    def get_profile(self, command: Optional[str] = None) -> str:
+        """Raw PROFILE [command] response (per-phase test timings)"""
+        expect = f"PROFILE:{command}" if command else "PROFILE"
+        return self._command_and_parse(f"PROFILE {command}" if command else "PROFILE", expect)
+
+    def reset_profile(self) -> bool:
+        return self._command_and_parse("PROFILE RESET", "PROFILE:") == "PROFILE:RESET"
+
+    def set_fast(self, on: bool) -> bool:
+        """Fail-fast for every test (FAST ON/OFF); True once the tester agrees"""
+        state = 'ON' if on else 'OFF'
+        return self._command_and_parse(f"FAST {state}", "FAST:") == f"FAST:{state}"
+
+    def set_burst(self, on: bool) -> bool:
+        """Short resistance captures (BURST ON/OFF); True once the tester agrees"""
+        state = 'ON' if on else 'OFF'
+        return self._command_and_parse(f"BURST {state}", "BURST:") == f"BURST:{state}"
+
+    def set_res_stats(self, on: bool) -> bool:
+        """Sample statistics in RES/XRES results (RESSTAT ON/OFF); True once the tester agrees"""
+        state = 'ON' if on else 'OFF'
+        return self._command_and_parse(f"RESSTAT {state}", "RESSTAT:") == f"RESSTAT:{state}"
+
+    def set_oversample(self, bits: int) -> bool:
+        """Extra bits per resistance reading (OVERSAMPLE 1..4, 0 = OFF); True once the tester agrees"""
+        state = str(bits) if bits else 'OFF'
+        return self._command_and_parse(f"OVERSAMPLE {state}", "OVERSAMPLE:") == f"OVERSAMPLE:{state}"
+
+    def set_boot_fast(self, on: bool) -> bool:
+        """Skip the power-on LED check (BOOT FAST/FULL); kept across power cycles"""
+        state = 'FAST' if on else 'FULL'
+        return self._command_and_parse(f"BOOT {state}", "BOOT:") == f"BOOT:{state}"
+
+    def get_stats(self, action: Optional[str] = None) -> WearStats:
+        """Wear counters; action "SAVE" stores them now, "RESET" zeroes them"""
+        command = f"STATS {action}" if action else "STATS"
+        return parse_stats_response(self._command_and_parse(command, "STATS:"))
+
+    def start_flex(self, connector: str) -> FlexStatus:
+        """Hold the "TS" or "XLR" drives on for a flex test; dropouts arrive
+        through read_auto_result() until stop_flex()"""
+        if connector not in ("TS", "XLR"):
+            raise ValueError(f"Not a FLEX connector: {connector}")
+        return parse_flex_response(self._command_and_parse(f"FLEX {connector}", "FLEX:"))
+
+    def flex_status(self) -> FlexStatus:
+        return parse_flex_response(self._command_and_parse("FLEX", "FLEX:"))
+
+    def stop_flex(self) -> FlexStatus:
+        """End the flex test; its final totals"""
+        return parse_flex_response(self._command_and_parse("FLEX OFF", "FLEX:"))
+
     def get_status(self) -> Dict[str, Any]:
         status = {
             'connected': self.connected,
@@ -459,6 +1275,12 @@ class ArduinoCableTester(CableTesterInterface):
                 if response:
                     parts = response.split(":")
                     status['ready'] = parts[1] == "READY"
+                    status['busy'] = "BUSY" in parts[2:]
+                    if "FAULT" in parts[2:-1]:
+                        status['fault'] = parts[parts.index("FAULT") + 1]
+                    if "DRIFT" in parts[2:-2]:
+                        i = parts.index("DRIFT")
+                        status['drift'] = {'path': parts[i + 1], 'mohm': int(parts[i + 2])}
                     status['status_response'] = response
             except Exception as e:
                 status['error'] = str(e)
@@ -487,18 +1309,24 @@ ROUTER_SOCKET_PATH = "/var/run/arduino-router.sock"
 class BridgeCableTester(CableTesterInterface):
     """UNO Q cable tester via Router Bridge (msgpack-rpc over unix socket)
 
-    The MCU sketch exposes a single run_command(cmd) function via the Router Bridge.
+    The MCU sketch exposes run_command(cmd) via the Router Bridge.
     It accepts the same command strings (CONT, RES, CAL, etc.) and returns the same
-    colon-delimited response strings as the serial version.
+    colon-delimited response strings as the serial version. With binary=True,
+    run_command_bin(cmd) is used instead: test results arrive as msgpack bin
+    records, everything else as text bytes.
     """
 
-    def __init__(self, socket_path: str = ROUTER_SOCKET_PATH):
+    def __init__(self, socket_path: str = ROUTER_SOCKET_PATH, binary: bool = False):
         self.socket_path = socket_path
+        self.binary = binary  # Use run_command_bin; cleared if the sketch lacks it
         self.connected = False
         self.tester_id: Optional[str] = None
         self._sock: Optional[socket.socket] = None
         self._lock = threading.Lock()
         self._next_msgid = 0
+        self._batch_tag = 0
+        self._batches: Dict[int, tuple] = {}  # Tag -> (commands, thread, result holder)
+        self.auto_command: Optional[str] = None  # Test AUTO mode runs, None = off
 
     def _connect(self) -> bool:
         """Connect to the arduino-router unix socket"""
@@ -557,6 +1385,86 @@ class BridgeCableTester(CableTesterInterface):
         logger.debug(f"Bridge command '{command}' -> '{result}'")
         return result
 
+    def start_batch(self, commands: List[str]) -> int:
+        """Run test commands as one tagged batch in the background; returns the tag
+
+        The Bridge can't push results, so the sketch answers the whole batch
+        at once (always as text); the RPC runs in a thread meanwhile.
+        """
+        if not self.connected:
+            raise RuntimeError("Cable tester not connected")
+        self._batch_tag = self._batch_tag % 65535 + 1
+        tag = self._batch_tag
+        line = batch_line(tag, commands)
+        holder: Dict[str, Any] = {}
+
+        def run():
+            try:
+                holder['response'] = self._run_command(line, timeout=60.0)
+            except Exception as e:
+                holder['error'] = e
+
+        thread = threading.Thread(target=run, name=f"batch-{tag}", daemon=True)
+        thread.start()
+        self._batches[tag] = (list(commands), thread, holder)
+        return tag
+
+    def collect_batch(self, tag: int, timeout: float = 30.0) -> List[Any]:
+        """Wait for a batch to finish; returns its parsed results in command order"""
+        commands, thread, holder = self._batches.pop(tag)
+        thread.join(timeout)
+        if thread.is_alive():
+            raise RuntimeError(f"No END from batch #{tag}")
+        if 'error' in holder:
+            raise RuntimeError(f"Batch #{tag} failed: {holder['error']}")
+
+        messages = []
+        for line in holder['response'].split("\n"):
+            tagged = split_tag(line)
+            if tagged is None:
+                raise RuntimeError(f"Tester error: {line}")
+            if tagged[0] == tag and tagged[1] != "END":
+                messages.append(tagged[1])
+        return parse_batch_results(commands, messages)
+
+    def set_auto(self, command: Optional[str]) -> bool:
+        """Run `command` on every cable insertion (None = stop); True once the tester agrees"""
+        if not self.connected:
+            raise RuntimeError("Cable tester not connected")
+        if command is not None and test_command(command) not in BATCH_TESTS:
+            raise ValueError(f"Not an auto test command: {command}")
+        response = self._run_command(f"AUTO {command or 'OFF'}")
+        self.auto_command = command if response == f"AUTO:{command or 'OFF'}" else None
+        return response == f"AUTO:{command or 'OFF'}"
+
+    def read_auto_result(self, timeout: float = 0.5) -> Any:
+        """Next AUTO result (parsed), or None; the sketch holds it until asked"""
+        start_time = time.time()
+        while True:
+            response = self._run_command("AUTO RESULT")
+            if response.startswith("EVENT:"):
+                result = parse_auto_event(self.auto_command, response[len("EVENT:"):])
+                if result is not None:
+                    return result
+            if time.time() - start_time >= timeout:
+                return None
+            time.sleep(0.1)
+
+    def _run_test(self, command: str, parser, timeout: float = 15.0) -> Any:
+        """Run a test command; raise on ERROR:, return the parsed result"""
+        if not self.connected:
+            raise RuntimeError("Cable tester not connected")
+        if self.binary:
+            result = self._rpc_call("run_command_bin", command, timeout=timeout)
+            if result and result[0] == BIN_MAGIC:
+                return parse_binary_result(result)
+            response = bytes(result).decode('utf-8')
+        else:
+            response = self._run_command(command, timeout=timeout)
+        if response.startswith("ERROR:"):
+            raise RuntimeError(f"Tester error: {response}")
+        return parser(response)
+
     def initialize(self) -> bool:
         """Initialize Bridge connection and verify MCU is responding"""
         try:
@@ -567,7 +1475,14 @@ class BridgeCableTester(CableTesterInterface):
             if response and response.startswith("ID:"):
                 self.tester_id = response.split(":")[1]
                 self.connected = True
-                logger.info(f"Bridge cable tester initialized: {self.tester_id}")
+                if self.binary:
+                    try:
+                        self._rpc_call("run_command_bin", "ID")
+                    except RuntimeError as e:
+                        logger.warning(f"Binary results unavailable, using text: {e}")
+                        self.binary = False
+                logger.info(f"Bridge cable tester initialized: {self.tester_id}"
+                            f"{' (binary results)' if self.binary else ''}")
                 return True
             else:
                 logger.error(f"Unexpected response from Bridge cable tester: {response}")
@@ -580,60 +1495,44 @@ class BridgeCableTester(CableTesterInterface):
             return False
 
     def run_continuity_test(self) -> ContinuityResult:
-        if not self.connected:
-            raise RuntimeError("Cable tester not connected")
-        response = self._run_command("CONT")
-        if response.startswith("ERROR:"):
-            raise RuntimeError(f"Tester error: {response}")
-        return parse_continuity_response(response)
+        return self._run_test("CONT", parse_continuity_response)
 
     def run_resistance_test(self) -> ResistanceResult:
-        if not self.connected:
-            raise RuntimeError("Cable tester not connected")
-        response = self._run_command("RES")
-        if response.startswith("ERROR:"):
-            raise RuntimeError(f"Tester error: {response}")
-        return parse_resistance_response(response)
+        return self._run_test("RES", parse_resistance_response)
 
     def calibrate(self) -> CalibrationResult:
         if not self.connected:
             raise RuntimeError("Cable tester not connected")
-        response = self._run_command("CAL", timeout=20.0)
-        if response.startswith("ERROR:"):
-            return CalibrationResult(success=False, error=response)
-        return parse_calibration_response(response)
+        try:
+            return self._run_test("CAL", parse_calibration_response, timeout=20.0)
+        except RuntimeError as e:
+            return CalibrationResult(success=False, error=str(e))
 
     def run_xlr_continuity_test(self) -> XlrContinuityResult:
-        if not self.connected:
-            raise RuntimeError("Cable tester not connected")
-        response = self._run_command("XCONT")
-        if response.startswith("ERROR:"):
-            raise RuntimeError(f"Tester error: {response}")
-        return parse_xlr_continuity_response(response)
+        return self._run_test("XCONT", parse_xlr_continuity_response)
 
     def run_xlr_shell_test(self) -> XlrShellResult:
-        if not self.connected:
-            raise RuntimeError("Cable tester not connected")
-        response = self._run_command("XSHELL")
-        if response.startswith("ERROR:"):
-            raise RuntimeError(f"Tester error: {response}")
-        return parse_xlr_shell_response(response)
+        return self._run_test("XSHELL", parse_xlr_shell_response)
 
     def run_xlr_resistance_test(self) -> XlrResistanceResult:
-        if not self.connected:
-            raise RuntimeError("Cable tester not connected")
-        response = self._run_command("XRES")
-        if response.startswith("ERROR:"):
-            raise RuntimeError(f"Tester error: {response}")
-        return parse_xlr_resistance_response(response)
+        return self._run_test("XRES", parse_xlr_resistance_response)
+
+    def run_full_test(self) -> FullTestResult:
+        return self._run_test("FULL", parse_full_response)
+
+    def run_xlr_full_test(self, shell: bool = False) -> XlrFullTestResult:
+        return self._run_test("XFULL SHELL" if shell else "XFULL", parse_xlr_full_response)
+
+    def run_both_test(self) -> BothTestResult:
+        return self._run_test("BOTH", parse_both_response)
 
     def xlr_calibrate(self) -> XlrCalibrationResult:
         if not self.connected:
             raise RuntimeError("Cable tester not connected")
-        response = self._run_command("XCAL", timeout=20.0)
-        if response.startswith("ERROR:"):
-            return XlrCalibrationResult(success=False, error=response)
-        return parse_xlr_calibration_response(response)
+        try:
+            return self._run_test("XCAL", parse_xlr_calibration_response, timeout=20.0)
+        except RuntimeError as e:
+            return XlrCalibrationResult(success=False, error=str(e))
 
     def reset(self) -> bool:
         if not self.connected:
@@ -641,6 +1540,74 @@ class BridgeCableTester(CableTesterInterface):
         response = self._run_command("RESET")
         return response == "OK:RESET"
 
+    def cancel(self) -> bool:
+        if not self.connected:
+            return False
+        response = self._run_command("CANCEL")
+        return response == "OK:CANCEL"
+
+    def _query(self, command: str) -> str:
+        if not self.connected:
+            raise RuntimeError("Cable tester not connected")
+        response = self._run_command(command)
+        if response.startswith("ERROR:"):
+            raise RuntimeError(f"Tester error: {response}")
+        return response
+
+    def get_memory(self) -> Dict[str, int]:
+        """Sketch thread stack: 'free' now, 'min' since boot, 'reply' longest response"""
+        return parse_mem_response(self._query("MEM"))
+
+    def get_profile(self, command: Optional[str] = None) -> str:
+        """Raw PROFILE [command] response (per-phase test timings)"""
+        return self._query(f"PROFILE {command}" if command else "PROFILE")
+
+    def reset_profile(self) -> bool:
+        return self._query("PROFILE RESET") == "PROFILE:RESET"
+
+    def set_fast(self, on: bool) -> bool:
+        """Fail-fast for every test (FAST ON/OFF); True once the tester agrees"""
+        state = 'ON' if on else 'OFF'
+        return self._query(f"FAST {state}") == f"FAST:{state}"
+
+    def set_burst(self, on: bool) -> bool:
+        """Short resistance captures (BURST ON/OFF); True once the tester agrees"""
+        state = 'ON' if on else 'OFF'
+        return self._query(f"BURST {state}") == f"BURST:{state}"
+
+    def set_res_stats(self, on: bool) -> bool:
+        """Sample statistics in RES/XRES results (RESSTAT ON/OFF); True once the tester agrees"""
+        state = 'ON' if on else 'OFF'
+        return self._query(f"RESSTAT {state}") == f"RESSTAT:{state}"
+
+    def set_oversample(self, bits: int) -> bool:
+        """Extra bits per resistance reading (OVERSAMPLE 1..4, 0 = OFF); True once the tester agrees"""
+        state = str(bits) if bits else 'OFF'
+        return self._query(f"OVERSAMPLE {state}") == f"OVERSAMPLE:{state}"
+
+    def set_boot_fast(self, on: bool) -> bool:
+        """Skip the power-on icon cycle (BOOT FAST/FULL); kept across power cycles"""
+        state = 'FAST' if on else 'FULL'
+        return self._query(f"BOOT {state}") == f"BOOT:{state}"
+
+    def get_stats(self, action: Optional[str] = None) -> WearStats:
+        """Wear counters; action "SAVE" stores them now, "RESET" zeroes them"""
+        return parse_stats_response(self._query(f"STATS {action}" if action else "STATS"))
+
+    def start_flex(self, connector: str) -> FlexStatus:
+        """Hold the "TS" or "XLR" drives on for a flex test; read_auto_result()
+        returns the latest dropout, flex_status() the totals"""
+        if connector not in ("TS", "XLR"):
+            raise ValueError(f"Not a FLEX connector: {connector}")
+        return parse_flex_response(self._query(f"FLEX {connector}"))
+
+    def flex_status(self) -> FlexStatus:
+        return parse_flex_response(self._query("FLEX"))
+
+    def stop_flex(self) -> FlexStatus:
+        """End the flex test; its final totals"""
+        return parse_flex_response(self._query("FLEX OFF"))
+
     def get_status(self) -> Dict[str, Any]:
         status = {
             'connected': self.connected,
@@ -654,6 +1621,12 @@ class BridgeCableTester(CableTesterInterface):
                 if response:
                     parts = response.split(":")
                     status['ready'] = parts[1] == "READY"
+                    status['busy'] = "BUSY" in parts[2:]
+                    if "FAULT" in parts[2:-1]:
+                        status['fault'] = parts[parts.index("FAULT") + 1]
+                    if "DRIFT" in parts[2:-2]:
+                        i = parts.index("DRIFT")
+                        status['drift'] = {'path': parts[i + 1], 'mohm': int(parts[i + 2])}
                     status['status_response'] = response
             except Exception as e:
                 status['error'] = str(e)
@@ -687,6 +1660,10 @@ class MockCableTester(CableTesterInterface):
         self.calibration_adc = 60
         self.xlr_calibration_p2 = 58
         self.xlr_calibration_p3 = 62
+        self._batch_tag = 0
+        self._batches: Dict[int, List[str]] = {}
+        self.auto_command: Optional[str] = None
+        self._flex: Optional[str] = None    # FLEX connector, None = off
         logger.info("Mock cable tester initialized")
 
     def initialize(self) -> bool:
@@ -744,6 +1721,31 @@ class MockCableTester(CableTesterInterface):
             pin3_ohms=0.060 if self.xlr_calibrated else None
         )
 
+    def run_full_test(self) -> FullTestResult:
+        logger.info("Mock cable tester: Simulating full TS test - PASS")
+        return FullTestResult(
+            passed=True,
+            continuity=self.run_continuity_test(),
+            resistance=self.run_resistance_test()
+        )
+
+    def run_xlr_full_test(self, shell: bool = False) -> XlrFullTestResult:
+        logger.info("Mock cable tester: Simulating full XLR test - PASS")
+        return XlrFullTestResult(
+            passed=True,
+            continuity=self.run_xlr_continuity_test(),
+            resistance=self.run_xlr_resistance_test(),
+            shell=self.run_xlr_shell_test() if shell else None
+        )
+
+    def run_both_test(self) -> BothTestResult:
+        logger.info("Mock cable tester: Simulating TS + XLR continuity test - PASS")
+        return BothTestResult(
+            passed=True,
+            continuity=self.run_continuity_test(),
+            xlr_continuity=self.run_xlr_continuity_test()
+        )
+
     def xlr_calibrate(self) -> XlrCalibrationResult:
         logger.info("Mock cable tester: Simulating XLR calibration")
         self.xlr_calibrated = True
@@ -753,6 +1755,78 @@ class MockCableTester(CableTesterInterface):
             pin3_adc=self.xlr_calibration_p3
         )
 
+    def start_batch(self, commands: List[str]) -> int:
+        batch_line(0, commands)  # Validate
+        self._batch_tag += 1
+        self._batches[self._batch_tag] = list(commands)
+        return self._batch_tag
+
+    def collect_batch(self, tag: int, timeout: float = 30.0) -> List[Any]:
+        tests = {
+            "CONT": self.run_continuity_test,
+            "RES": self.run_resistance_test,
+            "XCONT": self.run_xlr_continuity_test,
+            "XSHELL": self.run_xlr_shell_test,
+            "XRES": self.run_xlr_resistance_test,
+            "FULL": self.run_full_test,
+            "XFULL": self.run_xlr_full_test,
+            "XFULL SHELL": lambda: self.run_xlr_full_test(shell=True),
+            "BOTH": self.run_both_test,
+        }
+        return [tests[test_command(command)]() for command in self._batches.pop(tag)]
+
+    def set_auto(self, command: Optional[str]) -> bool:
+        self.auto_command = command
+        return True
+
+    def read_auto_result(self, timeout: float = 0.5) -> Any:
+        return None  # No cable is ever inserted
+
+    def get_memory(self) -> Dict[str, int]:
+        return {'free': 8192, 'min': 8192, 'reply': 0}
+
+    def get_profile(self, command: Optional[str] = None) -> str:
+        return f"PROFILE:{command}:N:0" if command else "PROFILE"
+
+    def reset_profile(self) -> bool:
+        return True
+
+    def set_fast(self, on: bool) -> bool:
+        return True  # The mock never fails a check, so there is nothing to stop
+
+    def set_burst(self, on: bool) -> bool:
+        return True
+
+    def set_res_stats(self, on: bool) -> bool:
+        return True
+
+    def set_oversample(self, bits: int) -> bool:
+        return 0 <= bits <= 4
+
+    def set_boot_fast(self, on: bool) -> bool:
+        return True
+
+    def get_stats(self, action: Optional[str] = None) -> WearStats:
+        return WearStats(saved=True, relays={relay: 0 for relay in STATS_RELAYS})
+
+    def start_flex(self, connector: str) -> FlexStatus:
+        if connector not in ("TS", "XLR"):
+            raise ValueError(f"Not a FLEX connector: {connector}")
+        self._flex = connector
+        return self.flex_status()
+
+    def flex_status(self) -> FlexStatus:
+        if self._flex is None:
+            return FlexStatus(mode="OFF")
+        lines = ("TIP", "SLEEVE") if self._flex == "TS" else ("P1", "P2", "P3", "SHELL")
+        return FlexStatus(mode=self._flex, elapsed_ms=0, drops={line: 0 for line in lines})
+
+    def stop_flex(self) -> FlexStatus:
+        status = self.flex_status()
+        status.mode = "OFF"
+        self._flex = None
+        return status
+
     def get_status(self) -> Dict[str, Any]:
         return {
             'connected': self.connected,
@@ -3,6 +3,10 @@ MQTT-based barcode scanner client.
 
 Subscribes to MQTT topic where the scanner daemon publishes barcodes.
 Provides the same interface as BarcodeScanner for drop-in replacement.
+
+On an UNO Q the cable-tester app also publishes the tester's events
+(inserted/removed, AUTO results, drift, ...) to tester/event; the latest
+TESTER_EVENT_BACKLOG are queued for get_tester_event().
 """
 
 import json
@@ -29,6 +33,8 @@ MQTT_BROKER = "localhost"
 MQTT_PORT = 1883
 MQTT_TOPIC = "scanner/barcode"
 MQTT_STATUS_TOPIC = "scanner/status"
+MQTT_TESTER_TOPIC = "tester/event"  # ArduinoApps/cable-tester/python/main.py
+TESTER_EVENT_BACKLOG = 64  # Unread tester events kept; older ones are dropped
 
 
 class MQTTScanner:
@@ -43,6 +49,7 @@ class MQTTScanner:
         self.port = port
         self.mqtt_client = None
         self.scan_queue = queue.Queue()
+        self.tester_events = queue.Queue(maxsize=TESTER_EVENT_BACKLOG)
         self.connected = False
         self.running = False
         self._paused = False
@@ -108,8 +115,8 @@ class MQTTScanner:
             logger.info(f"Connected to MQTT broker at {self.broker}:{self.port}")
             self.connected = True
             # Subscribe to scanner topic
-            client.subscribe(MQTT_TOPIC, qos=1)
-            logger.info(f"Subscribed to topic: {MQTT_TOPIC}")
+            client.subscribe([(MQTT_TOPIC, 1), (MQTT_TESTER_TOPIC, 1)])
+            logger.info(f"Subscribed to topics: {MQTT_TOPIC}, {MQTT_TESTER_TOPIC}")
             # Re-assert scanner status on reconnect
             if self._status_payload:
                 self.mqtt_client.publish(MQTT_STATUS_TOPIC, self._status_payload, qos=1, retain=True)
@@ -125,6 +132,9 @@ class MQTTScanner:
 
     def _on_message(self, client, userdata, msg):
         """Callback when a message is received"""
+        if msg.topic == MQTT_TESTER_TOPIC:
+            self._on_tester_event(msg)
+            return
         if self._paused:
             return
         try:
@@ -141,6 +151,34 @@ class MQTTScanner:
         except Exception as e:
             logger.error(f"Error processing message: {e}")
 
+    def _on_tester_event(self, msg):
+        """Queue a tester event's text (the sketch's EVENT payload), dropping
+        the oldest once TESTER_EVENT_BACKLOG are unread"""
+        try:
+            event = json.loads(msg.payload.decode('utf-8')).get('event')
+        except (ValueError, AttributeError) as e:
+            logger.error(f"Bad tester event: {e}")
+            return
+        if event:
+            logger.debug(f"Tester event: {event}")
+            while True:
+                try:
+                    self.tester_events.put_nowait(event)
+                    return
+                except queue.Full:
+                    try:
+                        self.tester_events.get_nowait()
+                    except queue.Empty:
+                        pass
+
+    def get_tester_event(self, timeout: float = 0.1) -> Optional[str]:
+        """Next tester event, e.g. 'INSERTED' or 'DRIFT:P2:-148'; None on timeout.
+        Parse it with cable_tester.parse_auto_event()."""
+        try:
+            return self.tester_events.get(timeout=timeout)
+        except queue.Empty:
+            return None
+
     def is_connected(self) -> bool:
         """Check if connected to MQTT broker"""
         return self.connected
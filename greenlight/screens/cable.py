@@ -292,9 +292,9 @@ class CableScreenBase(Screen):
             if not cal_result:
                 return
 
-        # Now run the actual tests
+        # Now run the actual tests (continuity + resistance in one round trip)
         self.ui.layout["body"].update(cable_info_panel)
-        self.ui.layout["footer"].update(Panel("🔬 Testing... Running continuity test", title="Testing"))
+        self.ui.layout["footer"].update(Panel("🔬 Testing... Running continuity + resistance test", title="Testing"))
         self.ui.render()
 
         all_passed = True
@@ -304,11 +304,20 @@ class CableScreenBase(Screen):
         calibration_adc = None
         failure_reasons = []
 
-        # Run continuity test
-        cont_reason = None
+        full_result = None
         try:
-            cont_result = cable_tester.run_continuity_test()
-            if cont_result.passed:
+            full_result = cable_tester.run_full_test()
+        except Exception as e:
+            logger.error(f"Full TS test failed: {e}")
+
+        # Continuity result
+        cont_reason = None
+        if full_result is not None:
+            cont_result = full_result.continuity
+            if cont_result is None:
+                # FAST mode: RES runs first and its failure skips continuity
+                cont_status = "[dim]SKIP[/dim]"
+            elif cont_result.passed:
                 cont_status = "[green]PASS[/green]"
             else:
                 cont_reason = cont_result.reason
@@ -322,30 +331,24 @@ class CableScreenBase(Screen):
                 cont_status = f"[red]FAIL ({reason_display})[/red]"
                 failure_reasons.append(f"CON: {reason_display}")
                 all_passed = False
-        except Exception as e:
+        else:
             cont_status = "[yellow]ERROR[/yellow]"
             failure_reasons.append(f"CON: Error")
             all_passed = False
 
-        # Only run resistance test if continuity passed
+        # Resistance only counts if continuity passed (an open cable reads as high resistance)
         if all_passed:
-            self.ui.layout["footer"].update(Panel(f"🔬 Testing... CON: {cont_status} | Running resistance test", title="Testing"))
-            self.ui.render()
-
-            try:
-                res_result = cable_tester.run_resistance_test()
-                resistance_adc = res_result.adc_value
-                calibration_adc = res_result.calibration_adc
-                if res_result.passed:
-                    res_status = "[green]PASS[/green]"
-                else:
-                    res_status = "[red]FAIL[/red]"
-                    failure_reasons.append("RES: Fail")
-                    all_passed = False
-            except Exception as e:
-                res_status = "[yellow]ERROR[/yellow]"
-                failure_reasons.append("RES: Error")
+            res_result = full_result.resistance
+            resistance_adc = res_result.adc_value
+            calibration_adc = res_result.calibration_adc
+            if res_result.passed:
+                res_status = "[green]PASS[/green]"
+            else:
+                res_status = "[red]FAIL[/red]"
+                failure_reasons.append("RES: Fail")
                 all_passed = False
+        elif full_result is None:
+            res_status = "[yellow]ERROR[/yellow]"
         else:
             res_status = "[dim]SKIP[/dim]"
 
@@ -447,9 +450,9 @@ class CableScreenBase(Screen):
             if not cal_result:
                 return
 
-        # Run XLR continuity test
+        # Run XLR continuity [+ shell] + resistance in one round trip
         self.ui.layout["body"].update(cable_info_panel)
-        self.ui.layout["footer"].update(Panel("🔬 Testing... Running XLR continuity test", title="Testing"))
+        self.ui.layout["footer"].update(Panel("🔬 Testing... Running XLR test sequence", title="Testing"))
         self.ui.render()
 
         all_passed = True
@@ -462,10 +465,19 @@ class CableScreenBase(Screen):
         calibration_adc_p3 = None
         failure_reasons = []
 
+        full_result = None
         try:
-            cont_result = cable_tester.run_xlr_continuity_test()
+            full_result = cable_tester.run_xlr_full_test(shell=should_test_shell)
+        except Exception as e:
+            logger.error(f"Full XLR test failed: {e}")
+
+        if full_result is not None:
+            cont_result = full_result.continuity
             if cont_result.passed:
                 cont_status = "[green]PASS[/green]"
+            elif cont_result.reason is None and cont_result.skipped:
+                # FAST mode stopped at a shell fault before these pins were driven
+                cont_status = "[dim]SKIP[/dim]"
             else:
                 cont_reason = cont_result.reason or 'Unknown'
                 # Parse XLR reasons: P1_OPEN, P2_P3_SHORT, NO_CABLE, etc.
@@ -485,71 +497,59 @@ class CableScreenBase(Screen):
                 cont_status = f"[red]FAIL ({', '.join(friendly)})[/red]"
                 failure_reasons.append(f"CON: {', '.join(friendly)}")
                 all_passed = False
-        except Exception as e:
+        else:
             cont_status = "[yellow]ERROR[/yellow]"
             failure_reasons.append("CON: Error")
             all_passed = False
 
-        # Run shell bond test (only when the connectors have a conductive shell,
-        # and skip if continuity already failed)
+        # Shell bond result (only when the connectors have a conductive shell,
+        # and ignored if continuity already failed)
         if should_test_shell and all_passed:
-            progress = f"🔬 Testing... CON: {cont_status} | Running shell bond test"
-            self.ui.layout["footer"].update(Panel(progress, title="Testing"))
-            self.ui.render()
-
-            try:
-                shell_result = cable_tester.run_xlr_shell_test()
-                if shell_result.passed:
-                    shell_status = "[green]PASS[/green]"
-                else:
-                    shell_reason = shell_result.reason or 'Unknown'
-                    reason_parts = shell_reason.split(',')
-                    friendly = []
-                    for part in reason_parts:
-                        part = part.strip()
-                        if part == 'NEAR_SHELL_OPEN':
-                            friendly.append('Near shell open')
-                        elif part == 'FAR_SHELL_OPEN':
-                            friendly.append('Far shell open')
-                        elif 'SHORT' in part:
-                            friendly.append(part.replace('_', '/').replace('/SHORT', ' short'))
-                        else:
-                            friendly.append(part)
-                    shell_status = f"[red]FAIL ({', '.join(friendly)})[/red]"
-                    failure_reasons.append(f"SHELL: {', '.join(friendly)}")
-                    all_passed = False
-            except Exception as e:
+            shell_result = full_result.shell
+            if shell_result is None:
                 shell_status = "[yellow]ERROR[/yellow]"
                 failure_reasons.append("SHELL: Error")
                 all_passed = False
+            elif shell_result.passed:
+                shell_status = "[green]PASS[/green]"
+            else:
+                shell_reason = shell_result.reason or 'Unknown'
+                reason_parts = shell_reason.split(',')
+                friendly = []
+                for part in reason_parts:
+                    part = part.strip()
+                    if part == 'NEAR_SHELL_OPEN':
+                        friendly.append('Near shell open')
+                    elif part == 'FAR_SHELL_OPEN':
+                        friendly.append('Far shell open')
+                    elif 'SHORT' in part:
+                        friendly.append(part.replace('_', '/').replace('/SHORT', ' short'))
+                    else:
+                        friendly.append(part)
+                shell_status = f"[red]FAIL ({', '.join(friendly)})[/red]"
+                failure_reasons.append(f"SHELL: {', '.join(friendly)}")
+                all_passed = False
         elif should_test_shell:
-            shell_status = "[dim]SKIP[/dim]"
+            shell_status = "[yellow]ERROR[/yellow]" if full_result is None else "[dim]SKIP[/dim]"
 
-        # Only run resistance test if continuity passed
-        if all_passed:
-            if should_test_shell:
-                progress = f"🔬 Testing... CON: {cont_status} | SHELL: {shell_status} | Running resistance test"
+        # Resistance only counts if continuity (and shell) passed
+        if all_passed and full_result.resistance is None:
+            # FAST mode skipped XRES after an earlier failure
+            res_status = "[dim]SKIP[/dim]"
+        elif all_passed:
+            res_result = full_result.resistance
+            resistance_adc = res_result.pin2_adc
+            calibration_adc = res_result.pin2_cal_adc
+            resistance_adc_p3 = res_result.pin3_adc
+            calibration_adc_p3 = res_result.pin3_cal_adc
+            if res_result.passed:
+                res_status = "[green]PASS[/green]"
             else:
-                progress = f"🔬 Testing... CON: {cont_status} | Running resistance test"
-            self.ui.layout["footer"].update(Panel(progress, title="Testing"))
-            self.ui.render()
-
-            try:
-                res_result = cable_tester.run_xlr_resistance_test()
-                resistance_adc = res_result.pin2_adc
-                calibration_adc = res_result.pin2_cal_adc
-                resistance_adc_p3 = res_result.pin3_adc
-                calibration_adc_p3 = res_result.pin3_cal_adc
-                if res_result.passed:
-                    res_status = "[green]PASS[/green]"
-                else:
-                    res_status = "[red]FAIL[/red]"
-                    failure_reasons.append("RES: Fail")
-                    all_passed = False
-            except Exception as e:
-                res_status = "[yellow]ERROR[/yellow]"
-                failure_reasons.append("RES: Error")
+                res_status = "[red]FAIL[/red]"
+                failure_reasons.append("RES: Fail")
                 all_passed = False
+        elif full_result is None:
+            res_status = "[yellow]ERROR[/yellow]"
         else:
             res_status = "[dim]SKIP[/dim]"
 
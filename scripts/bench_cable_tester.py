@@ -0,0 +1,272 @@
+#!/usr/bin/env python3
+"""
+Cable tester benchmark - sustained throughput against a golden cable.
+
+Drives a tester through the same ArduinoCableTester / BridgeCableTester
+classes the station uses, for thousands of test cycles, and reports:
+  - round-trip latency per command (min, p50, p90, p99, max)
+  - tests per minute
+  - fail, error and timeout rates (a golden cable should never fail)
+  - MCU free memory (MEM) over the run
+  - the firmware's own PROFILE of the same tests, when it has one
+
+Results can be saved as JSON and compared with a saved baseline: the
+script exits 1 if a command's p50/p99 latency got worse by more than
+--tolerance, throughput dropped by more, or a new error/timeout/fail
+appeared. Run it against the old sketch, then the new one, before
+flashing the floor.
+
+A calibrated golden cable that passes every test must be in the fixture:
+it has to plug into both ends for the XLR tests and TS tests you ask for.
+
+Usage:
+    python scripts/bench_cable_tester.py                           # platform from config, 1000 cycles
+    python scripts/bench_cable_tester.py --backend serial --port /dev/ttyACM0 --baud 1000000
+    python scripts/bench_cable_tester.py --backend bridge --binary
+    python scripts/bench_cable_tester.py --commands CONT,RES --cycles 5000 --json new.json
+    python scripts/bench_cable_tester.py --json new.json --compare old.json
+    python scripts/bench_cable_tester.py --backend mock --cycles 50   # dry run of the script itself
+"""
+
+import argparse
+import json
+import logging
+import os
+import socket
+import sys
+import time
+
+# Add project root to path
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+from greenlight.config import ARDUINO_BAUDRATE, ARDUINO_PORT, PLATFORM, ROUTER_SOCKET_PATH
+
+DEFAULT_COMMANDS = "CONT,RES,XCONT,XRES"
+PERCENTILES = (50, 90, 99)
+LATENCY_SLACK_MS = 1.0  # Host scheduling noise; smaller latency changes never count
+
+# Command -> tester method
+TESTS = {
+    "CONT": lambda t: t.run_continuity_test(),
+    "RES": lambda t: t.run_resistance_test(),
+    "XCONT": lambda t: t.run_xlr_continuity_test(),
+    "XSHELL": lambda t: t.run_xlr_shell_test(),
+    "XRES": lambda t: t.run_xlr_resistance_test(),
+    "FULL": lambda t: t.run_full_test(),
+    "XFULL": lambda t: t.run_xlr_full_test(),
+    "XFULL SHELL": lambda t: t.run_xlr_full_test(shell=True),
+}
+
+
+def open_tester(args):
+    backend = args.backend or PLATFORM
+    if backend == "unoq" or backend == "bridge":
+        from greenlight.hardware.cable_tester import BridgeCableTester
+        tester = BridgeCableTester(socket_path=args.socket, binary=args.binary)
+    elif backend == "serial":
+        from greenlight.hardware.cable_tester import ArduinoCableTester
+        tester = ArduinoCableTester(port=args.port, baudrate=args.baud, binary=args.binary)
+    else:
+        from greenlight.hardware.cable_tester import MockCableTester
+        tester = MockCableTester()
+    if not tester.initialize():
+        sys.exit(f"Cable tester ({backend}) not responding")
+    return tester
+
+
+def percentile(sorted_values, pct):
+    """Nearest-rank percentile of an already sorted list"""
+    if not sorted_values:
+        return None
+    rank = max(1, -(-len(sorted_values) * pct // 100))
+    return sorted_values[rank - 1]
+
+
+def classify(error):
+    """'timeout' when the tester never answered, otherwise 'error'"""
+    text = str(error)
+    if isinstance(error, (socket.timeout, TimeoutError)) or text.startswith("No response"):
+        return "timeout"
+    return "error"
+
+
+def sample_memory(tester, elapsed, samples):
+    try:
+        mem = tester.get_memory()
+    except Exception as e:
+        logging.warning(f"MEM failed: {e}")
+        return
+    samples.append({"t": round(elapsed, 1), **mem})
+
+
+def run(tester, commands, cycles, mem_every):
+    stats = {c: {"latency_ms": [], "pass": 0, "fail": 0, "error": 0, "timeout": 0, "errors": []}
+             for c in commands}
+    memory = []
+    start = time.perf_counter()
+    sample_memory(tester, 0.0, memory)
+
+    for cycle in range(1, cycles + 1):
+        for command in commands:
+            s = stats[command]
+            t0 = time.perf_counter()
+            try:
+                result = TESTS[command](tester)
+            except Exception as e:
+                kind = classify(e)
+                s[kind] += 1
+                if len(s["errors"]) < 10:
+                    s["errors"].append(f"cycle {cycle}: {e}")
+                continue
+            s["latency_ms"].append((time.perf_counter() - t0) * 1000.0)
+            s["pass" if result.passed else "fail"] += 1
+
+        if mem_every and cycle % mem_every == 0:
+            sample_memory(tester, time.perf_counter() - start, memory)
+        if cycle % max(1, cycles // 20) == 0:
+            done = sum(s["pass"] + s["fail"] for s in stats.values())
+            print(f"  {cycle}/{cycles} cycles, {done / (time.perf_counter() - start) * 60:.0f} tests/min",
+                  flush=True)
+
+    elapsed = time.perf_counter() - start
+    sample_memory(tester, elapsed, memory)
+    return stats, memory, elapsed
+
+
+def summarize(stats, memory, elapsed):
+    summary = {"elapsed_s": round(elapsed, 2), "commands": {}, "memory": memory}
+    total_ok = 0
+    for command, s in stats.items():
+        latencies = sorted(s["latency_ms"])
+        attempts = s["pass"] + s["fail"] + s["error"] + s["timeout"]
+        total_ok += s["pass"] + s["fail"]
+        row = {key: s[key] for key in ("pass", "fail", "error", "timeout")}
+        row["attempts"] = attempts
+        row["errors"] = s["errors"]
+        if latencies:
+            row["min_ms"] = round(latencies[0], 2)
+            row["max_ms"] = round(latencies[-1], 2)
+            row["mean_ms"] = round(sum(latencies) / len(latencies), 2)
+            for pct in PERCENTILES:
+                row[f"p{pct}_ms"] = round(percentile(latencies, pct), 2)
+        summary["commands"][command] = row
+    summary["tests_per_min"] = round(total_ok / elapsed * 60, 1) if elapsed > 0 else 0.0
+    if memory:
+        summary["mem_free_min"] = min((m["min"] for m in memory if "min" in m), default=None)
+        summary["mem_free_first"] = memory[0].get("free")
+        summary["mem_free_last"] = memory[-1].get("free")
+    return summary
+
+
+def print_summary(summary):
+    print()
+    print(f"{'command':<12}{'n':>7}{'min':>9}{'p50':>9}{'p90':>9}{'p99':>9}{'max':>9}"
+          f"{'fail':>7}{'err':>6}{'tmo':>6}   (ms)")
+    for command, row in summary["commands"].items():
+        def ms(key):
+            return f"{row[key]:>9.1f}" if key in row else f"{'-':>9}"
+        print(f"{command:<12}{row['attempts']:>7}{ms('min_ms')}{ms('p50_ms')}{ms('p90_ms')}"
+              f"{ms('p99_ms')}{ms('max_ms')}{row['fail']:>7}{row['error']:>6}{row['timeout']:>6}")
+        for line in row["errors"]:
+            print(f"    {line}")
+    print(f"\n{summary['tests_per_min']:.0f} tests/min over {summary['elapsed_s']:.0f} s")
+    if "mem_free_min" in summary:
+        print(f"MCU free memory: {summary['mem_free_first']} at start, {summary['mem_free_last']} at end, "
+              f"{summary['mem_free_min']} lowest")
+    for line in summary.get("profile", []):
+        print(line)
+
+
+def compare(summary, baseline, tolerance):
+    """Regressions against a saved run, as readable lines"""
+    problems = []
+    for command, row in summary["commands"].items():
+        old = baseline.get("commands", {}).get(command)
+        if not old:
+            continue
+        for key in ("p50_ms", "p99_ms"):
+            if key in row and key in old and row[key] > old[key] * (1 + tolerance) + LATENCY_SLACK_MS:
+                problems.append(f"{command} {key[:-3]}: {old[key]:.1f} -> {row[key]:.1f} ms")
+        for key in ("fail", "error", "timeout"):
+            old_rate = old[key] / old["attempts"] if old.get("attempts") else 0
+            new_rate = row[key] / row["attempts"] if row["attempts"] else 0
+            if new_rate > old_rate:
+                problems.append(f"{command} {key} rate: {old_rate:.2%} -> {new_rate:.2%}")
+    old_rate = baseline.get("tests_per_min", 0)
+    if old_rate and summary["tests_per_min"] < old_rate * (1 - tolerance):
+        problems.append(f"throughput: {old_rate:.0f} -> {summary['tests_per_min']:.0f} tests/min")
+    old_mem, new_mem = baseline.get("mem_free_min"), summary.get("mem_free_min")
+    if old_mem and new_mem is not None and new_mem < old_mem * (1 - tolerance):
+        problems.append(f"lowest free memory: {old_mem} -> {new_mem} bytes")
+    return problems
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Cable tester throughput benchmark")
+    parser.add_argument("--backend", choices=["serial", "bridge", "mock"],
+                        help=f"Tester connection (default from config: {PLATFORM})")
+    parser.add_argument("--port", default=ARDUINO_PORT, help="Serial port (default: auto-detect)")
+    parser.add_argument("--baud", type=int, default=ARDUINO_BAUDRATE, help="Serial rate to negotiate")
+    parser.add_argument("--socket", default=ROUTER_SOCKET_PATH, help="Router Bridge socket")
+    parser.add_argument("--binary", action="store_true", help="Binary result records")
+    parser.add_argument("--commands", default=DEFAULT_COMMANDS,
+                        help=f"Comma-separated tests per cycle (default: {DEFAULT_COMMANDS})")
+    parser.add_argument("--cycles", type=int, default=1000, help="Cycles of the command list")
+    parser.add_argument("--mem-every", type=int, default=50, help="MEM sample interval in cycles (0 = off)")
+    parser.add_argument("--json", help="Write the results here")
+    parser.add_argument("--compare", help="Baseline JSON from an earlier run")
+    parser.add_argument("--tolerance", type=float, default=0.10,
+                        help="Allowed latency/throughput change against --compare (default: 0.10)")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args()
+
+    logging.basicConfig(level=logging.DEBUG if args.verbose else logging.WARNING)
+
+    commands = [c.strip().upper() for c in args.commands.split(",") if c.strip()]
+    unknown = [c for c in commands if c not in TESTS]
+    if unknown:
+        parser.error(f"Unknown commands: {', '.join(unknown)} (choose from {', '.join(TESTS)})")
+
+    tester = open_tester(args)
+    tester_id = tester.get_status().get("tester_id")
+    try:
+        print(f"Benchmarking {tester_id}: {', '.join(commands)} x {args.cycles}")
+        profiled = False
+        try:
+            profiled = tester.reset_profile()
+        except Exception as e:
+            logging.info(f"No PROFILE on this firmware: {e}")
+
+        stats, memory, elapsed = run(tester, commands, args.cycles, args.mem_every)
+        summary = summarize(stats, memory, elapsed)
+        summary.update({"tester_id": tester_id, "cycles": args.cycles,
+                        "binary": getattr(tester, "binary", False), "started": time.time() - elapsed})
+        if profiled:
+            try:
+                summary["profile"] = [tester.get_profile(c) for c in commands]
+            except Exception as e:
+                logging.warning(f"PROFILE failed: {e}")
+    finally:
+        tester.close()
+
+    print_summary(summary)
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(summary, f, indent=2)
+        print(f"\nResults written to {args.json}")
+
+    if args.compare:
+        with open(args.compare) as f:
+            baseline = json.load(f)
+        problems = compare(summary, baseline, args.tolerance)
+        if problems:
+            print(f"\nREGRESSIONS against {args.compare}:")
+            for line in problems:
+                print(f"  {line}")
+            sys.exit(1)
+        print(f"\nNo regressions against {args.compare}")
+
+
+if __name__ == "__main__":
+    main()
@@ -5,6 +5,8 @@
  * Subscribes to:
  *   scanner/barcode  - scan events
  *   scanner/status   - Greenlight state (idle/scanning/offline)
+ *   tester/event     - UNO Q cable tester events (INSERTED, AUTO results,
+ *                      DRIFT:<path>:<mohm>, ...), pushed by the tester app
  *
  * Env var: MQTT_HOSTS=greenlightpi1:18831,greenlightpi2:18832
  */
@@ -12,7 +14,7 @@
 import mqtt from "mqtt";
 
 // Per-host state
-const hosts = new Map(); // name -> { client, status, lastScan }
+const hosts = new Map(); // name -> { client, status, testerEvent }
 
 // Global last scan event (consumed by api.scanner-events and api.order-fulfillment)
 let lastScanEvent = null;
@@ -42,6 +44,7 @@ function connectToHost({ name, port }) {
     name,
     port,
     status: { state: "connecting" },
+    testerEvent: null,
     connected: false,
   };
 
@@ -50,7 +53,9 @@ function connectToHost({ name, port }) {
   client.on("connect", () => {
     console.log(`[mqtt] Connected to ${name}`);
     state.connected = true;
-    client.subscribe(["scanner/barcode", "scanner/status"], { qos: 1 });
+    client.subscribe(["scanner/barcode", "scanner/status", "tester/event"], {
+      qos: 1,
+    });
   });
 
   client.on("close", () => {
@@ -71,6 +76,15 @@ function connectToHost({ name, port }) {
         console.log(`[mqtt] ${name} status: ${JSON.stringify(data)}`);
       }
 
+      if (topic === "tester/event" && data.event) {
+        state.testerEvent = {
+          event: data.event,
+          timestamp: Date.now(),
+          host: data.host || name,
+        };
+        console.log(`[mqtt] ${name} tester: ${data.event}`);
+      }
+
       if (topic === "scanner/barcode") {
         const serial = data.barcode;
         if (serial) {
@@ -124,7 +138,7 @@ export function getLastScanEvent() {
 
 /**
  * Get scanner status for all hosts.
- * Returns array of { name, connected, status }.
+ * Returns array of { name, connected, status, testerEvent }.
  */
 export function getScannerStatus() {
   const result = [];
@@ -133,11 +147,26 @@ export function getScannerStatus() {
       name,
       connected: state.connected,
       status: state.status,
+      testerEvent: state.testerEvent,
     });
   }
   return result;
 }
 
+/**
+ * Get the most recent cable tester event from any host, or null.
+ */
+export function getLastTesterEvent() {
+  let latest = null;
+  for (const state of hosts.values()) {
+    const event = state.testerEvent;
+    if (event && (!latest || event.timestamp > latest.timestamp)) {
+      latest = event;
+    }
+  }
+  return latest;
+}
+
 /**
  * Get hosts where Greenlight is actively scanning.
  * Returns array of host names.
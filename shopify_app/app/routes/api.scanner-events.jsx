@@ -1,7 +1,13 @@
 // Scanner events endpoint - now backed by MQTT subscriptions instead of webhooks
 // - GET: React polls this to get latest scan and scanner status
+//   (?status also carries the latest cable tester event from any host)
 
-import { getLastScanEvent, getScannerStatus, getActiveGreenlightHosts } from "../mqtt.server.js";
+import {
+  getLastScanEvent,
+  getScannerStatus,
+  getActiveGreenlightHosts,
+  getLastTesterEvent,
+} from "../mqtt.server.js";
 
 // Re-export for use by other routes (e.g., order-fulfillment)
 export { getLastScanEvent };
@@ -17,6 +23,7 @@ export async function loader({ request }) {
       JSON.stringify({
         hosts: getScannerStatus(),
         greenlightActive: getActiveGreenlightHosts(),
+        testerEvent: getLastTesterEvent(),
       }),
       {
         headers: {
@@ -0,0 +1,360 @@
+#!/usr/bin/env python3
+"""Host parsers against the cable tester firmware's own output.
+
+The simulator goldens (arduino/sim/golden/<board>/<scenario>.out) are what
+the CableTester library answers on both boards. These tests feed them to
+greenlight/hardware/cable_tester.py:
+
+    every test response and BIN record parses, as the test that sent it
+    binary.sim: each batch's binary records decode to the same results
+                as its text run (catches bit, slot and reason drift)
+    a few known lines decode to the expected dataclasses
+
+The goldens drop the settle times; test_settle_slots runs binary.sim on the
+built simulator (make -C arduino/sim) to check them, and is skipped without it.
+
+Run: pytest tests/test_cable_tester_parsers.py  (or: python tests/test_cable_tester_parsers.py)
+"""
+
+import dataclasses
+import subprocess
+import sys
+import unittest
+from pathlib import Path
+
+REPO = Path(__file__).resolve().parent.parent
+sys.path.insert(0, str(REPO))
+
+from greenlight.hardware.cable_tester import (
+    BATCH_TESTS, BIN_HEADER, BIN_KINDS, BothTestResult, CalibrationResult,
+    ContinuityResult, FlexStatus, FullTestResult, WearStats, XlrFullTestResult, parse_auto_event, parse_batch_results, parse_binary_result,
+    parse_calibration_response, parse_flex_response, parse_stats_response,
+    parse_xlr_calibration_response, split_tag,
+)
+# Not a test: aliased so pytest doesn't collect it
+from greenlight.hardware.cable_tester import test_command as command_key
+
+
+SIM_DIR = REPO / "arduino" / "sim"
+GOLDEN_DIR = SIM_DIR / "golden"
+BOARDS = ["mega", "unoq"]
+
+# Single commands with a text parser outside BATCH_TESTS
+CAL_PARSERS = {
+    "CAL": ("CAL:", parse_calibration_response),
+    "XCAL": ("XCAL:", parse_xlr_calibration_response),
+}
+
+
+def head_prefix(line):
+    """'H2:XCONT' -> 'H2:', '' for head 1"""
+    return line[:3] if line[:1] == "H" and line[1:2].isdigit() and line[2:3] == ":" else ""
+
+
+def strip_head(line):
+    """'H2:XCONT' -> 'XCONT'"""
+    return line[len(head_prefix(line)):]
+
+
+def load_exchanges(text):
+    """Golden output as [(command, [reply lines])], untagged replies first"""
+    exchanges = []
+    for line in text.splitlines():
+        if line.startswith("> "):
+            exchanges.append((line[2:], []))
+        elif exchanges:
+            exchanges[-1][1].append(line)
+    return exchanges
+
+
+def golden_files():
+    for board in BOARDS:
+        for path in sorted((GOLDEN_DIR / board).glob("*.out")):
+            yield board, path
+
+
+def pad_settle(record):
+    """--golden keeps a record's settle count but drops the times: missing
+    ones read as 0"""
+    count = record[BIN_HEADER.size - 1]
+    return record.ljust(BIN_HEADER.size + 2 * count, b"\0")
+
+
+def decode_bin(hex_record):
+    """A BIN:<hex> record's result"""
+    return parse_binary_result(pad_settle(bytes.fromhex(hex_record)))
+
+
+def without_settle(result):
+    """The result with every settle_us cleared, nested results included"""
+    if not dataclasses.is_dataclass(result):
+        return result
+    changes = {}
+    for f in dataclasses.fields(result):
+        value = getattr(result, f.name)
+        if f.name == "settle_us":
+            changes[f.name] = None
+        elif dataclasses.is_dataclass(value):
+            changes[f.name] = without_settle(value)
+    return dataclasses.replace(result, **changes)
+
+
+def text_parser(command):
+    """(prefix, parser) for a test command's text reply, None if not a test"""
+    name = command_key(command)
+    return BATCH_TESTS.get(name) or CAL_PARSERS.get(name)
+
+
+def batch_commands(command):
+    """'#3 CONT;XCONT' -> (3, ['CONT', 'XCONT']), None for other commands"""
+    head, _, body = command.partition(" ")
+    if not head.startswith("#") or not head[1:].isdigit():
+        return None
+    return int(head[1:]), [c for c in body.split(";") if c]
+
+
+def batch_payloads(tag, replies):
+    """A batch's tagged payloads in order, BIN records as bytes"""
+    payloads = []
+    for line in replies:
+        tagged = split_tag(line)
+        if tagged is None or tagged[0] != tag or tagged[1] in ("END", "BIN"):
+            continue
+        payload = tagged[1]
+        payloads.append(bytes.fromhex(payload[4:]) if payload.startswith("BIN:") else payload)
+    return payloads
+
+
+def run_command_results(command, replies):
+    """Results of one golden exchange: a batch's, or a single test's"""
+    batch = batch_commands(command)
+    if batch is not None:
+        tag, commands = batch
+        payloads = [pad_settle(p) if isinstance(p, bytes) else p
+                    for p in batch_payloads(tag, replies)]
+        # Refused or cut-short batches are the firmware's error paths
+        if any(command_key(c) not in BATCH_TESTS for c in commands) or \
+                any(l.startswith("ERROR:") for l in replies) or \
+                any(isinstance(p, str) and p.startswith("ERROR:") for p in payloads):
+            return None
+        return parse_batch_results(commands, payloads)
+    name = strip_head(command)
+    parser = text_parser(name)
+    if parser is None:
+        return None
+    prefix, parse = parser
+    results = []
+    for line in replies:
+        # Other heads' replies interleave with this one's
+        if head_prefix(line) != head_prefix(command):
+            continue
+        line = strip_head(line)
+        if line.startswith("BIN:"):
+            results.append(decode_bin(line[4:]))
+        elif line.startswith(prefix):
+            results.append(parse(line))
+    return results
+
+
+# ===== Every golden reply parses =====
+
+def test_golden_replies_parse():
+    """Each test reply and BIN record in the goldens parses as the command
+    that sent it"""
+    checked = 0
+    for board, path in golden_files():
+        for command, replies in load_exchanges(path.read_text()):
+            results = run_command_results(command, replies)
+            if not results:
+                continue
+            batch = batch_commands(command)
+            names = batch[1] if batch else [strip_head(command)]
+            assert len(results) == len(names), f"{board}/{path.name}: {command}"
+            for name, result in zip(names, results):
+                passed = getattr(result, "passed", getattr(result, "success", None))
+                assert isinstance(passed, bool), f"{board}/{path.name}: {command}: {result}"
+                checked += 1
+    assert checked > 100
+
+
+def test_golden_bin_kinds():
+    """A BIN record's kind is the TestKind of the command that sent it"""
+    checked = 0
+    for board, path in golden_files():
+        for command, replies in load_exchanges(path.read_text()):
+            batch = batch_commands(command)
+            if batch is not None:
+                records = [p for p in batch_payloads(batch[0], replies) if isinstance(p, bytes)]
+                names = batch[1]
+            else:
+                records = [bytes.fromhex(strip_head(l)[4:]) for l in replies
+                           if head_prefix(l) == head_prefix(command)
+                           and strip_head(l).startswith("BIN:")]
+                names = [strip_head(command)] * len(records)
+            for name, record in zip(names, records):
+                assert BIN_KINDS[record[1]] == command_key(name), \
+                    f"{board}/{path.name}: {command}: kind {record[1]}"
+                checked += 1
+    assert checked > 50
+
+
+def test_golden_auto_events():
+    """EVENT: results parse as the armed AUTO test"""
+    checked = 0
+    for board, path in golden_files():
+        armed = {}
+        for command, replies in load_exchanges(path.read_text()):
+            for line in replies:
+                head, body = head_prefix(line), strip_head(line)
+                if body.startswith("AUTO:") and body != "AUTO:NONE":
+                    armed[head] = None if body == "AUTO:OFF" else body[len("AUTO:"):]
+                elif body.startswith("EVENT:") and armed.get(head):
+                    result = parse_auto_event(armed[head], body[len("EVENT:"):])
+                    if result is not None:
+                        checked += 1
+    assert checked > 0
+
+
+# ===== Binary records against text =====
+
+def paired_runs(text):
+    """binary.sim's (command, test, text result, binary result): each batch
+    or CAL/XCAL runs as text, then again after FORMAT BIN"""
+    pending = {}
+    binary = False
+    for command, replies in load_exchanges(text):
+        if command in ("FORMAT BIN", "FORMAT TEXT"):
+            binary = command == "FORMAT BIN"
+            continue
+        results = run_command_results(command, replies)
+        if results is None:
+            continue
+        if not binary:
+            pending[command] = results
+            continue
+        from_text = pending.pop(command)
+        assert len(from_text) == len(results), f"{command}: {from_text} / {results}"
+        batch = batch_commands(command)
+        for name, t, b in zip(batch[1] if batch else [command], from_text, results):
+            yield command, name, t, b
+
+
+def test_binary_matches_text():
+    for board in BOARDS:
+        text = (GOLDEN_DIR / board / "binary.out").read_text()
+        kinds = set()
+        for command, name, t, b in paired_runs(text):
+            assert without_settle(b) == without_settle(t), \
+                f"{board}: {name} in {command}\n  text:   {t}\n  binary: {b}"
+            kinds.add(command_key(name))
+        assert kinds == set(BIN_KINDS), f"{board}: binary.sim misses {set(BIN_KINDS) - kinds}"
+
+
+def test_settle_slots():
+    """Binary settle slots land in the same sections as the text :SETTLE:
+    (needs the live simulator: the goldens drop settle times; with noise 0
+    both runs settle alike)"""
+    for board in BOARDS:
+        sim = SIM_DIR / "build" / f"cable_sim_{board}"
+        if not sim.exists():
+            raise unittest.SkipTest(f"{sim} not built (make -C arduino/sim)")
+        text = subprocess.run([str(sim), str(SIM_DIR / "scenarios" / "binary.sim")],
+                              capture_output=True, text=True, check=True).stdout
+        for command, name, t, b in paired_runs(text):
+            assert settle_times(b) == settle_times(t), \
+                f"{board}: {name} in {command}\n  text:   {t}\n  binary: {b}"
+
+
+def settle_times(result):
+    """settle_us of a result and of each of its sections"""
+    if not dataclasses.is_dataclass(result):
+        return None
+    times = {}
+    for f in dataclasses.fields(result):
+        value = getattr(result, f.name)
+        if f.name == "settle_us":
+            times[f.name] = value
+        elif dataclasses.is_dataclass(value):
+            times[f.name] = settle_times(value)
+    return times
+
+
+# ===== Known lines =====
+
+def golden_reply(board, scenario, command, prefix, contains=""):
+    """The first reply to command in a golden that starts with prefix and
+    contains the given text"""
+    text = (GOLDEN_DIR / board / f"{scenario}.out").read_text()
+    return next(line for c, replies in load_exchanges(text) if c == command
+                for line in replies if line.startswith(prefix) and contains in line)
+
+
+def test_known_results():
+    for board in BOARDS:
+        reversed_ts = golden_reply(board, "ts_faults", "CONT", "RESULT:", "REVERSED")
+        cont = BATCH_TESTS["CONT"][1](reversed_ts)
+        assert cont == ContinuityResult(
+            passed=False, tip_to_tip=False, tip_to_sleeve=True, sleeve_to_sleeve=False,
+            sleeve_to_tip=True, reason="REVERSED")
+
+        both = decode_bin(golden_reply(board, "both", "BOTH", "BIN:")[4:])
+        assert isinstance(both, BothTestResult) and both.passed
+        assert both.continuity.passed and both.xlr_continuity.passed
+        assert len(both.continuity.settle_us) == 2 and len(both.xlr_continuity.settle_us) == 3
+
+        shell = decode_bin(golden_reply(board, "good_cables", "XFULL SHELL", "BIN:")[4:])
+        assert isinstance(shell, XlrFullTestResult) and shell.passed
+        assert shell.shell is not None and shell.shell.passed
+        assert shell.resistance is not None and shell.resistance.calibrated
+
+        skipped = decode_bin(golden_reply(board, "fast_mode", "XFULL FAST", "BIN:")[4:])
+        assert isinstance(skipped, XlrFullTestResult) and not skipped.passed
+        assert skipped.resistance is None
+        assert skipped.continuity.reason == "P3_OPEN"
+
+        stats = parse_stats_response(golden_reply(board, "stats", "STATS RESET", "STATS:"))
+        assert stats == WearStats(saved=False, resets=1,
+                                  relays={"K12": 0, "K3": 0, "K4": 0, "K5": 0, "K6": 0},
+                                  inserts=0, tests={})
+
+        flex = parse_flex_response(golden_reply(board, "flex_mode", "FLEX OFF", "FLEX:"))
+        assert isinstance(flex, FlexStatus) and flex.mode == "OFF"
+
+
+def test_full_fast_skips_continuity():
+    """FULL FAST with a failing RES answers RESULT:SKIP: continuity is None"""
+    text = (GOLDEN_DIR / "unoq" / "binary.out").read_text()
+    skipped = [t for _, name, t, _ in paired_runs(text)
+               if name == "FULL FAST" and not t.resistance.passed]
+    assert skipped and all(isinstance(r, FullTestResult) and r.continuity is None
+                           for r in skipped)
+
+
+def test_cal_failure():
+    text = (GOLDEN_DIR / "unoq" / "binary.out").read_text()
+    cals = [t for _, name, t, _ in paired_runs(text) if name == "CAL"]
+    assert cals[0] == CalibrationResult(success=True, adc_value=cals[0].adc_value)
+    assert not cals[-1].success and cals[-1].error.endswith("NO_CABLE")
+
+
+TESTS = [test_golden_replies_parse, test_golden_bin_kinds, test_golden_auto_events,
+         test_binary_matches_text, test_settle_slots, test_known_results,
+         test_full_fast_skips_continuity, test_cal_failure]
+
+
+def main():
+    failed = 0
+    for test in TESTS:
+        try:
+            test()
+            print(f"✅ {test.__name__}")
+        except unittest.SkipTest as e:
+            print(f"⏭  {test.__name__}: skipped ({e})")
+        except AssertionError as e:
+            failed += 1
+            print(f"❌ {test.__name__}: {e}")
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())